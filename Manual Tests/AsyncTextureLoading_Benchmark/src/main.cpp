@@ -0,0 +1,139 @@
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <SFEX/SFEX.hpp>
+#include <SFML/Graphics.hpp>
+
+// Compares the frame times of loading many textures while rendering, once with loadFromFile
+// inside a single frame and once with loadAsync and a bounded number of uploads per frame.
+//   async_texture_loading_benchmark [uploads per frame] [dir]
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t TEXTURE_COUNT = 200;
+constexpr unsigned int TEXTURE_SIZE = 512;
+
+std::string getAssetName(std::size_t index)
+{
+	return "texture_" + std::to_string(index) + ".png";
+}
+
+void prepare(const fs::path &directory)
+{
+	fs::create_directories(directory);
+	sf::Image image;
+	image.create(TEXTURE_SIZE, TEXTURE_SIZE);
+	for(std::size_t i = 0; i < TEXTURE_COUNT; ++i)
+	{
+		for(unsigned int y = 0; y < TEXTURE_SIZE; ++y)
+		{
+			for(unsigned int x = 0; x < TEXTURE_SIZE; ++x)
+			{
+				image.setPixel(x, y, sf::Color(x ^ y, (x * i) % 256, (y + i) % 256));
+			}
+		}
+		image.saveToFile((directory / getAssetName(i)).string());
+	}
+}
+
+struct FrameStatistics
+{
+	std::size_t frames = 0;
+	sf::Time total;
+	sf::Time longest;
+
+	void add(sf::Time frameTime)
+	{
+		++frames;
+		total += frameTime;
+		if(frameTime > longest) longest = frameTime;
+	}
+};
+
+void report(const std::string &name, const FrameStatistics &statistics)
+{
+	std::cout << std::left << std::setw(28) << name
+		<< statistics.total.asMicroseconds() / 1000.0 << " ms in " << statistics.frames << " frames, longest frame "
+		<< statistics.longest.asMicroseconds() / 1000.0 << " ms" << std::endl;
+}
+
+// Draws a spinning square so that stalls are visible as well as measured
+void drawFrame(sf::RenderWindow &window, sf::RectangleShape &square, const sfex::TextureManager &textures, std::size_t loaded)
+{
+	window.clear();
+	square.rotate(2);
+	window.draw(square);
+	auto it = loaded > 0 ? textures.find("texture_" + std::to_string(loaded - 1)) : textures.end();
+	if(it != textures.end())
+	{
+		sf::Sprite sprite(it->second);
+		sprite.setScale(0.25f, 0.25f);
+		window.draw(sprite);
+	}
+	window.display();
+}
+
+FrameStatistics loadFiles(sf::RenderWindow &window, sf::RectangleShape &square, const fs::path &directory)
+{
+	FrameStatistics statistics;
+	sfex::TextureManager textures;
+	sf::Clock clock;
+
+	for(std::size_t i = 0; i < TEXTURE_COUNT; ++i)
+	{
+		textures.loadFromFile("texture_" + std::to_string(i), (directory / getAssetName(i)).string());
+	}
+	drawFrame(window, square, textures, TEXTURE_COUNT);
+	statistics.add(clock.restart());
+	return statistics;
+}
+
+FrameStatistics loadAsync(sf::RenderWindow &window, sf::RectangleShape &square, const fs::path &directory, std::size_t uploadsPerFrame)
+{
+	FrameStatistics statistics;
+	sfex::TextureManager textures;
+	std::vector<sfex::AsyncLoad> loads;
+	sf::Clock clock;
+
+	for(std::size_t i = 0; i < TEXTURE_COUNT; ++i)
+	{
+		loads.push_back(textures.loadAsync("texture_" + std::to_string(i), (directory / getAssetName(i)).string()));
+	}
+
+	std::size_t loaded = 0;
+	while(loaded < TEXTURE_COUNT && window.isOpen())
+	{
+		sf::Event e;
+		while(window.pollEvent(e))
+		{
+			if(e.type == sf::Event::Closed) window.close();
+		}
+
+		textures.processUploads(uploadsPerFrame);
+		while(loaded < TEXTURE_COUNT && loads[loaded].isDone()) ++loaded;
+		drawFrame(window, square, textures, loaded);
+		statistics.add(clock.restart());
+	}
+	return statistics;
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t uploadsPerFrame = argc > 1 ? std::stoul(argv[1]) : 2;
+	fs::path directory = argc > 2 ? fs::path(argv[2]) : fs::temp_directory_path() / "sfex_async_texture_benchmark";
+
+	sf::RenderWindow window(sf::VideoMode(1280, 720), "Async Texture Loading");
+	window.setVerticalSyncEnabled(false);
+	sf::RectangleShape square(sf::Vector2f(200, 200));
+	square.setOrigin(100, 100);
+	square.setPosition(640, 360);
+
+	prepare(directory);
+	report("loadFromFile in one frame", loadFiles(window, square, directory));
+	report("loadAsync + processUploads(" + std::to_string(uploadsPerFrame) + ")", loadAsync(window, square, directory, uploadsPerFrame));
+
+	fs::remove_all(directory);
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <SFEX/SFEX.hpp>
+#include <SFML/System.hpp>
+
+// Looks up keys of a ManagerBase in different ways and prints the allocations and the time per lookup.
+// Keys are longer than the small string buffer of std::string, so building a temporary std::string allocates.
+
+constexpr std::size_t KEY_COUNT = 20000;
+constexpr std::size_t LOOKUP_COUNT = 1000000;
+
+std::atomic<std::size_t> allocationCount = 0;
+
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+	if(void *ptr = std::malloc(size ? size : 1)) return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+template<typename Func>
+void measure(const std::string &name, Func &&lookup)
+{
+	std::size_t allocationsBefore = allocationCount;
+	std::size_t found = 0;
+	sf::Clock clock;
+	for(std::size_t i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		if(lookup(i)) ++found;
+	}
+	sf::Time elapsed = clock.getElapsedTime();
+	double allocations = static_cast<double>(allocationCount - allocationsBefore) / LOOKUP_COUNT;
+
+	std::cout << std::left << std::setw(36) << name
+		<< std::setw(24) << (std::to_string(allocations) + " allocations")
+		<< elapsed.asMicroseconds() * 1000.0 / LOOKUP_COUNT << " ns" << std::endl;
+	if(found != LOOKUP_COUNT) std::cout << "  (only " << found << " lookups succeeded)" << std::endl;
+}
+
+int main()
+{
+	sfex::ManagerBase<int> manager;
+	std::vector<std::string> keys;
+	std::vector<sfex::ManagerBase<int>::Handle> handles;
+	for(std::size_t i = 0; i < KEY_COUNT; ++i)
+	{
+		keys.push_back("textures/enemies/enemy_" + std::to_string(i));
+		manager[keys.back()] = static_cast<int>(i);
+	}
+	for(auto &key : keys)
+	{
+		handles.push_back(manager.acquire(key));
+	}
+
+	const char *literal = "textures/enemies/enemy_42";
+
+	measure("find(std::string(literal))", [&](std::size_t){ return manager.find(std::string(literal)) != manager.end(); });
+	measure("contains(literal)", [&](std::size_t){ return manager.contains(literal); });
+	measure("get(std::string_view)", [&](std::size_t i){ return manager.get(std::string_view(keys[i % KEY_COUNT])) != nullptr; });
+	measure("get(handle)", [&](std::size_t i){ return manager.get(handles[i % KEY_COUNT]) != nullptr; });
+
+	return 0;
+}
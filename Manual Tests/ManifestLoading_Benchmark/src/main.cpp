@@ -0,0 +1,100 @@
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <SFEX/SFEX.hpp>
+#include <SFML/Graphics.hpp>
+
+// Compares loading many textures one by one with loading them through a manifest.
+// Like the pack benchmark, every mode can run as its own process to measure cold starts:
+//   manifest_loading_benchmark prepare <dir>
+//   sync; echo 3 | sudo tee /proc/sys/vm/drop_caches; manifest_loading_benchmark files <dir>
+//   sync; echo 3 | sudo tee /proc/sys/vm/drop_caches; manifest_loading_benchmark manifest <dir>
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t TEXTURE_COUNT = 400;
+constexpr unsigned int TEXTURE_SIZE = 256;
+
+std::string getAssetName(std::size_t index)
+{
+	return "textures/" + std::to_string(index % 10) + "/texture_" + std::to_string(index) + ".png";
+}
+
+void prepare(const fs::path &directory)
+{
+	sfex::MultitypeMap textures;
+	sf::Image image;
+	image.create(TEXTURE_SIZE, TEXTURE_SIZE);
+	for(std::size_t i = 0; i < TEXTURE_COUNT; ++i)
+	{
+		for(unsigned int y = 0; y < TEXTURE_SIZE; ++y)
+		{
+			for(unsigned int x = 0; x < TEXTURE_SIZE; ++x)
+			{
+				image.setPixel(x, y, sf::Color(x ^ y, (x * i) % 256, (y + i) % 256));
+			}
+		}
+
+		fs::path path = directory / getAssetName(i);
+		fs::create_directories(path.parent_path());
+		image.saveToFile(path.string());
+		textures["texture_" + std::to_string(i)] = getAssetName(i);
+	}
+	std::ofstream(directory / "manifest.json") << sfex::Multitype(sfex::MultitypeMap{{"textures", textures}}).serialize(true);
+}
+
+void report(const std::string &name, sf::Time elapsed)
+{
+	std::cout << std::left << std::setw(28) << name << elapsed.asMicroseconds() / 1000.0 << " ms" << std::endl;
+}
+
+void loadFiles(const fs::path &directory)
+{
+	sf::Clock clock;
+	sfex::TextureManager textures;
+	for(std::size_t i = 0; i < TEXTURE_COUNT; ++i)
+	{
+		textures.loadFromFile("texture_" + std::to_string(i), (directory / getAssetName(i)).string());
+	}
+	report("loadFromFile one by one", clock.getElapsedTime());
+}
+
+void loadManifest(const fs::path &directory)
+{
+	sf::Clock clock;
+	sfex::TextureManager textures;
+	sfex::SoundManager sounds;
+	sfex::MusicManager music;
+	sfex::ManifestLoader loader(textures, sounds, music);
+	loader.loadFromFile((directory / "manifest.json").string());
+
+	int lastPercent = -1;
+	while(!loader.isDone())
+	{
+		// Nothing to store yet, a game would render a frame here
+		if(loader.update() == 0) sf::sleep(sf::milliseconds(1));
+		int percent = static_cast<int>(loader.getProgress() * 100);
+		if(percent / 10 != lastPercent / 10) std::cout << percent << "% " << std::flush;
+		lastPercent = percent;
+	}
+	std::cout << std::endl;
+	report("ManifestLoader", clock.getElapsedTime());
+}
+
+int main(int argc, char **argv)
+{
+	std::string mode = argc > 1 ? argv[1] : "all";
+	fs::path directory = argc > 2 ? fs::path(argv[2]) : fs::temp_directory_path() / "sfex_manifest_benchmark";
+
+	// Textures need an OpenGL context
+	sf::Context context;
+
+	if(mode == "prepare" || mode == "all") prepare(directory);
+	if(mode == "files" || mode == "all") loadFiles(directory);
+	if(mode == "manifest" || mode == "all") loadManifest(directory);
+
+	if(mode == "all") fs::remove_all(directory);
+	return 0;
+}
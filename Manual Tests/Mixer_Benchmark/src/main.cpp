@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <SFEX/SFEX.hpp>
+#include <SFML/Audio.hpp>
+#include <SFML/System.hpp>
+
+// Mixes thousands of looping voices with different pitches and prints how much of the real time budget one chunk takes.
+// Then plays a few hundred of them through one MixerStream for a few seconds.
+
+constexpr unsigned int SAMPLE_RATE = 44100;
+constexpr std::size_t CHUNK_FRAMES = 1024;
+constexpr int CHUNKS = 200;
+
+std::vector<sf::Int16> makeTone(float frequency, unsigned int channelCount)
+{
+	std::vector<sf::Int16> samples(SAMPLE_RATE * channelCount);
+	for(std::size_t i = 0; i < samples.size(); ++i)
+	{
+		float time = static_cast<float>(i / channelCount) / SAMPLE_RATE;
+		samples[i] = static_cast<sf::Int16>(std::sin(time * frequency * 6.2831853f) * 3000);
+	}
+	return samples;
+}
+
+int main()
+{
+	std::vector<sf::Int16> mono = makeTone(440.f, 1);
+	std::vector<sf::Int16> stereo = makeTone(660.f, 2);
+	sfex::Mixer::Source monoSource{mono.data(), mono.size(), 1, SAMPLE_RATE};
+	sfex::Mixer::Source stereoSource{stereo.data(), stereo.size(), 2, SAMPLE_RATE};
+
+	std::vector<sf::Int16> output(2 * CHUNK_FRAMES);
+	for(std::size_t voices : {256, 1024, 4096})
+	{
+		sfex::Mixer mixer(SAMPLE_RATE, voices);
+		for(std::size_t i = 0; i < voices; ++i)
+		{
+			sfex::Mixer::VoiceSettings settings;
+			settings.gain = 1.f / voices;
+			settings.pan = static_cast<float>(i % 21) / 10.f - 1.f;
+			// Every other voice plays at unit pitch, so both the converting and the interpolating paths are measured
+			settings.pitch = i % 2 ? 1.f : 0.5f + static_cast<float>(i % 17) / 16.f;
+			settings.loop = true;
+			mixer.play(i % 3 ? monoSource : stereoSource, settings);
+		}
+
+		sf::Clock clock;
+		for(int c = 0; c < CHUNKS; ++c) mixer.render(output.data(), CHUNK_FRAMES);
+		double elapsed = clock.getElapsedTime().asSeconds() / CHUNKS;
+		double budget = static_cast<double>(CHUNK_FRAMES) / SAMPLE_RATE;
+		std::cout << std::setw(5) << voices << " voices: " << std::fixed << std::setprecision(3) << elapsed * 1000.0 << " ms per chunk, " << std::setprecision(1) << elapsed / budget * 100.0 << "% of real time" << std::endl;
+	}
+
+	sfex::Mixer mixer(SAMPLE_RATE, 512);
+	sfex::MixerStream stream(mixer);
+	for(int i = 0; i < 300; ++i)
+	{
+		sfex::Mixer::VoiceSettings settings;
+		settings.gain = 1.f / 30.f;
+		settings.pan = static_cast<float>(i % 21) / 10.f - 1.f;
+		settings.pitch = 0.5f + static_cast<float>(i % 8) / 8.f;
+		settings.loop = true;
+		settings.bus = i % 2 ? sfex::Mixer::Bus::Sfx : sfex::Mixer::Bus::Music;
+		mixer.play(monoSource, settings);
+	}
+	stream.play();
+	sf::sleep(sf::seconds(2));
+	mixer.setBusPaused(sfex::Mixer::Bus::Music, true);
+	sf::sleep(sf::seconds(2));
+	stream.stop();
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SFEX/SFEX.hpp>
+#include <SFML/System.hpp>
+
+// Compares reading many small asset files one by one with reading the same assets from a pack.
+// Every mode can be run as its own process, so the page cache can be dropped in between to measure real cold starts:
+//   pack_benchmark prepare <dir>
+//   sync; echo 3 | sudo tee /proc/sys/vm/drop_caches; pack_benchmark files <dir>
+//   sync; echo 3 | sudo tee /proc/sys/vm/drop_caches; pack_benchmark pack <dir>
+// Without arguments everything runs in one process on a warm cache, which only shows the cost of the system calls.
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t FILE_COUNT = 4000;
+constexpr std::size_t MIN_FILE_SIZE = 256;
+constexpr std::size_t MAX_FILE_SIZE = 16384;
+
+std::string getAssetName(std::size_t index)
+{
+	return "assets/" + std::to_string(index % 40) + "/asset_" + std::to_string(index) + ".bin";
+}
+
+void prepare(const fs::path &directory)
+{
+	sfex::PackWriter writer;
+	sfex::PackWriter compressedWriter;
+	unsigned int seed = 1;
+	for(std::size_t i = 0; i < FILE_COUNT; ++i)
+	{
+		seed = seed * 1103515245u + 12345u;
+		std::vector<char> data(MIN_FILE_SIZE + (seed >> 8) % (MAX_FILE_SIZE - MIN_FILE_SIZE));
+		for(std::size_t j = 0; j < data.size(); ++j)
+		{
+			// Half repeating, half noisy bytes, roughly like uncompressed image rows
+			seed = seed * 1103515245u + 12345u;
+			data[j] = (j / 32) % 2 ? static_cast<char>(j % 7) : static_cast<char>(seed >> 16);
+		}
+
+		fs::path path = directory / getAssetName(i);
+		fs::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+		writer.add(getAssetName(i), data.data(), data.size());
+		compressedWriter.add(getAssetName(i), data.data(), data.size(), true);
+	}
+	writer.saveToFile((directory / "assets.sfexpack").string());
+	compressedWriter.saveToFile((directory / "assets_lz4.sfexpack").string());
+}
+
+void report(const std::string &name, sf::Time elapsed, std::size_t bytes)
+{
+	std::cout << std::left << std::setw(28) << name
+		<< std::setw(16) << (std::to_string(elapsed.asMicroseconds() / 1000.0) + " ms")
+		<< bytes / 1024 << " KiB read" << std::endl;
+}
+
+void readFiles(const fs::path &directory)
+{
+	sf::Clock clock;
+	std::size_t bytes = 0;
+	std::vector<char> data;
+	for(std::size_t i = 0; i < FILE_COUNT; ++i)
+	{
+		std::ifstream file(directory / getAssetName(i), std::ios::binary | std::ios::ate);
+		data.resize(static_cast<std::size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(data.data(), data.size());
+		bytes += data.size();
+	}
+	report("Separate files", clock.getElapsedTime(), bytes);
+}
+
+void readPack(const fs::path &directory, const std::string &filename, const std::string &name)
+{
+	sf::Clock clock;
+	std::size_t bytes = 0;
+	std::vector<char> data;
+	sfex::Pack pack;
+	pack.openFromFile((directory / filename).string());
+
+	sfex::PackStream stream;
+	for(std::size_t i = 0; i < FILE_COUNT; ++i)
+	{
+		pack.openStream(getAssetName(i), stream);
+		data.resize(static_cast<std::size_t>(stream.getSize()));
+		stream.read(data.data(), stream.getSize());
+		bytes += data.size();
+	}
+	report(name, clock.getElapsedTime(), bytes);
+}
+
+int main(int argc, char **argv)
+{
+	std::string mode = argc > 1 ? argv[1] : "all";
+	fs::path directory = argc > 2 ? fs::path(argv[2]) : fs::temp_directory_path() / "sfex_pack_benchmark";
+
+	if(mode == "prepare" || mode == "all") prepare(directory);
+	if(mode == "files" || mode == "all") readFiles(directory);
+	if(mode == "pack" || mode == "all") readPack(directory, "assets.sfexpack", "Pack");
+	if(mode == "lz4" || mode == "all") readPack(directory, "assets_lz4.sfexpack", "Pack with LZ4");
+
+	if(mode == "all") fs::remove_all(directory);
+	return 0;
+}
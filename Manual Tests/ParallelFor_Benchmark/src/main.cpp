@@ -0,0 +1,60 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <thread>
+#include <SFEX/SFEX.hpp>
+#include <SFML/System.hpp>
+
+// Runs the same CPU bound parallel_for with 1, 2, 4, ... workers and prints the speedup over one worker.
+// On a machine with N idle cores the speedup should stay close to the worker count up to N.
+
+constexpr std::size_t ELEMENT_COUNT = 1 << 20;
+constexpr std::size_t GRAIN = 4096;
+constexpr int REPETITIONS = 5;
+
+float work(float value)
+{
+	for(int i = 0; i < 64; ++i)
+	{
+		value = std::sin(value) * 0.5f + std::cos(value) * 0.5f;
+	}
+	return value;
+}
+
+sf::Time measure(std::size_t workerCount, std::vector<float> &data)
+{
+	sfex::Scheduler scheduler(workerCount);
+	scheduler.getWorkerPool();
+
+	sf::Time best = sf::seconds(1e9f);
+	for(int r = 0; r < REPETITIONS; ++r)
+	{
+		sf::Clock clock;
+		scheduler.parallel_for(sfex::Range<std::size_t>{0, data.size()}, GRAIN, [&data](std::size_t i){
+			data[i] = work(data[i]);
+		});
+		sf::Time elapsed = clock.getElapsedTime();
+		if(elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+int main()
+{
+	std::vector<float> data(ELEMENT_COUNT);
+	for(std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<float>(i % 1000) / 1000.0f;
+
+	std::size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << "Hardware threads: " << hardwareThreads << std::endl;
+
+	sf::Time baseline = measure(1, data);
+	for(std::size_t workers = 1; workers <= hardwareThreads; workers *= 2)
+	{
+		sf::Time elapsed = (workers == 1) ? baseline : measure(workers, data);
+		double speedup = baseline.asSeconds() / elapsed.asSeconds();
+		std::cout << std::setw(3) << workers << " workers: " << std::setw(8) << elapsed.asMilliseconds() << " ms, speedup " << std::fixed << std::setprecision(2) << speedup << "x, efficiency " << (speedup / workers) * 100.0 << "%" << std::endl;
+	}
+
+	return 0;
+}
@@ -26,14 +26,27 @@
 #define _SFEX_GENERAL_HPP_
 
 #include <SFEX/Config.hpp>
+#include <SFEX/General/Coroutine.hpp>
+#include <SFEX/General/FileWatcher.hpp>
+#include <SFEX/General/Hash.hpp>
 #include <SFEX/General/Joystick.hpp>
 #include <SFEX/General/Keyboard.hpp>
 #include <SFEX/General/Listener.hpp>
+#include <SFEX/General/Lz4.hpp>
+#include <SFEX/General/MappedFile.hpp>
+#include <SFEX/General/Mixer.hpp>
+#include <SFEX/General/MixerStream.hpp>
 #include <SFEX/General/Mouse.hpp>
 #include <SFEX/General/Multitype.hpp>
+#include <SFEX/General/Pack.hpp>
 #include <SFEX/General/Scene.hpp>
+#include <SFEX/General/Scheduler.hpp>
 #include <SFEX/General/Singleton.hpp>
+#include <SFEX/General/SpatialGrid.hpp>
 #include <SFEX/General/StaticClass.hpp>
 #include <SFEX/General/Stopwatch.hpp>
+#include <SFEX/General/TaskGraph.hpp>
+#include <SFEX/General/VirtualClock.hpp>
+#include <SFEX/General/WorkerPool.hpp>
 
 #endif // !_SFEX_GENERAL_HPP_
\ No newline at end of file
@@ -0,0 +1,103 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_COROUTINE_HPP_
+#define _SFEX_GENERAL_COROUTINE_HPP_
+
+#include <memory>
+#include <atomic>
+#include <exception>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SFEX_HAS_COROUTINES 1
+#else
+#define SFEX_HAS_COROUTINES 0
+#endif
+
+namespace sfex
+{
+
+namespace impl
+{
+
+/// @brief Awaitable that never suspends. Same as std::suspend_never, defined here so that this header also compiles without <coroutine>.
+struct NoSuspend
+{
+    bool await_ready() const noexcept { return true; }
+    template<typename Handle>
+    void await_suspend(Handle) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+} // namespace impl
+
+/// @brief Return type for fire-and-forget coroutines that await sfex::Scheduler::delay() and sfex::Scheduler::nextFrame(). Requires C++20.
+/// 
+/// The coroutine starts running right away and owns itself, so the Coroutine object may be discarded.
+/// If the scheduler is destroyed while the coroutine is suspended, the coroutine is destroyed without finishing.
+class Coroutine
+{
+public:
+    struct State
+    {
+        std::atomic<bool> done = false;
+        std::exception_ptr exception;
+    };
+
+    class promise_type
+    {
+    public:
+        Coroutine get_return_object() { return Coroutine(m_state); }
+        impl::NoSuspend initial_suspend() const noexcept { return {}; }
+        impl::NoSuspend final_suspend() const noexcept { return {}; }
+        void return_void() { m_state->done = true; }
+        void unhandled_exception()
+        {
+            m_state->exception = std::current_exception();
+            m_state->done = true;
+        }
+
+    private:
+        std::shared_ptr<State> m_state = std::make_shared<State>();
+    };
+
+    /// @brief Construct an empty coroutine object
+    Coroutine() = default;
+
+    /// @brief Returns true if the coroutine has returned or thrown
+    bool isDone() const { return m_state && m_state->done; }
+
+    /// @brief Get the exception that ended the coroutine, if any. Only meaningful once isDone() returns true.
+    std::exception_ptr getException() const { return isDone() ? m_state->exception : nullptr; }
+
+private:
+    explicit Coroutine(std::shared_ptr<State> state): m_state(std::move(state)) {}
+
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace sfex
+
+#endif // !_SFEX_GENERAL_COROUTINE_HPP_
@@ -0,0 +1,126 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_FILE_WATCHER_HPP_
+#define _SFEX_GENERAL_FILE_WATCHER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Watches files for changes on a background thread, e.g. to reload assets while they are edited.
+/// On Linux the directories of the files are watched with inotify, so editors that save by replacing a file are noticed too.
+/// Elsewhere, or when inotify is not available, the thread compares modification times a few times per second.
+class FileWatcher
+{
+public:
+    /// @brief Start the watching thread
+    FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// @brief Stop the watching thread
+    ~FileWatcher();
+
+    /// @brief Start watching a file. A file can be watched several times and is watched until every watch has been undone with unwatch.
+    /// @param filename Path of the file
+    /// @return False if the directory of the file cannot be watched
+    bool watch(const std::string &filename);
+
+    /// @brief Undo one watch of a file
+    /// @param filename Path of the file
+    void unwatch(const std::string &filename);
+
+    /// @brief Returns true if the file is watched
+    bool isWatching(const std::string &filename) const;
+
+    /// @brief Get the number of files that are watched
+    std::size_t getWatchCount() const;
+
+    /// @brief Get the files that have changed since the last call, each once
+    /// @return Paths of the changed files as returned by getWatchPath
+    std::vector<std::string> pollChanges();
+
+    /// @brief Get the absolute, normalized path that identifies a file in pollChanges
+    static std::string getWatchPath(const std::string &filename);
+
+private:
+    /// @brief File that is watched
+    struct WatchedFile
+    {
+        std::size_t count = 0;
+        std::string directory;
+        std::int64_t time = 0;
+        std::uintmax_t size = 0;
+    };
+
+    /// @brief Body of the watching thread
+    void run();
+
+    /// @brief Add a use of the inotify watch of a directory, creating the watch for the first one
+    /// @return False if the directory cannot be watched
+    bool watchDirectory(const std::string &directory);
+
+    /// @brief Drop a use of the inotify watch of a directory, removing the watch after the last one
+    void unwatchDirectory(const std::string &directory);
+
+    /// @brief Read the pending inotify events and record the watched files they name
+    void readEvents();
+
+    /// @brief Compare the modification times of the watched files with the ones they had on the last check
+    void checkTimes();
+
+    /// @brief Record that a file has changed
+    void addChange(const std::string &path);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, WatchedFile> m_files;
+    std::vector<std::string> m_changes;
+    std::unordered_set<std::string> m_changed;
+
+    // Directories watched with inotify and the number of files watched in them. Unused when m_fd is -1.
+    std::unordered_map<int, std::string> m_directoryOfWatch;
+    std::unordered_map<std::string, std::pair<int, std::size_t>> m_watchOfDirectory;
+    int m_fd = -1;
+    int m_wakeFd = -1;
+
+    std::atomic<bool> m_running{true};
+    std::condition_variable m_wake;
+    std::thread m_thread;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_FILE_WATCHER_HPP_
\ No newline at end of file
@@ -0,0 +1,44 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_HASH_HPP_
+#define _SFEX_GENERAL_HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sfex
+{
+
+/// @brief Compute the 64 bit xxHash (XXH64) of a block of memory. Fast enough to fingerprint whole asset files at load time.
+/// @param data Pointer to the data
+/// @param size Size of the data in bytes
+/// @param seed Seed of the hash. Passing the hash of other data chains the two hashes.
+/// @return Hash of the data
+std::uint64_t xxHash64(const void *data, std::size_t size, std::uint64_t seed=0);
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_HASH_HPP_
\ No newline at end of file
@@ -0,0 +1,57 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_LZ4_HPP_
+#define _SFEX_GENERAL_LZ4_HPP_
+
+#include <SFEX/General/StaticClass.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Compresses and decompresses data in the LZ4 block format. Decompression is fast enough to be done while loading assets.
+class Lz4 : StaticClass
+{
+public:
+    /// @brief Compress a block of memory
+    /// @param data Pointer to the data
+    /// @param size Size of the data in bytes
+    /// @return Compressed block. It only stores the data, so the original size has to be kept to decompress it.
+    static std::vector<char> compress(const void *data, std::size_t size);
+
+    /// @brief Decompress a block created by compress
+    /// @param source Pointer to the compressed block
+    /// @param sourceSize Size of the compressed block in bytes
+    /// @param destination Memory to decompress into
+    /// @param destinationSize Size of the original data in bytes
+    /// @return False if the block is malformed or does not decompress to exactly destinationSize bytes
+    static bool decompress(const void *source, std::size_t sourceSize, void *destination, std::size_t destinationSize);
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_LZ4_HPP_
\ No newline at end of file
@@ -0,0 +1,74 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_MAPPED_FILE_HPP_
+#define _SFEX_GENERAL_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace sfex
+{
+
+/// @brief Read only view of a whole file that is mapped into memory. Pages are only read from disk when they are first touched.
+class MappedFile
+{
+public:
+    /// @brief Construct a MappedFile that has no file open
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile& operator=(MappedFile &&other) noexcept;
+
+    /// @brief Unmap the file
+    ~MappedFile();
+
+    /// @brief Map a file into memory. Closes the previously opened file.
+    /// @param filename Path of the file to map
+    /// @return True if mapping was successfull
+    bool open(const std::string &filename);
+
+    /// @brief Unmap the file. Pointers returned by getData become invalid.
+    void close();
+
+    /// @brief Returns true if a file is mapped
+    bool isOpen() const;
+
+    /// @brief Get the contents of the file. Empty files have no data.
+    const char* getData() const;
+
+    /// @brief Get the size of the file in bytes
+    std::size_t getSize() const;
+
+private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_open = false;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_MAPPED_FILE_HPP_
\ No newline at end of file
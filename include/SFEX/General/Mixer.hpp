@@ -0,0 +1,197 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_MIXER_HPP_
+#define _SFEX_GENERAL_MIXER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Software mixer that plays thousands of voices through one output, e.g. a single OpenAL source through sfex::MixerStream.
+/// Voices play 16 bit mono or stereo samples at any sample rate with their own gain, pan and pitch. They are mixed in 32 bit float into stereo, with SSE2 where available.
+/// Every voice plays on a bus, and buses have their own gain and can be paused. Every function is thread safe, so voices can be controlled while another thread renders.
+/// The mixer does not depend on an audio device, so it can also render offline, e.g. in tests.
+class Mixer
+{
+public:
+    /// @brief Bus a voice is mixed into
+    enum class Bus
+    {
+        Music,
+        Sfx,
+        Ui,
+    };
+
+    /// @brief Number of buses
+    static constexpr std::size_t BusCount = 3;
+
+    /// @brief Identifies a voice. The id of a voice stays invalid after it has ended, and 0 never refers to a voice.
+    using VoiceId = std::uint64_t;
+
+    /// @brief Samples a voice plays. They are not copied, so they have to stay valid while a voice plays them.
+    struct Source
+    {
+        const std::int16_t *samples = nullptr;
+        std::size_t sampleCount = 0; ///< Number of samples of all channels together
+        unsigned int channelCount = 1; ///< 1 for mono or 2 for stereo
+        unsigned int sampleRate = 44100;
+    };
+
+    /// @brief Settings a voice starts with
+    struct VoiceSettings
+    {
+        float gain = 1.f;
+        float pan = 0.f; ///< -1 for left, 0 for center and 1 for right. Mono voices are panned with constant power, stereo ones are balanced.
+        float pitch = 1.f; ///< Playback speed, which also changes the pitch
+        bool loop = false;
+        Bus bus = Bus::Sfx;
+    };
+
+    /// @brief Construct a mixer with stereo output
+    /// @param sampleRate Sample rate of the output
+    /// @param maxVoices Maximum number of voices that play at the same time
+    explicit Mixer(unsigned int sampleRate=44100, std::size_t maxVoices=4096);
+
+    /// @brief Get the sample rate of the output
+    unsigned int getSampleRate() const;
+
+    /// @brief Get the maximum number of voices that play at the same time
+    std::size_t getMaxVoices() const;
+
+    /// @brief Start a voice with the default settings
+    /// @param source Samples to play
+    /// @return Id of the voice, 0 if the source is empty or every voice is playing
+    VoiceId play(const Source &source);
+
+    /// @brief Start a voice
+    /// @param source Samples to play
+    /// @param settings Settings of the voice
+    /// @return Id of the voice, 0 if the source is empty or every voice is playing
+    VoiceId play(const Source &source, const VoiceSettings &settings);
+
+    /// @brief Stop a voice. Does nothing if the voice has already ended.
+    void stop(VoiceId voice);
+
+    /// @brief Stop every voice
+    void stopAll();
+
+    /// @brief Returns true if the voice has not ended yet
+    bool isPlaying(VoiceId voice) const;
+
+    /// @brief Get the number of voices that have not ended yet
+    std::size_t getVoiceCount() const;
+
+    /// @brief Set the gain of a voice
+    void setGain(VoiceId voice, float gain);
+
+    /// @brief Set the pan of a voice, from -1 for left to 1 for right
+    void setPan(VoiceId voice, float pan);
+
+    /// @brief Set the pitch of a voice
+    void setPitch(VoiceId voice, float pitch);
+
+    /// @brief Set the gain of a bus
+    void setBusGain(Bus bus, float gain);
+
+    /// @brief Get the gain of a bus
+    float getBusGain(Bus bus) const;
+
+    /// @brief Pause or resume a bus. The voices of a paused bus keep their position.
+    void setBusPaused(Bus bus, bool paused);
+
+    /// @brief Returns true if a bus is paused
+    bool isBusPaused(Bus bus) const;
+
+    /// @brief Set the gain that is applied to the sum of the buses
+    void setMasterGain(float gain);
+
+    /// @brief Get the gain that is applied to the sum of the buses
+    float getMasterGain() const;
+
+    /// @brief Mix the next frames of every voice
+    /// @param output Buffer for frameCount interleaved stereo frames
+    /// @param frameCount Number of frames to render
+    void render(float *output, std::size_t frameCount);
+
+    /// @brief Mix the next frames of every voice into 16 bit samples, clipping what exceeds their range
+    /// @param output Buffer for frameCount interleaved stereo frames
+    /// @param frameCount Number of frames to render
+    void render(std::int16_t *output, std::size_t frameCount);
+
+private:
+    struct Voice
+    {
+        Source source;
+        VoiceSettings settings;
+        std::uint64_t position = 0; ///< Frame position in 32.32 fixed point
+        std::uint32_t generation = 0;
+        std::size_t activeIndex = 0;
+        bool active = false;
+    };
+
+    struct BusState
+    {
+        float gain = 1.f;
+        bool paused = false;
+    };
+
+    /// @brief Get the voice an id refers to, nullptr if it has ended
+    Voice* findVoice(VoiceId id);
+
+    /// @brief Get the voice an id refers to, nullptr if it has ended
+    const Voice* findVoice(VoiceId id) const;
+
+    /// @brief Mix the next frames of every voice. The mutex must be held.
+    void mix(float *output, std::size_t frameCount);
+
+    /// @brief Resample the next frames of a voice into stereo m_scratch
+    /// @return Number of frames written, less than frameCount if the voice has ended
+    std::size_t renderVoice(Voice &voice, std::size_t frameCount);
+
+    /// @brief End a voice and return it to the free list
+    void release(Voice &voice);
+
+    mutable std::mutex m_mutex;
+    unsigned int m_sampleRate;
+    std::size_t m_maxVoices;
+    std::vector<Voice> m_voices;
+    std::vector<std::uint32_t> m_freeVoices;
+    std::vector<std::uint32_t> m_activeVoices;
+    std::array<BusState, BusCount> m_buses;
+    float m_masterGain = 1.f;
+
+    std::vector<float> m_scratch;
+    std::vector<float> m_output;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_MIXER_HPP_
\ No newline at end of file
@@ -0,0 +1,77 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_MIXERSTREAM_HPP_
+#define _SFEX_GENERAL_MIXERSTREAM_HPP_
+
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFEX/General/Mixer.hpp>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Sound stream that plays the output of a Mixer, so every voice of the mixer plays through one OpenAL source.
+/// The stream renders the mixer on the audio thread of SFML, and voices can be started and changed from any thread meanwhile.
+/// Smaller chunks lower the latency of changes to voices, larger ones make underruns less likely.
+class MixerStream : public sf::SoundStream
+{
+public:
+    /// @brief Construct a stream that plays a mixer. The mixer has to outlive the stream.
+    /// @param mixer Mixer to play
+    /// @param chunkFrames Number of frames rendered at a time
+    explicit MixerStream(Mixer &mixer, std::size_t chunkFrames=1024);
+
+    /// @brief Stops the stream before the mixer can be destroyed
+    ~MixerStream();
+
+    /// @brief Get the mixer the stream plays
+    Mixer& getMixer() const;
+
+    /// @brief Start a voice that plays a sound buffer. The buffer has to stay alive and unchanged while the voice plays it.
+    /// @param buffer Sound buffer to play
+    /// @param settings Settings of the voice
+    /// @return Id of the voice, 0 if the buffer is empty or every voice is playing
+    Mixer::VoiceId playBuffer(const sf::SoundBuffer &buffer, const Mixer::VoiceSettings &settings=Mixer::VoiceSettings());
+
+    /// @brief Get the samples of a sound buffer as a source of a mixer voice
+    static Mixer::Source getSource(const sf::SoundBuffer &buffer);
+
+protected:
+    /// @brief Renders the next chunk of the mixer. The mixer never ends, so the stream plays until it is stopped.
+    bool onGetData(Chunk &data) override;
+
+    /// @brief Does nothing, since the mixer has no position of its own
+    void onSeek(sf::Time timeOffset) override;
+
+private:
+    Mixer &m_mixer;
+    std::vector<sf::Int16> m_samples;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_MIXERSTREAM_HPP_
\ No newline at end of file
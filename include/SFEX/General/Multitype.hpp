@@ -502,8 +502,8 @@ Multitype::DataType Multitype::typeToDatatype()
                  std::is_same<T, std::u32string>::value ||
                  std::is_same<T, char**>::value
     ) return DataType::STRING;
-    if constexpr(impl::is_specialization<T, std::unordered_map>::value) return DataType::MAP;
-    if constexpr(impl::is_specialization<T, std::vector>::value) return DataType::LIST;
+    if constexpr(::impl::is_specialization<T, std::unordered_map>::value) return DataType::MAP;
+    if constexpr(::impl::is_specialization<T, std::vector>::value) return DataType::LIST;
 
     return DataType::NONE;
 }
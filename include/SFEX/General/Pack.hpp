@@ -0,0 +1,168 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_PACK_HPP_
+#define _SFEX_GENERAL_PACK_HPP_
+
+#include <SFML/System/InputStream.hpp>
+#include <SFEX/General/MappedFile.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief sf::InputStream over one entry of a sfex::Pack. Can be passed to the loadFromStream functions of SFML and of the managers.
+/// Uncompressed entries are read straight from the mapped pack, compressed ones are decompressed into a buffer owned by the stream.
+class PackStream : public sf::InputStream
+{
+public:
+    /// @brief Read data from the stream
+    /// @param data Buffer to copy the read data to
+    /// @param size Desired number of bytes to read
+    /// @return Number of bytes actually read, or -1 if no entry is open
+    sf::Int64 read(void *data, sf::Int64 size) override;
+
+    /// @brief Change the current reading position. Positions past the end move to the end.
+    /// @return The position actually sought to, or -1 if no entry is open
+    sf::Int64 seek(sf::Int64 position) override;
+
+    /// @brief Get the current reading position, or -1 if no entry is open
+    sf::Int64 tell() override;
+
+    /// @brief Get the size of the entry, or -1 if no entry is open
+    sf::Int64 getSize() override;
+
+    /// @brief Get the whole contents of the entry, for loaders that read from memory
+    const char* getData() const;
+
+private:
+    friend class Pack;
+
+    /// @brief Start reading from the given memory
+    void open(const char *data, std::size_t size);
+
+    /// @brief Stop reading, so the stream reports that no entry is open
+    void close();
+
+    std::vector<char> m_buffer;
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_position = 0;
+    bool m_open = false;
+};
+
+/// @brief Read only archive of many assets in a single memory mapped file. Opening an entry costs a binary search instead of a file system lookup.
+/// A pack starts with a header and a table of contents sorted by name, followed by the entries, each aligned and optionally LZ4 compressed. Packs are created with sfex::PackWriter.
+class Pack
+{
+public:
+    /// @brief Location of an entry in the pack
+    struct Entry
+    {
+        std::string_view name;
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint64_t originalSize;
+        bool compressed;
+    };
+
+    /// @brief Map a pack file and read its table of contents. Closes the previously opened pack.
+    /// @param filename Path of the pack file
+    /// @return False if the file cannot be mapped or is not a valid pack
+    bool openFromFile(const std::string &filename);
+
+    /// @brief Unmap the pack. Streams of its uncompressed entries become invalid.
+    void close();
+
+    /// @brief Returns true if the pack contains an entry with the given name
+    bool contains(std::string_view name) const;
+
+    /// @brief Find an entry by name
+    /// @return Pointer to the entry, or nullptr if there is no entry with that name
+    const Entry* find(std::string_view name) const;
+
+    /// @brief Get every entry, sorted by name
+    const std::vector<Entry>& getEntries() const;
+
+    /// @brief Open an entry for reading. The pack has to stay open while the stream is used.
+    /// @param name Name of the entry
+    /// @param stream Stream to open the entry in
+    /// @return False if there is no entry with that name or it cannot be decompressed, in which case the stream has no entry open
+    bool openStream(std::string_view name, PackStream &stream) const;
+
+private:
+    MappedFile m_file;
+    std::vector<Entry> m_entries;
+};
+
+/// @brief Collects assets and writes them as a sfex::Pack
+class PackWriter
+{
+public:
+    /// @brief Construct a writer without entries
+    /// @param alignment Entries start at multiples of this many bytes. Has to be a power of two.
+    explicit PackWriter(std::size_t alignment=16);
+
+    /// @brief Add an entry. Replaces the entry previously added with the same name.
+    /// @param name Name of the entry
+    /// @param data Pointer to the contents
+    /// @param size Size of the contents in bytes
+    /// @param compress Store the entry LZ4 compressed if that makes it smaller
+    void add(const std::string &name, const void *data, std::size_t size, bool compress=false);
+
+    /// @brief Add the contents of a file as an entry
+    /// @param name Name of the entry
+    /// @param filename Path of the file to add
+    /// @param compress Store the entry LZ4 compressed if that makes it smaller
+    /// @return True if the file could be read
+    bool addFromFile(const std::string &name, const std::string &filename, bool compress=false);
+
+    /// @brief Get the number of entries added
+    std::size_t getEntryCount() const;
+
+    /// @brief Write the pack
+    /// @param filename Path of the pack file
+    /// @return True if saving was successfull
+    bool saveToFile(const std::string &filename) const;
+
+private:
+    struct Blob
+    {
+        std::vector<char> data;
+        std::uint64_t originalSize;
+        bool compressed;
+    };
+
+    std::size_t m_alignment;
+    std::map<std::string, Blob> m_blobs;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_PACK_HPP_
\ No newline at end of file
@@ -27,45 +27,380 @@
 
 #include <functional>
 #include <type_traits>
-#include <unordered_set>
 #include <thread>
-#include <future>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+#include <tuple>
+#include <cstdint>
 
 #include <SFEX/General/StaticClass.hpp>
+#include <SFEX/General/Coroutine.hpp>
+#include <SFEX/General/WorkerPool.hpp>
+#include <SFEX/General/TaskGraph.hpp>
+#include <SFEX/General/VirtualClock.hpp>
 #include <SFML/System/Time.hpp>
+#include <SFML/System/Clock.hpp>
 
 namespace sfex
 {
 
+/// @brief What a repeating job does when it falls behind its schedule, e.g. because a run took longer than the period
+enum class CatchUpPolicy
+{
+    Burst,    ///< Every missed tick is run, back to back, until the job has caught up. The number of runs stays exact.
+    Skip,     ///< Missed ticks are dropped. A run that would start more than one period late is dropped too and the job waits for its next tick.
+    Coalesce, ///< All missed ticks are merged into a single run that starts right away, then the job continues on its original ticks.
+};
+
+/// @brief Timing statistics of a repeating job
+struct JobStatistics
+{
+    std::uint64_t runCount = 0;     ///< Number of times the function has been called
+    std::uint64_t skippedTicks = 0; ///< Number of ticks that did not get a run of their own because of the catch-up policy
+    std::uint64_t overrunCount = 0; ///< Number of runs that finished after the next tick was due
+    sf::Time lastJitter;            ///< How late the last run started compared to its tick
+    sf::Time averageJitter;         ///< Average lateness of all runs
+    sf::Time maxJitter;             ///< Largest lateness of all runs
+    sf::Time lastRunDuration;       ///< How long the last call of the function took
+    sf::Time maxRunDuration;        ///< Longest call of the function
+};
+
+namespace impl
+{
+
+/// @brief Shared state between a repeating job and the handles pointing to it
+class JobControl
+{
+public:
+    /// @brief Request cancellation. The job will not run again.
+    void cancel();
+
+    /// @brief Returns true if cancellation has been requested
+    bool isCancelled() const;
+
+    /// @brief Record a run of the job
+    /// @param tick Time the run was due
+    /// @param start Time the run started
+    /// @param end Time the run finished
+    /// @param nextTick Time the following run was due
+    void recordRun(const sf::Time &tick, const sf::Time &start, const sf::Time &end, const sf::Time &nextTick);
+
+    /// @brief Record ticks that were dropped or merged into another run
+    void recordSkippedTicks(std::uint64_t count);
+
+    /// @brief Get a copy of the statistics
+    JobStatistics getStatistics() const;
+
+    /// @brief Store the exception a run has thrown and cancel the job
+    void fail(std::exception_ptr exception);
+
+    /// @brief Get the exception a run has thrown, nullptr if none has
+    std::exception_ptr getException() const;
+
+private:
+    std::atomic<bool> m_cancelled = false;
+    std::exception_ptr m_exception;
+    mutable std::mutex m_mutex;
+    JobStatistics m_statistics;
+    sf::Int64 m_totalJitter = 0;
+};
+
+/// @brief Task that resumes a suspended coroutine. Destroys the coroutine if it is dropped without running, e.g. when the scheduler is destroyed.
+/// Templated on the handle type so that awaiting works without including <coroutine> here.
+template<typename Handle>
+class ResumeTask
+{
+public:
+    explicit ResumeTask(Handle handle);
+    ResumeTask(ResumeTask&& other) noexcept;
+    ResumeTask(const ResumeTask&) = delete;
+    ResumeTask& operator=(const ResumeTask&) = delete;
+    ~ResumeTask();
+
+    void operator()();
+
+private:
+    Handle m_handle;
+};
+
+} // namespace impl
+
+/// @brief Cancellation token of a repeating job. Cheap to copy, all copies refer to the same job.
+class JobHandle
+{
+public:
+    /// @brief Construct an empty handle that does not refer to any job
+    JobHandle() = default;
+
+    /// @brief Stop the job. Safe to call from any thread and more than once. O(1), no lookup involved.
+    void cancel();
+
+    /// @brief Returns true if the handle refers to a job that has not been cancelled yet
+    bool isActive() const;
+
+    /// @brief Returns true if the handle refers to a job
+    bool isValid() const;
+
+    /// @brief Get the timing statistics of the job. Returns empty statistics if the handle does not refer to a job.
+    JobStatistics getStatistics() const;
+
+    /// @brief Get the exception thrown by a run of the job, which stops the job. Returns nullptr if no run has thrown.
+    std::exception_ptr getException() const;
+
+private:
+    friend class Scheduler;
+    explicit JobHandle(std::shared_ptr<impl::JobControl> control);
+
+    std::shared_ptr<impl::JobControl> m_control;
+};
+
 class Scheduler
 {
 public:
-    /// @brief Schedule a function
+    /// @brief Where a delayed callback or a resumed coroutine runs
+    enum class Target
+    {
+        MainThread, ///< Inside update(), on the thread that calls it
+        Worker,     ///< On the worker pool
+    };
+
+    /// @brief Awaitable returned by delay(). Suspends the coroutine without blocking a thread.
+    class DelayAwaiter
+    {
+    public:
+        DelayAwaiter(Scheduler &scheduler, const sf::Time &delay, Target target);
+        bool await_ready() const;
+        template<typename Handle>
+        void await_suspend(Handle handle);
+        void await_resume() const;
+
+    private:
+        Scheduler &m_scheduler;
+        sf::Time m_delay;
+        Target m_target;
+    };
+
+    /// @brief Awaitable returned by nextFrame(). Resumes the coroutine in the next update() call.
+    class NextFrameAwaiter
+    {
+    public:
+        explicit NextFrameAwaiter(Scheduler &scheduler);
+        bool await_ready() const;
+        template<typename Handle>
+        void await_suspend(Handle handle);
+        void await_resume() const;
+
+    private:
+        Scheduler &m_scheduler;
+    };
+
+    /// @brief Construct a scheduler
+    /// @param workerCount Number of threads used by submit() and parallel_for(). 0 means one per hardware thread. The threads are started on first use.
+    /// @param realtimeWorkerCount Number of additional threads that only run Priority::Realtime tasks
+    explicit Scheduler(std::size_t workerCount=0, std::size_t realtimeWorkerCount=0);
+
+    /// @brief Construct a scheduler that follows a virtual clock instead of the real time. No timer thread is started.
+    /// Delayed callbacks and repeating jobs only run inside advance(), on the thread that calls it, so runs are deterministic.
+    /// @param clock Clock to follow. It must outlive the scheduler.
+    /// @param workerCount Number of threads used by submit() and parallel_for(). 0 means one per hardware thread. The threads are started on first use.
+    /// @param realtimeWorkerCount Number of additional threads that only run Priority::Realtime tasks
+    explicit Scheduler(VirtualClock &clock, std::size_t workerCount=0, std::size_t realtimeWorkerCount=0);
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /// @brief Stops the timer thread and the workers. Pending delayed callbacks and repeating jobs are dropped.
+    ~Scheduler();
+
+    /// @brief Schedule a function. No thread is blocked while waiting, the timer thread hands the function to the worker pool when the delay is over.
     /// @param time The delay before running the function
     /// @param funcToSchedule function to schedule
     /// @param funcArgs Function arguments
+    /// @return Future that holds the result of the function
     template<typename Func, typename... Args>
     auto schedule(const sf::Time& time, const Func& funcionToSchedule, Args&&... funcArgs);
 
-    /// @brief Calls the given function with given interval
+    /// @brief Run a function on the given target as soon as possible
+    /// @param target Where to run the function
+    /// @param func Function to run
+    /// @return Future that becomes ready after the function has run and holds the exception it throws
+    template<typename Func>
+    TaskFuture<void> post(Target target, Func&& func);
+
+    /// @brief Run a function on the given target after a delay
+    /// @param delay Delay before the function is handed to the target
+    /// @param target Where to run the function
+    /// @param func Function to run
+    /// @return Future that becomes ready after the function has run and holds the exception it throws
+    template<typename Func>
+    TaskFuture<void> postAfter(const sf::Time &delay, Target target, Func&& func);
+
+    /// @brief Run everything that has been posted to Target::MainThread so far. Call this once per frame from your main loop.
+    /// Functions posted while update() runs are run by the next update() call.
+    void update();
+
+    /// @brief Get the number of update() calls so far
+    std::uint64_t getFrameCount() const;
+
+    /// @brief Move the virtual clock forward and run every timer that becomes due, in deadline order.
+    /// Before each timer runs, the clock is set to its deadline. Target::Worker functions run on the calling thread, Target::MainThread functions are queued for update().
+    /// Functions may advance the clock themselves to simulate time spent working.
+    /// @param time Time to step
+    /// @throws std::logic_error if the scheduler was not constructed with a VirtualClock
+    void advance(const sf::Time &time);
+
+    /// @brief Suspend the calling coroutine for the given time, e.g. co_await scheduler.delay(sf::seconds(2))
+    /// @param time Time to wait
+    /// @param target Where the coroutine continues. By default it continues inside update().
+    DelayAwaiter delay(const sf::Time &time, Target target=Target::MainThread);
+
+    /// @brief Suspend the calling coroutine until the next update() call, e.g. co_await scheduler.nextFrame()
+    NextFrameAwaiter nextFrame();
+
+    /// @brief Calls the given function with given interval on the worker pool until the returned handle is cancelled.
+    /// Runs are due at fixed ticks start + n * period, so the time a run takes does not make the job drift. A run never overlaps with the previous one.
+    /// Missed ticks are handled with CatchUpPolicy::Burst. A run that throws stops the job, and the exception is kept by the handle.
     /// 
-    /// @param name Name of the task. Must be unique.
     /// @param period Period of function to repeat
-    /// @param functionToRepeat The function you want to repeat
-    /// @param funcArgs Arguments of function
-    /// @throws std::runtime_error If a job with same name exists
-    template<typename Func, typename... Args>
-    void repeat(const std::string& name, const sf::Time& period, const Func& functionToRepeat, Args&&... funcArgs);
+    /// @param functionToRepeat The function you want to repeat. It is copied into the job.
+    /// @param funcArgs Arguments of function. They are copied into the job.
+    /// @return Handle that stops the job when cancelled
+    template<typename Func, typename... Args, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CatchUpPolicy>::value>>
+    JobHandle repeat(const sf::Time& period, const Func& functionToRepeat, Args&&... funcArgs);
 
-    /// @brief Stops a repeating job
+    /// @brief Calls the given function with given interval on the worker pool until the returned handle is cancelled
     /// 
-    /// @param name Name of the job.
-    void stopRepeatingJob(const std::string& name);
+    /// @param period Period of function to repeat
+    /// @param policy What to do with ticks that are missed because the job fell behind
+    /// @param functionToRepeat The function you want to repeat. It is copied into the job.
+    /// @param funcArgs Arguments of function. They are copied into the job.
+    /// @return Handle that stops the job when cancelled
+    template<typename Func, typename... Args>
+    JobHandle repeat(const sf::Time& period, CatchUpPolicy policy, const Func& functionToRepeat, Args&&... funcArgs);
+
+    /// @brief Cancels every repeating job started by this scheduler
+    void cancelAll();
+
+    /// @brief Run a function on the worker pool
+    /// @param func Function to run. It is copied or moved into the task.
+    /// @param funcArgs Arguments of function. They are copied or moved into the task.
+    /// @return Future that holds the result of the function
+    template<typename Func, typename... Args, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, Priority>::value>>
+    auto submit(Func&& func, Args&&... funcArgs);
+
+    /// @brief Run a function on the worker pool with the given priority
+    /// @param priority Priority class of the task
+    /// @param func Function to run. It is copied or moved into the task.
+    /// @param funcArgs Arguments of function. They are copied or moved into the task.
+    /// @return Future that holds the result of the function
+    template<typename Func, typename... Args>
+    auto submit(Priority priority, Func&& func, Args&&... funcArgs);
+
+    /// @brief Run a function on the worker pool that should finish within the given time. Within a priority class, the task with the earliest deadline runs first.
+    /// Missed deadlines are counted by WorkerPool::getMissedDeadlineCount().
+    /// @param priority Priority class of the task
+    /// @param deadline Time from now within which the function should have finished
+    /// @param func Function to run. It is copied or moved into the task.
+    /// @param funcArgs Arguments of function. They are copied or moved into the task.
+    /// @return Future that holds the result of the function
+    template<typename Func, typename... Args>
+    auto submitWithDeadline(Priority priority, const sf::Time &deadline, Func&& func, Args&&... funcArgs);
+
+    /// @brief Call fn(i) for every i in range on the worker pool. Returns after every call has finished.
+    /// @param range Indices to iterate over, e.g. sfex::Range{0, 100}
+    /// @param grain Maximum number of indices handled by one task
+    /// @param fn Function to call for every index
+    /// @throws The first exception thrown by fn
+    template<typename Index, typename Func>
+    void parallel_for(const Range<Index> &range, std::size_t grain, Func&& fn);
+
+    /// @brief Run every node of a task graph on the worker pool and wait for them
+    /// @param graph Graph to run. Independent nodes run concurrently.
+    /// @throws The first exception thrown by a node
+    void dispatch(TaskGraph &graph);
+
+    /// @brief Get the worker pool, starting it if needed
+    WorkerPool& getWorkerPool();
+
 private:
-    std::unordered_set<std::string> m_repeatingJobs;
+    struct RepeatingJob
+    {
+        std::shared_ptr<impl::JobControl> control;
+        impl::Task body;
+        sf::Time period;
+        CatchUpPolicy policy;
+        sf::Time tick;
+        std::uint64_t cancelGeneration; ///< Number of cancelAll() calls before the job started
+    };
+
+    struct Timer
+    {
+        sf::Time deadline;
+        std::uint64_t sequence;
+        Target target;
+        impl::Task task;
+        std::shared_ptr<impl::JobControl> job; ///< Control of the repeating job the timer runs the next tick of, if any
+    };
+
+    /// @brief Start a repeating job and queue its first run
+    JobHandle startRepeatingJob(const sf::Time &period, CatchUpPolicy policy, impl::Task body);
+
+    /// @brief Run a repeating job once if its catch-up policy allows it, then queue the next run
+    void runRepeatingJob(const std::shared_ptr<RepeatingJob> &job);
+
+    /// @brief Queue the next tick of a repeating job, or cancel the job if cancelAll() has been called since it started
+    void queueRepeatingJob(const std::shared_ptr<RepeatingJob> &job);
+
+    /// @brief Get the current time of the scheduler clock, or of the virtual clock if there is one
+    sf::Time now() const;
+
+    /// @brief Queue a task on the timer thread, starting it if needed
+    void addTimer(const sf::Time &delay, Target target, impl::Task task);
+
+    /// @brief Queue a task on the timer thread for the given scheduler clock time
+    void addTimerAt(const sf::Time &deadline, Target target, impl::Task task);
+
+    /// @brief Queue a timer, starting the timer thread if needed. The timer mutex must be held.
+    void pushTimer(Timer timer);
+
+    /// @brief Start the timer thread unless the scheduler follows a virtual clock or is being destroyed
+    void startTimerThread();
+
+    /// @brief Hand a task to its target
+    void dispatch(Target target, impl::Task task);
+
+    /// @brief Heap order of the timers. Earliest deadline first, timers with the same deadline in the order they were added.
+    static bool isLater(const Timer &left, const Timer &right);
+
+    /// @brief Body of the timer thread. Sleeps until the earliest deadline and dispatches every expired timer.
+    void timerLoop();
+
+    std::size_t m_workerCount;
+    std::size_t m_realtimeWorkerCount;
+    std::once_flag m_workerPoolFlag;
+    std::unique_ptr<WorkerPool> m_workerPool;
+
+    std::once_flag m_timerThreadFlag;
+    std::thread m_timerThread;
+    std::mutex m_timerMutex;
+    std::condition_variable m_timerCondition;
+    std::vector<Timer> m_timers;
+    std::uint64_t m_timerSequence;
+    std::uint64_t m_cancelGeneration;
+    bool m_timerRunning;
+    sf::Clock m_clock;
+    VirtualClock *m_virtualClock;
+
+    std::mutex m_mainThreadMutex;
+    std::vector<impl::Task> m_mainThreadTasks;
+    std::vector<impl::Task> m_runningMainThreadTasks;
+    std::atomic<std::uint64_t> m_frameCount;
 };
 
 }
 
 #include <SFEX/General/Scheduler.inl>
-#endif // !_SFEX_GENERAL_SCHEDULER_HPP_
\ No newline at end of file
+#endif // !_SFEX_GENERAL_SCHEDULER_HPP_
@@ -27,48 +27,127 @@
 
 #include <SFEX/General/Scheduler.hpp>
 #include <SFML/System/Time.hpp>
-#include <SFML/System/Sleep.hpp>
 
 namespace sfex
 {
 
+namespace impl
+{
+
+template<typename Handle>
+ResumeTask<Handle>::ResumeTask(Handle handle):
+    m_handle(handle)
+{
+}
+
+template<typename Handle>
+ResumeTask<Handle>::ResumeTask(ResumeTask&& other) noexcept:
+    m_handle(other.m_handle)
+{
+    other.m_handle = Handle();
+}
+
+template<typename Handle>
+ResumeTask<Handle>::~ResumeTask()
+{
+    if(m_handle) m_handle.destroy();
+}
+
+template<typename Handle>
+void ResumeTask<Handle>::operator()()
+{
+    Handle handle = m_handle;
+    m_handle = Handle();
+    handle.resume();
+}
+
+} // namespace impl
+
+template<typename Handle>
+void Scheduler::DelayAwaiter::await_suspend(Handle handle)
+{
+    m_scheduler.addTimer(m_delay, m_target, impl::ResumeTask<Handle>(handle));
+}
+
+template<typename Handle>
+void Scheduler::NextFrameAwaiter::await_suspend(Handle handle)
+{
+    m_scheduler.dispatch(Target::MainThread, impl::ResumeTask<Handle>(handle));
+}
+
 template<typename Func, typename... Args>
 auto Scheduler::schedule(const sf::Time& time, const Func& functionToSchedule, Args&&... funcArgs)
 {
-    auto func = [&time, &functionToSchedule](Args&&... args){
-        sf::sleep(time);
-        return functionToSchedule( std::forward<Args>(args)... );
-    };
+    using Result = std::invoke_result_t<const Func&, std::decay_t<Args>...>;
+    auto state = std::make_shared<impl::TaskState<Result>>(&getWorkerPool());
 
-    return std::async(func, funcArgs...);
+    addTimer(time, Target::Worker, [state, functionToSchedule, args = std::make_tuple(std::forward<Args>(funcArgs)...)]() mutable {
+        state->run([&functionToSchedule, &args](){ return std::apply(functionToSchedule, std::move(args)); });
+    });
+
+    return TaskFuture<Result>(std::move(state));
+}
+
+template<typename Func>
+TaskFuture<void> Scheduler::post(Target target, Func&& func)
+{
+    auto state = std::make_shared<impl::TaskState<void>>(&getWorkerPool());
+    dispatch(target, [state, func = std::forward<Func>(func)]() mutable {
+        state->run(func);
+    });
+    return TaskFuture<void>(std::move(state));
+}
+
+template<typename Func>
+TaskFuture<void> Scheduler::postAfter(const sf::Time &delay, Target target, Func&& func)
+{
+    auto state = std::make_shared<impl::TaskState<void>>(&getWorkerPool());
+    addTimer(delay, target, [state, func = std::forward<Func>(func)]() mutable {
+        state->run(func);
+    });
+    return TaskFuture<void>(std::move(state));
+}
+
+template<typename Func, typename... Args, typename>
+JobHandle Scheduler::repeat(const sf::Time& period, const Func& functionToRepeat, Args&&... funcArgs)
+{
+    return repeat(period, CatchUpPolicy::Burst, functionToRepeat, std::forward<Args>(funcArgs)...);
 }
 
 template<typename Func, typename... Args>
-void Scheduler::repeat(const std::string& name, const sf::Time& period, const Func& functionToRepeat, Args&&... funcArgs)
-{
-    auto insertion_result = m_repeatingJobs.insert(name);
-    if(!insertion_result.second)
-    {
-        throw std::runtime_error("An option with the same name already exists!");
-    }
-
-    auto func = [this, name, &period, &functionToRepeat](Args&&... args){
-        while(m_repeatingJobs.find(name) != m_repeatingJobs.end())
-        {
-            functionToRepeat( std::forward<Args>(args)... );
-            sf::sleep(period);
-        }
+JobHandle Scheduler::repeat(const sf::Time& period, CatchUpPolicy policy, const Func& functionToRepeat, Args&&... funcArgs)
+{
+    auto func = [functionToRepeat, args = std::make_tuple(std::forward<Args>(funcArgs)...)]() mutable {
+        std::apply(functionToRepeat, args);
     };
 
-    std::thread repeatingThread(func, funcArgs...);
-    repeatingThread.detach();
+    return startRepeatingJob(period, policy, impl::Task(std::move(func)));
+}
+
+template<typename Func, typename... Args, typename>
+auto Scheduler::submit(Func&& func, Args&&... funcArgs)
+{
+    return getWorkerPool().submit(std::forward<Func>(func), std::forward<Args>(funcArgs)...);
+}
+
+template<typename Func, typename... Args>
+auto Scheduler::submit(Priority priority, Func&& func, Args&&... funcArgs)
+{
+    return getWorkerPool().submit(priority, std::forward<Func>(func), std::forward<Args>(funcArgs)...);
+}
+
+template<typename Func, typename... Args>
+auto Scheduler::submitWithDeadline(Priority priority, const sf::Time &deadline, Func&& func, Args&&... funcArgs)
+{
+    return getWorkerPool().submitWithDeadline(priority, deadline, std::forward<Func>(func), std::forward<Args>(funcArgs)...);
 }
 
-void Scheduler::stopRepeatingJob(const std::string& name)
+template<typename Index, typename Func>
+void Scheduler::parallel_for(const Range<Index> &range, std::size_t grain, Func&& fn)
 {
-    m_repeatingJobs.erase(name);
+    getWorkerPool().parallel_for(range, grain, std::forward<Func>(fn));
 }
 
 }
 
-#endif // !_SFEX_GENERAL_SCHEDULER_INL_
\ No newline at end of file
+#endif // !_SFEX_GENERAL_SCHEDULER_INL_
@@ -0,0 +1,107 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_SPATIALGRID_HPP_
+#define _SFEX_GENERAL_SPATIALGRID_HPP_
+
+#include <SFEX/Numeric/Vector3.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Hashed grid of uniform cubic cells that finds the points near a position.
+/// Only cells that contain points are stored, so the grid can span any area. A query visits the cells its sphere overlaps,
+/// so its cost depends on the points near the position rather than on the number of points in the grid.
+/// Points are identified by small integers, e.g. indices of a vector, that index the grid's own table of points.
+class SpatialGrid
+{
+public:
+    /// @brief Construct an empty grid
+    /// @param cellSize Edge length of a cell. Queries are fastest when their radius is about the size of a cell.
+    explicit SpatialGrid(float cellSize=16.f);
+
+    /// @brief Get the edge length of a cell
+    float getCellSize() const;
+
+    /// @brief Add a point or move it if the grid already contains it
+    /// @param id Identifier of the point
+    /// @param position Position of the point
+    void insert(std::uint32_t id, const Vec3 &position);
+
+    /// @brief Remove a point. Does nothing if the grid does not contain it.
+    void remove(std::uint32_t id);
+
+    /// @brief Returns true if the grid contains a point
+    bool contains(std::uint32_t id) const;
+
+    /// @brief Get the position of a point the grid contains
+    const Vec3& getPosition(std::uint32_t id) const;
+
+    /// @brief Get the number of points in the grid
+    std::size_t getSize() const;
+
+    /// @brief Remove every point
+    void clear();
+
+    /// @brief Find the points within a distance of a position
+    /// @param center Center of the sphere to search
+    /// @param radius Radius of the sphere to search
+    /// @param ids Vector the ids of the points are appended to, in no particular order
+    void query(const Vec3 &center, float radius, std::vector<std::uint32_t> &ids) const;
+
+private:
+    struct Point
+    {
+        Vec3 position;
+        std::uint64_t cell = 0;
+        std::uint32_t cellIndex = 0; ///< Index of the point in the list of its cell
+        bool used = false;
+    };
+
+    /// @brief Get the coordinate of the cell that contains a coordinate
+    std::int32_t getCellCoordinate(float coordinate) const;
+
+    /// @brief Get the key of the cell with the given coordinates
+    static std::uint64_t getCellKey(std::int32_t x, std::int32_t y, std::int32_t z);
+
+    /// @brief Append the points of a cell that are within the sphere
+    void queryCell(const std::vector<std::uint32_t> &cell, const Vec3 &center, float radius2, std::vector<std::uint32_t> &ids) const;
+
+    /// @brief Remove a point from the list of its cell
+    void unlink(std::uint32_t id);
+
+    float m_cellSize;
+    std::size_t m_size = 0;
+    std::vector<Point> m_points;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GENERAL_SPATIALGRID_HPP_
\ No newline at end of file
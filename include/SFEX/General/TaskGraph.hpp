@@ -0,0 +1,131 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_TASKGRAPH_HPP_
+#define _SFEX_GENERAL_TASKGRAPH_HPP_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <limits>
+
+#include <SFEX/General/WorkerPool.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Clock.hpp>
+
+namespace sfex
+{
+
+/// @brief Reusable dependency graph of tasks. Nodes and edges are built once, then the whole graph can be run any number of times.
+/// Nodes whose predecessors have all finished run concurrently on a WorkerPool. Running a graph does not allocate memory.
+class TaskGraph
+{
+public:
+    typedef std::size_t NodeId;
+    static constexpr NodeId InvalidNode = std::numeric_limits<NodeId>::max();
+
+    /// @brief Add a node to the graph
+    /// @param name Name of the node, used for profiling output
+    /// @param work Function that is called every time the graph runs
+    /// @return Identifier of the new node
+    NodeId addNode(const std::string &name, std::function<void()> work);
+
+    /// @brief Make a node wait for another one
+    /// @param before Node that has to finish first
+    /// @param after Node that starts after before has finished
+    /// @throws std::invalid_argument if one of the nodes does not exist or both are the same node
+    void addEdge(NodeId before, NodeId after);
+
+    /// @brief Remove every node and edge
+    void clear();
+
+    /// @brief Get the number of nodes
+    std::size_t getNodeCount() const;
+
+    /// @brief Get the name of a node
+    const std::string& getNodeName(NodeId node) const;
+
+    /// @brief Run every node once and wait until all of them have finished. The calling thread helps running nodes.
+    /// @param pool Pool that runs the nodes
+    /// @throws std::runtime_error if the graph contains a cycle
+    /// @throws The first exception thrown by a node. Nodes that depend on a failed node still run.
+    void run(WorkerPool &pool);
+
+    /// @brief Get the wall clock time the last run took
+    sf::Time getLastDuration() const;
+
+    /// @brief Get how long a node took during the last run
+    sf::Time getNodeDuration(NodeId node) const;
+
+    /// @brief Get the duration of the critical path of the last run, which is the most expensive chain of dependent nodes.
+    /// No matter how many workers are used, a run can not take less time than this.
+    sf::Time getCriticalPathDuration() const;
+
+    /// @brief Get the nodes on the critical path of the last run, in execution order
+    std::vector<NodeId> getCriticalPath() const;
+
+private:
+    struct Node
+    {
+        std::string name;
+        std::function<void()> work;
+        std::vector<NodeId> successors;
+        std::vector<NodeId> predecessors;
+        sf::Time start;
+        sf::Time end;
+        sf::Time pathDuration;
+        NodeId criticalPredecessor = InvalidNode;
+    };
+
+    /// @brief Sort the nodes topologically and allocate the counters. Only does work after the graph has changed.
+    void prepare();
+
+    /// @brief Run a node, then keep running one of the successors it has made ready and push the others to the pool
+    void runFrom(NodeId node);
+
+    /// @brief Find the most expensive chain of nodes using the durations measured in the last run
+    void computeCriticalPath();
+
+    std::vector<Node> m_nodes;
+    std::vector<NodeId> m_order;
+    std::vector<NodeId> m_roots;
+    std::unique_ptr<std::atomic<std::size_t>[]> m_remainingPredecessors;
+    bool m_prepared = false;
+
+    WorkerPool *m_pool = nullptr;
+    std::atomic<std::size_t> m_pendingNodes = 0;
+    std::mutex m_exceptionMutex;
+    std::exception_ptr m_exception;
+    sf::Clock m_clock;
+    sf::Time m_lastDuration;
+    NodeId m_criticalPathEnd = InvalidNode;
+};
+
+} // namespace sfex
+
+#endif // !_SFEX_GENERAL_TASKGRAPH_HPP_
@@ -0,0 +1,59 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_VIRTUALCLOCK_HPP_
+#define _SFEX_GENERAL_VIRTUALCLOCK_HPP_
+
+// Headers
+#include <SFEX/Config.hpp>
+#include <SFML/System/Time.hpp>
+#include <atomic>
+
+namespace sfex
+{
+
+/// @brief A clock that only moves when it is told to. Give it to a Scheduler to step timers by hand in tests and replays.
+class VirtualClock
+{
+public:
+    /// @brief Default constructor. The clock starts at zero.
+    VirtualClock();
+
+    /// @brief Get the elapsed time
+    /// @return Elapsed time
+    sf::Time getElapsedTime() const;
+
+    /// @brief Move the clock forward. Negative times are ignored.
+    /// Only moves the time. Use Scheduler::advance() to also run the timers that become due.
+    /// @param time Time to add
+    void advance(const sf::Time &time);
+
+private:
+    // Member data
+    std::atomic<sf::Int64> m_microseconds;
+};
+
+}
+
+#endif // !_SFEX_GENERAL_VIRTUALCLOCK_HPP_
@@ -0,0 +1,387 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_WORKERPOOL_HPP_
+#define _SFEX_GENERAL_WORKERPOOL_HPP_
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <tuple>
+#include <array>
+#include <cstdint>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Clock.hpp>
+
+namespace sfex
+{
+
+class WorkerPool;
+class Scheduler;
+
+/// @brief Priority class of a task. Workers always take queued tasks of a higher class first.
+enum class Priority
+{
+    Realtime,   ///< Latency critical work such as feeding audio. Can have dedicated workers that run nothing else.
+    High,       ///< Work that should not wait behind bulk work, e.g. streaming assets
+    Normal,     ///< Default class. parallel_for, continuations and the Scheduler run their tasks here.
+    Background, ///< Work that can wait, e.g. analytics. Only runs when no other task is queued.
+};
+
+/// @brief Half open index range [begin, end) used by parallel_for
+template<typename Index>
+struct Range
+{
+    Index begin;
+    Index end;
+};
+
+template<typename Index>
+Range(Index, Index) -> Range<Index>;
+
+namespace impl
+{
+
+/// @brief Move-only type erased callable that the worker pool executes. Small callables are stored inline, so queueing them does not allocate.
+class Task
+{
+public:
+    Task() = default;
+
+    template<typename Func, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, Task>::value>>
+    Task(Func&& func);
+
+    Task(Task&& other) noexcept;
+    Task& operator=(Task&& other) noexcept;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task();
+
+    /// @brief Run the stored callable
+    void operator()();
+
+    /// @brief Returns true if a callable is stored
+    explicit operator bool() const;
+
+private:
+    static constexpr std::size_t InlineSize = 4 * sizeof(void*);
+
+    struct Concept
+    {
+        virtual ~Concept() = default;
+        virtual void run() = 0;
+        virtual Concept* moveTo(void *buffer) = 0;
+    };
+
+    template<typename Func>
+    struct Model : Concept
+    {
+        explicit Model(Func&& f): func(std::move(f)) {}
+        explicit Model(const Func& f): func(f) {}
+        void run() override { func(); }
+        Concept* moveTo(void *buffer) override { return new(buffer) Model(std::move(func)); }
+        Func func;
+    };
+
+    template<typename Func>
+    static constexpr bool fitsInline = sizeof(Model<Func>) <= InlineSize && alignof(Model<Func>) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<Func>::value;
+
+    bool isInline() const;
+    void moveFrom(Task &other);
+    void reset();
+
+    alignas(std::max_align_t) unsigned char m_buffer[InlineSize];
+    Concept *m_callable = nullptr;
+};
+
+/// @brief Double ended task queue on top of a ring buffer. It only grows, so a warmed up queue never allocates.
+class TaskQueue
+{
+public:
+    bool empty() const;
+    void pushBack(Task task);
+    Task popBack();
+    Task popFront();
+
+private:
+    void grow();
+
+    std::vector<Task> m_slots;
+    std::size_t m_head = 0;
+    std::size_t m_size = 0;
+};
+
+/// @brief Shared state between a task and its TaskFuture
+template<typename T>
+class TaskState
+{
+public:
+    using Storage = std::conditional_t<std::is_void<T>::value, bool, T>;
+
+    explicit TaskState(WorkerPool *pool);
+
+    /// @brief Run func and store its result or the exception it throws, then schedule the continuations
+    template<typename Func>
+    void run(Func&& func);
+
+    /// @brief Store an exception thrown by a previous stage, then schedule the continuations
+    void fail(std::exception_ptr exception);
+
+    /// @brief Returns true if the result is available
+    bool isReady() const;
+
+    /// @brief Wait for the result, executing other pending tasks of the pool in the meantime
+    void wait();
+
+    /// @brief Run task once the result is available. Runs it on the pool immediately if the result is already available.
+    void addContinuation(Task task);
+
+    WorkerPool *getPool() const;
+    std::exception_ptr getException() const;
+    Storage& getValue();
+
+private:
+    void complete();
+
+    WorkerPool *m_pool;
+    std::atomic<bool> m_ready = false;
+    std::optional<Storage> m_value;
+    std::exception_ptr m_exception;
+    std::mutex m_mutex;
+    std::condition_variable m_readyCondition;
+    std::vector<Task> m_continuations;
+};
+
+/// @brief Bookkeeping shared by the tasks of one parallel_for call
+template<typename Index, typename Func>
+class ParallelForJob
+{
+public:
+    ParallelForJob(WorkerPool &pool, Func &func, std::size_t grain);
+
+    /// @brief Split [begin, end) in halves until a piece is smaller than the grain, pushing the upper halves to the pool and running the rest
+    void run(Index begin, Index end);
+
+    /// @brief Wait until every piece has been run and rethrow the first exception thrown by func
+    void wait();
+
+private:
+    WorkerPool &m_pool;
+    Func &m_func;
+    std::size_t m_grain;
+    std::atomic<std::size_t> m_pending;
+    std::mutex m_exceptionMutex;
+    std::exception_ptr m_exception;
+};
+
+} // namespace impl
+
+/// @brief Lightweight future returned by WorkerPool::submit. Waiting on it runs other pending tasks instead of blocking a thread.
+template<typename T>
+class TaskFuture
+{
+public:
+    /// @brief Construct an empty future that is not associated with any task
+    TaskFuture() = default;
+
+    /// @brief Returns true if the future is associated with a task
+    bool isValid() const;
+
+    /// @brief Returns true if the task has finished
+    bool isReady() const;
+
+    /// @brief Wait until the task has finished. Pending tasks of the pool are executed by the waiting thread in the meantime.
+    void wait() const;
+
+    /// @brief Wait for the task and return its result. The result is moved out, so call this only once.
+    /// @throws Any exception thrown by the task
+    T get();
+
+    /// @brief Schedule a function that runs on the pool after this task finishes
+    /// @param continuation Function that takes the result of this task as a const reference. Takes no arguments if T is void.
+    /// @return Future of the continuation. If this task throws, the continuation is skipped and the exception is forwarded.
+    template<typename Func>
+    auto then(Func&& continuation);
+
+private:
+    friend class WorkerPool;
+    friend class Scheduler;
+    template<typename> friend class TaskFuture;
+    explicit TaskFuture(std::shared_ptr<impl::TaskState<T>> state);
+
+    std::shared_ptr<impl::TaskState<T>> m_state;
+};
+
+/// @brief Work-stealing thread pool. Every worker owns a task deque, runs its own tasks newest first and steals the oldest tasks of other workers when it runs out.
+/// Tasks of other priority classes and tasks with a deadline wait in shared queues per class, where tasks with the earliest deadline come first.
+class WorkerPool
+{
+public:
+    /// @brief Start the workers
+    /// @param workerCount Number of worker threads. 0 means one worker per hardware thread.
+    /// @param realtimeWorkerCount Number of additional threads that only run Priority::Realtime tasks
+    explicit WorkerPool(std::size_t workerCount=0, std::size_t realtimeWorkerCount=0);
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// @brief Runs every task that is still queued, then joins the workers
+    ~WorkerPool();
+
+    /// @brief Get the number of worker threads, not counting the dedicated realtime workers
+    std::size_t getWorkerCount() const;
+
+    /// @brief Get the number of threads that only run Priority::Realtime tasks
+    std::size_t getRealtimeWorkerCount() const;
+
+    /// @brief Run a function on the pool
+    /// @param func Function to run. It is copied or moved into the task.
+    /// @param funcArgs Arguments of function. They are copied or moved into the task.
+    /// @return Future that holds the result of the function
+    template<typename Func, typename... Args, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, Priority>::value>>
+    auto submit(Func&& func, Args&&... funcArgs);
+
+    /// @brief Run a function on the pool with the given priority
+    /// @param priority Priority class of the task
+    /// @param func Function to run. It is copied or moved into the task.
+    /// @param funcArgs Arguments of function. They are copied or moved into the task.
+    /// @return Future that holds the result of the function
+    template<typename Func, typename... Args>
+    auto submit(Priority priority, Func&& func, Args&&... funcArgs);
+
+    /// @brief Run a function on the pool that should finish within the given time. Within a priority class, the task with the earliest deadline runs first.
+    /// If the function finishes later, it still completes normally but counts as a missed deadline.
+    /// @param priority Priority class of the task
+    /// @param deadline Time from now within which the function should have finished
+    /// @param func Function to run. It is copied or moved into the task.
+    /// @param funcArgs Arguments of function. They are copied or moved into the task.
+    /// @return Future that holds the result of the function
+    template<typename Func, typename... Args>
+    auto submitWithDeadline(Priority priority, const sf::Time &deadline, Func&& func, Args&&... funcArgs);
+
+    /// @brief Get the number of tasks of the given class that finished after their deadline
+    std::uint64_t getMissedDeadlineCount(Priority priority) const;
+
+    /// @brief Call fn(i) for every i in range, spread over the workers. Returns after every call has finished.
+    /// @param range Indices to iterate over
+    /// @param grain Maximum number of indices handled by one task. Larger grains mean less scheduling overhead, smaller ones better balancing.
+    /// @param fn Function to call for every index
+    /// @throws The first exception thrown by fn
+    template<typename Index, typename Func>
+    void parallel_for(const Range<Index> &range, std::size_t grain, Func&& fn);
+
+    /// @brief Queue a task. Tasks pushed from a worker go to its own deque, others are spread over all workers.
+    void push(impl::Task task);
+
+    /// @brief Queue a task with the given priority
+    void push(impl::Task task, Priority priority);
+
+    /// @brief Run one queued task on the calling thread, if there is any
+    /// @return True if a task has been run
+    bool runPendingTask();
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        impl::TaskQueue tasks;
+        std::thread thread;
+    };
+
+    struct LaneTask
+    {
+        sf::Time deadline;
+        std::uint64_t sequence;
+        impl::Task task;
+    };
+
+    /// @brief Shared queue of one priority class, kept as a heap ordered by deadline
+    struct Lane
+    {
+        std::mutex mutex;
+        std::vector<LaneTask> tasks;
+        std::atomic<std::size_t> size = 0;
+        std::atomic<std::uint64_t> missedDeadlines = 0;
+    };
+
+    static constexpr std::size_t LaneCount = 4;
+
+    void workerLoop(std::size_t index);
+
+    /// @brief Body of a dedicated realtime worker
+    void realtimeWorkerLoop();
+
+    /// @brief Take the next task in priority order: realtime, high, normal with a deadline, the deques, background
+    /// @param index Index of the calling worker or the worker count if the caller is not a worker of this pool
+    bool takeTask(std::size_t index, impl::Task &task);
+
+    /// @brief Queue a task in the lane of its priority class
+    /// @param deadline Time on the pool clock the task should finish by
+    void pushToLane(impl::Task task, Priority priority, const sf::Time &deadline);
+
+    /// @brief Take the task with the earliest deadline from the lane of the given class
+    bool popLaneTask(Priority priority, impl::Task &task);
+
+    /// @brief Wake a sleeping worker, if there is any, after a task has been queued
+    void wakeWorker(Priority priority);
+
+    /// @brief Heap order of lane tasks. Earliest deadline first, tasks with the same deadline in the order they were queued.
+    static bool isLater(const LaneTask &left, const LaneTask &right);
+
+    /// @brief Take the newest task from the deque of the given worker
+    bool popTask(std::size_t index, impl::Task &task);
+
+    /// @brief Take the oldest task from any deque, starting with the one after the given worker
+    bool stealTask(std::size_t start, impl::Task &task);
+
+    /// @brief Returns the index of the calling worker or the worker count if the caller is not a worker of this pool
+    std::size_t currentWorkerIndex() const;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_realtimeWorkers;
+    std::array<Lane, LaneCount> m_lanes;
+    std::atomic<std::uint64_t> m_laneSequence;
+    sf::Clock m_clock;
+    std::atomic<std::size_t> m_nextWorker;
+    std::atomic<std::size_t> m_queuedTasks;
+    std::atomic<std::size_t> m_sleepingWorkers;
+    std::atomic<std::size_t> m_sleepingRealtimeWorkers;
+    std::atomic<bool> m_running;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::condition_variable m_realtimeCondition;
+};
+
+} // namespace sfex
+
+#include <SFEX/General/WorkerPool.inl>
+#endif // !_SFEX_GENERAL_WORKERPOOL_HPP_
@@ -0,0 +1,336 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_WORKERPOOL_INL_
+#define _SFEX_GENERAL_WORKERPOOL_INL_
+
+#include <SFEX/General/WorkerPool.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace sfex
+{
+
+namespace impl
+{
+
+template<typename Func, typename>
+Task::Task(Func&& func)
+{
+    using Stored = Model<std::decay_t<Func>>;
+    if constexpr(fitsInline<std::decay_t<Func>>)
+    {
+        m_callable = new(m_buffer) Stored(std::forward<Func>(func));
+    }
+    else
+    {
+        m_callable = new Stored(std::forward<Func>(func));
+    }
+}
+
+template<typename T>
+TaskState<T>::TaskState(WorkerPool *pool):
+    m_pool(pool)
+{
+}
+
+template<typename T>
+template<typename Func>
+void TaskState<T>::run(Func&& func)
+{
+    try
+    {
+        if constexpr(std::is_void<T>::value)
+        {
+            func();
+            m_value.emplace(true);
+        }
+        else
+        {
+            m_value.emplace(func());
+        }
+    }
+    catch(...)
+    {
+        m_exception = std::current_exception();
+    }
+    complete();
+}
+
+template<typename T>
+void TaskState<T>::fail(std::exception_ptr exception)
+{
+    m_exception = exception;
+    complete();
+}
+
+template<typename T>
+bool TaskState<T>::isReady() const
+{
+    return m_ready.load(std::memory_order_acquire);
+}
+
+template<typename T>
+void TaskState<T>::wait()
+{
+    while(!isReady())
+    {
+        if(m_pool->runPendingTask()) continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_readyCondition.wait_for(lock, std::chrono::milliseconds(1), [this](){ return isReady(); });
+    }
+}
+
+template<typename T>
+void TaskState<T>::addContinuation(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!isReady())
+        {
+            m_continuations.push_back(std::move(task));
+            return;
+        }
+    }
+    m_pool->push(std::move(task));
+}
+
+template<typename T>
+WorkerPool* TaskState<T>::getPool() const
+{
+    return m_pool;
+}
+
+template<typename T>
+std::exception_ptr TaskState<T>::getException() const
+{
+    return m_exception;
+}
+
+template<typename T>
+typename TaskState<T>::Storage& TaskState<T>::getValue()
+{
+    return *m_value;
+}
+
+template<typename T>
+void TaskState<T>::complete()
+{
+    std::vector<Task> continuations;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.store(true, std::memory_order_release);
+        continuations.swap(m_continuations);
+    }
+    m_readyCondition.notify_all();
+
+    for(auto &continuation : continuations)
+    {
+        m_pool->push(std::move(continuation));
+    }
+}
+
+template<typename T, typename Func>
+struct ContinuationResult
+{
+    using type = std::invoke_result_t<Func&, const T&>;
+};
+
+template<typename Func>
+struct ContinuationResult<void, Func>
+{
+    using type = std::invoke_result_t<Func&>;
+};
+
+template<typename Index, typename Func>
+ParallelForJob<Index, Func>::ParallelForJob(WorkerPool &pool, Func &func, std::size_t grain):
+    m_pool(pool), m_func(func), m_grain(grain), m_pending(1)
+{
+}
+
+template<typename Index, typename Func>
+void ParallelForJob<Index, Func>::run(Index begin, Index end)
+{
+    try
+    {
+        while(static_cast<std::size_t>(end - begin) > m_grain)
+        {
+            Index middle = begin + (end - begin) / 2;
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+            m_pool.push([this, middle, end](){ run(middle, end); });
+            end = middle;
+        }
+
+        for(Index i = begin; i < end; ++i)
+        {
+            m_func(i);
+        }
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(m_exceptionMutex);
+        if(!m_exception) m_exception = std::current_exception();
+    }
+    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+template<typename Index, typename Func>
+void ParallelForJob<Index, Func>::wait()
+{
+    while(m_pending.load(std::memory_order_acquire) != 0)
+    {
+        if(!m_pool.runPendingTask()) std::this_thread::yield();
+    }
+    if(m_exception) std::rethrow_exception(m_exception);
+}
+
+} // namespace impl
+
+template<typename T>
+TaskFuture<T>::TaskFuture(std::shared_ptr<impl::TaskState<T>> state):
+    m_state(std::move(state))
+{
+}
+
+template<typename T>
+bool TaskFuture<T>::isValid() const
+{
+    return static_cast<bool>(m_state);
+}
+
+template<typename T>
+bool TaskFuture<T>::isReady() const
+{
+    return m_state && m_state->isReady();
+}
+
+template<typename T>
+void TaskFuture<T>::wait() const
+{
+    m_state->wait();
+}
+
+template<typename T>
+T TaskFuture<T>::get()
+{
+    m_state->wait();
+    if(m_state->getException()) std::rethrow_exception(m_state->getException());
+    if constexpr(!std::is_void<T>::value)
+    {
+        return std::move(m_state->getValue());
+    }
+}
+
+template<typename T>
+template<typename Func>
+auto TaskFuture<T>::then(Func&& continuation)
+{
+    using Result = typename impl::ContinuationResult<T, std::decay_t<Func>>::type;
+    auto next = std::make_shared<impl::TaskState<Result>>(m_state->getPool());
+
+    m_state->addContinuation([source = m_state, next, func = std::forward<Func>(continuation)]() mutable {
+        if(source->getException())
+        {
+            next->fail(source->getException());
+            return;
+        }
+
+        if constexpr(std::is_void<T>::value)
+        {
+            next->run([&func](){ return func(); });
+        }
+        else
+        {
+            next->run([&func, &source](){ return func(static_cast<const T&>(source->getValue())); });
+        }
+    });
+
+    return TaskFuture<Result>(std::move(next));
+}
+
+template<typename Func, typename... Args, typename>
+auto WorkerPool::submit(Func&& func, Args&&... funcArgs)
+{
+    using Result = std::invoke_result_t<std::decay_t<Func>&, std::decay_t<Args>...>;
+    auto state = std::make_shared<impl::TaskState<Result>>(this);
+
+    push([state, func = std::forward<Func>(func), args = std::make_tuple(std::forward<Args>(funcArgs)...)]() mutable {
+        state->run([&func, &args](){ return std::apply(func, std::move(args)); });
+    });
+
+    return TaskFuture<Result>(std::move(state));
+}
+
+template<typename Func, typename... Args>
+auto WorkerPool::submit(Priority priority, Func&& func, Args&&... funcArgs)
+{
+    using Result = std::invoke_result_t<std::decay_t<Func>&, std::decay_t<Args>...>;
+    auto state = std::make_shared<impl::TaskState<Result>>(this);
+
+    push([state, func = std::forward<Func>(func), args = std::make_tuple(std::forward<Args>(funcArgs)...)]() mutable {
+        state->run([&func, &args](){ return std::apply(func, std::move(args)); });
+    }, priority);
+
+    return TaskFuture<Result>(std::move(state));
+}
+
+template<typename Func, typename... Args>
+auto WorkerPool::submitWithDeadline(Priority priority, const sf::Time &deadline, Func&& func, Args&&... funcArgs)
+{
+    using Result = std::invoke_result_t<std::decay_t<Func>&, std::decay_t<Args>...>;
+    auto state = std::make_shared<impl::TaskState<Result>>(this);
+    sf::Time due = m_clock.getElapsedTime() + deadline;
+    Lane &lane = m_lanes[static_cast<std::size_t>(priority)];
+
+    pushToLane([this, &lane, due, state, func = std::forward<Func>(func), args = std::make_tuple(std::forward<Args>(funcArgs)...)]() mutable {
+        state->run([this, &lane, due, &func, &args](){
+            // Counts the miss before the result is stored, so it is visible to whoever waits on the future
+            struct DeadlineCheck
+            {
+                WorkerPool *pool;
+                Lane &lane;
+                sf::Time due;
+                ~DeadlineCheck() { if(pool->m_clock.getElapsedTime() > due) ++lane.missedDeadlines; }
+            } check{this, lane, due};
+            return std::apply(func, std::move(args));
+        });
+    }, priority, due);
+
+    return TaskFuture<Result>(std::move(state));
+}
+
+template<typename Index, typename Func>
+void WorkerPool::parallel_for(const Range<Index> &range, std::size_t grain, Func&& fn)
+{
+    if(!(range.begin < range.end)) return;
+
+    impl::ParallelForJob<Index, std::remove_reference_t<Func>> job(*this, fn, std::max<std::size_t>(grain, 1));
+    job.run(range.begin, range.end);
+    job.wait();
+}
+
+} // namespace sfex
+
+#endif // !_SFEX_GENERAL_WORKERPOOL_INL_
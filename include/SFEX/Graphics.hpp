@@ -29,8 +29,12 @@
 #include <SFEX/Graphics/Animation.hpp>
 #include <SFEX/Graphics/Color.hpp>
 #include <SFEX/Graphics/Ellipse.hpp>
+#include <SFEX/Graphics/ImageCache.hpp>
+#include <SFEX/Graphics/ImagePyramid.hpp>
+#include <SFEX/Graphics/RectanglePacker.hpp>
 #include <SFEX/Graphics/RoundedRectangle.hpp>
 #include <SFEX/Graphics/Squircle.hpp>
 #include <SFEX/Graphics/Star.hpp>
+#include <SFEX/Graphics/TextureAtlas.hpp>
 
 #endif // !_SFEX_GRAPHICS_HPP_
\ No newline at end of file
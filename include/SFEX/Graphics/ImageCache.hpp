@@ -0,0 +1,118 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GRAPHICS_IMAGE_CACHE_HPP_
+#define _SFEX_GRAPHICS_IMAGE_CACHE_HPP_
+
+#include <SFEX/General/MappedFile.hpp>
+#include <SFEX/Numeric/Vector2.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Directory of decoded RGBA images, so image files do not have to be decoded again on later runs.
+/// An image is cached per source path. A cached image is valid while the source file keeps its modification time and size,
+/// or, when the modification time has changed, while the content of the source still has the same hash.
+/// Cached images are read through a memory mapping and can be stored LZ4 compressed.
+class ImageCache
+{
+public:
+    /// @brief Decoded image found in the cache. The pixels stay valid as long as the entry exists.
+    class Entry
+    {
+    public:
+        /// @brief Get the size of the image in pixels
+        const Vec2u& getSize() const;
+
+        /// @brief Get the RGBA pixels of the image
+        const std::uint8_t* getPixels() const;
+
+        /// @brief Get the xxHash64 of the content of the source file
+        std::uint64_t getContentHash() const;
+
+    private:
+        friend class ImageCache;
+
+        MappedFile m_file;
+        std::vector<std::uint8_t> m_buffer;
+        const std::uint8_t *m_pixels = nullptr;
+        Vec2u m_size;
+        std::uint64_t m_contentHash = 0;
+    };
+
+    /// @brief Construct a disabled cache
+    ImageCache() = default;
+
+    /// @brief Construct a cache that keeps its files in directory
+    /// @param directory Directory of the cache files, created when the first image is stored
+    /// @param compress Store new images LZ4 compressed
+    explicit ImageCache(const std::string &directory, bool compress=false);
+
+    /// @brief Set the directory of the cache files. An empty directory disables the cache.
+    void setDirectory(const std::string &directory);
+
+    /// @brief Get the directory of the cache files
+    const std::string& getDirectory() const;
+
+    /// @brief Store new images LZ4 compressed. Compressed images take less disk space but have to be decompressed when they are found.
+    void setCompression(bool compress);
+
+    /// @brief Returns true if new images are stored LZ4 compressed
+    bool isCompressing() const;
+
+    /// @brief Returns true if a directory has been set
+    bool isEnabled() const;
+
+    /// @brief Find the decoded image of a source file
+    /// @param filename Path of the source file
+    /// @param entry Receives the image if it has been found
+    /// @return True if a valid image has been found
+    bool find(const std::string &filename, Entry &entry) const;
+
+    /// @brief Store the decoded image of a source file, replacing a previously stored one
+    /// @param filename Path of the source file
+    /// @param contentHash xxHash64 of the content of the source file
+    /// @param size Size of the image in pixels
+    /// @param pixels RGBA pixels of the image
+    /// @return True if the image has been stored
+    bool store(const std::string &filename, std::uint64_t contentHash, const Vec2u &size, const std::uint8_t *pixels) const;
+
+    /// @brief Remove every cache file from the directory
+    void clear() const;
+
+private:
+    /// @brief Get the path of the cache file of a source file
+    std::string getCachePath(const std::string &filename) const;
+
+    std::string m_directory;
+    bool m_compress = false;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GRAPHICS_IMAGE_CACHE_HPP_
\ No newline at end of file
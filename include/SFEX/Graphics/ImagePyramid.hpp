@@ -0,0 +1,87 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GRAPHICS_IMAGE_PYRAMID_HPP_
+#define _SFEX_GRAPHICS_IMAGE_PYRAMID_HPP_
+
+#include <SFEX/General/WorkerPool.hpp>
+#include <SFEX/Numeric/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Chain of RGBA images where every level is a 2x2 box filtered copy of the previous one with half its size.
+/// Used to load textures at a reduced resolution or at the smallest resolution that is still sharp at the size they are drawn at.
+class ImagePyramid
+{
+public:
+    /// @brief Construct an empty pyramid
+    ImagePyramid() = default;
+
+    /// @brief Build the pyramid of an image
+    /// @param pixels RGBA pixels of the image, 4 bytes per pixel, row by row
+    /// @param size Size of the image in pixels
+    /// @param levelCount Maximum number of levels including the image itself, 0 builds every level down to 1x1
+    /// @param pool Pool to spread the rows of every level over, or nullptr to build on the calling thread
+    void build(const std::uint8_t *pixels, const Vec2u &size, std::size_t levelCount=0, WorkerPool *pool=nullptr);
+
+    /// @brief Get the number of levels. Level 0 is a copy of the image the pyramid has been built from.
+    std::size_t getLevelCount() const;
+
+    /// @brief Get the size of a level in pixels
+    const Vec2u& getLevelSize(std::size_t level) const;
+
+    /// @brief Get the RGBA pixels of a level
+    const std::uint8_t* getLevelPixels(std::size_t level) const;
+
+    /// @brief Find the smallest level that is at least as large as size in both dimensions
+    /// @return Index of that level, 0 if even the image itself is smaller
+    std::size_t findLevel(const Vec2u &size) const;
+
+    /// @brief Get the size of the level below an image of the given size. Odd sizes round down, but no side gets smaller than 1.
+    static Vec2u getDownscaledSize(const Vec2u &size);
+
+    /// @brief Average every 2x2 block of an image into one pixel. Uses SSE2 where available.
+    /// @param source RGBA pixels of the image
+    /// @param sourceSize Size of the image in pixels
+    /// @param target Buffer for getDownscaledSize(sourceSize) RGBA pixels
+    /// @param pool Pool to spread the rows over, or nullptr to run on the calling thread
+    static void downscale(const std::uint8_t *source, const Vec2u &sourceSize, std::uint8_t *target, WorkerPool *pool=nullptr);
+
+private:
+    struct Level
+    {
+        Vec2u size;
+        std::vector<std::uint8_t> pixels;
+    };
+
+    std::vector<Level> m_levels;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GRAPHICS_IMAGE_PYRAMID_HPP_
\ No newline at end of file
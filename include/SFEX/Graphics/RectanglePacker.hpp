@@ -0,0 +1,79 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GRAPHICS_RECTANGLE_PACKER_HPP_
+#define _SFEX_GRAPHICS_RECTANGLE_PACKER_HPP_
+
+#include <SFEX/Numeric/Vector2.hpp>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Packs rectangles into a fixed size area with the skyline bottom-left heuristic.
+/// The result only depends on the size of the area and the order of the insertions.
+class RectanglePacker
+{
+public:
+    /// @brief Construct a packer for an empty area
+    /// @param size Size of the area to pack rectangles into
+    explicit RectanglePacker(const Vec2u &size);
+
+    /// @brief Find room for a rectangle and reserve it
+    /// @param size Size of the rectangle
+    /// @param position Top left corner of the reserved room. Only written if the rectangle fits.
+    /// @return True if the rectangle fits into the area
+    bool insert(const Vec2u &size, Vec2u &position);
+
+    /// @brief Release every rectangle
+    void clear();
+
+    /// @brief Get the size of the area
+    const Vec2u& getSize() const;
+
+    /// @brief Get the size of the smallest area starting at the origin that contains every inserted rectangle
+    const Vec2u& getUsedSize() const;
+
+private:
+    /// @brief Horizontal segment of the skyline. Everything below y is occupied.
+    struct Segment
+    {
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+    };
+
+    /// @brief Get the lowest y at which a rectangle of the given size fits when its left edge is at the given segment
+    /// @return False if the rectangle does not fit there
+    bool fit(std::size_t index, const Vec2u &size, unsigned int &y) const;
+
+    Vec2u m_size;
+    Vec2u m_usedSize;
+    std::vector<Segment> m_skyline;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GRAPHICS_RECTANGLE_PACKER_HPP_
\ No newline at end of file
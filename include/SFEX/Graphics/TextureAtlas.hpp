@@ -0,0 +1,117 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GRAPHICS_TEXTURE_ATLAS_HPP_
+#define _SFEX_GRAPHICS_TEXTURE_ATLAS_HPP_
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFEX/Graphics/Animation.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Packs many small images into a few large pages, so that they can be drawn from a single texture.
+/// Packing is deterministic: the same images and settings always produce the same pages, so an atlas can be built once and saved to disk.
+class TextureAtlas
+{
+public:
+    /// @brief Location of a packed image
+    struct Region
+    {
+        std::size_t page;
+        sf::IntRect rect;
+    };
+
+    /// @brief Construct an empty atlas
+    /// @param pageSize Maximum width and height of a page
+    /// @param padding Empty pixels kept between neighbouring images to prevent bleeding when the textures are smoothed
+    explicit TextureAtlas(unsigned int pageSize=2048, unsigned int padding=1);
+
+    /// @brief Add an image to pack. Replaces the image previously added with the same key.
+    /// @param key Unique identifier of the image
+    /// @param image Image to pack
+    void add(const std::string &key, const sf::Image &image);
+
+    /// @brief Load an image from file and add it to pack
+    /// @param key Unique identifier of the image
+    /// @param filename Path of the image file to load
+    /// @return True if loading was successfull
+    bool addFromFile(const std::string &key, const std::string &filename);
+
+    /// @brief Pack every added image into pages. Replaces the previous pages and releases the added images.
+    /// @return False if an image is larger than a page. The atlas is left unchanged in that case.
+    bool build();
+
+    /// @brief Returns true if the atlas contains an image with the given key
+    bool contains(const std::string &key) const;
+
+    /// @brief Get the location of a packed image
+    /// @throws std::out_of_range if there is no image with the given key
+    const Region& getRegion(const std::string &key) const;
+
+    /// @brief Get the regions of all packed images, ordered by key
+    const std::map<std::string, Region>& getRegions() const;
+
+    /// @brief Make animation frames from packed images
+    /// @param keys Keys of the images, in the order of the frames
+    /// @param duration Duration of every frame
+    /// @throws std::invalid_argument if the images are not on the same page
+    std::vector<Animation::Frame> getFrames(const std::vector<std::string> &keys, const sf::Time &duration) const;
+
+    /// @brief Get the number of pages
+    std::size_t getPageCount() const;
+
+    /// @brief Get a page image
+    const sf::Image& getPage(std::size_t page) const;
+
+    /// @brief Get the key under which sfex::TextureManager::loadFromAtlas stores a page
+    /// @param prefix Prefix passed to loadFromAtlas
+    /// @param page Index of the page
+    static std::string getPageKey(const std::string &prefix, std::size_t page);
+
+    /// @brief Save the atlas. Regions are written to filename, page i is written to filename.i.png
+    /// @return True if saving was successfull
+    bool saveToFile(const std::string &filename) const;
+
+    /// @brief Load an atlas saved by saveToFile. Replaces the current pages and regions.
+    /// @return True if loading was successfull
+    bool loadFromFile(const std::string &filename);
+
+private:
+    unsigned int m_pageSize;
+    unsigned int m_padding;
+    std::map<std::string, sf::Image> m_images;
+    std::map<std::string, Region> m_regions;
+    std::vector<sf::Image> m_pages;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_GRAPHICS_TEXTURE_ATLAS_HPP_
\ No newline at end of file
@@ -27,7 +27,10 @@
 
 #include <SFEX/Config.hpp>
 #include <SFEX/Managers/AnimationManager.hpp>
+#include <SFEX/Managers/AsyncLoad.hpp>
+#include <SFEX/Managers/EmitterManager.hpp>
 #include <SFEX/Managers/ManagerBase.hpp>
+#include <SFEX/Managers/ManifestLoader.hpp>
 #include <SFEX/Managers/MusicManager.hpp>
 #include <SFEX/Managers/OptionManager.hpp>
 #include <SFEX/Managers/SceneManager.hpp>
@@ -45,7 +45,7 @@ public:
     /// @brief Play or resume the animation corresponding to given key. Does nothing if key is invalid.
     /// @param key Key corresponding to animation you want to play.
     /// @param restartIfSameKey Restart animation if the same key is given.
-    void play(const std::string& key, bool restartIfSameKey=false);
+    void play(std::string_view key, bool restartIfSameKey=false);
 
     /// @brief Pauses the current animation.
     void pause();
@@ -0,0 +1,82 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_MANAGERS_ASYNC_LOAD_HPP_
+#define _SFEX_MANAGERS_ASYNC_LOAD_HPP_
+
+#include <atomic>
+#include <memory>
+
+namespace sfex
+{
+
+/// @brief Progress of a resource that is being loaded in the background
+enum class LoadStatus
+{
+    Decoding, ///< The file is being read and decoded on a worker
+    Uploading, ///< The decoded data waits to be handed over on the owning thread
+    Loaded, ///< The resource has been stored in its manager
+    Failed, ///< The file could not be read or decoded
+};
+
+/// @brief Status handle returned by the asynchronous loaders of the managers. Copies refer to the same load.
+class AsyncLoad
+{
+public:
+    /// @brief Construct an empty handle that is not associated with any load
+    AsyncLoad() = default;
+
+    /// @brief Construct a handle of a load that starts in the given state
+    explicit AsyncLoad(LoadStatus status): m_status(std::make_shared<std::atomic<LoadStatus>>(status)) {}
+
+    /// @brief Returns true if the handle is associated with a load
+    bool isValid() const { return m_status != nullptr; }
+
+    /// @brief Get the current state of the load
+    LoadStatus getStatus() const { return m_status->load(std::memory_order_acquire); }
+
+    /// @brief Returns true if the load has either finished or failed
+    bool isDone() const
+    {
+        LoadStatus status = getStatus();
+        return status == LoadStatus::Loaded || status == LoadStatus::Failed;
+    }
+
+    /// @brief Returns true if both handles refer to the same load
+    bool operator==(const AsyncLoad &other) const { return m_status == other.m_status; }
+
+    /// @brief Returns true if the handles refer to different loads
+    bool operator!=(const AsyncLoad &other) const { return m_status != other.m_status; }
+
+    /// @brief Advance the load to the given state. Used by the managers.
+    void setStatus(LoadStatus status) { m_status->store(status, std::memory_order_release); }
+
+private:
+    std::shared_ptr<std::atomic<LoadStatus>> m_status;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_MANAGERS_ASYNC_LOAD_HPP_
\ No newline at end of file
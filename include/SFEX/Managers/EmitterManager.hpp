@@ -0,0 +1,205 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_MANAGERS_EMITTERMANAGER_HPP_
+#define _SFEX_MANAGERS_EMITTERMANAGER_HPP_
+
+#include <SFML/Audio/Sound.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFEX/General/Listener.hpp>
+#include <SFEX/General/SpatialGrid.hpp>
+#include <SFEX/Managers/SoundManager.hpp>
+#include <cstdint>
+#include <queue>
+#include <string_view>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Plays sounds of a SoundManager at positions in the world, with many more emitters than voices.
+/// Only emitters that the listener can hear play on a voice, i.e. an sf::Sound. The others are virtual: they keep their playing offset but use no sf::Sound.
+/// update finds the audible emitters near the listener with a spatial grid, so its cost depends on the emitters near the listener rather than on all emitters.
+/// An emitter takes its volume, pitch, minimum distance, attenuation and relative mode from the sf::Sound stored under its key.
+/// The distance at which an emitter becomes inaudible is computed when it starts, so later changes to the volume of that sf::Sound only affect emitters started afterwards.
+/// Emitters refer to that sf::Sound through a handle. When its key is removed, renamed away, evicted or given another buffer, its emitters count as ended and are released by update.
+class EmitterManager
+{
+public:
+    /// @brief Identifies an emitter. The id of an emitter stays invalid after it has ended, and 0 never refers to an emitter.
+    using EmitterId = std::uint64_t;
+
+    /// @brief Construct a manager that plays sounds of a SoundManager. The sound manager has to outlive this manager.
+    /// @param sounds Sound manager that stores the sounds
+    /// @param voiceCount Maximum number of emitters that play on an sf::Sound at the same time
+    /// @param cellSize Edge length of a cell of the spatial grid, best about the distance at which sounds become inaudible
+    explicit EmitterManager(SoundManager &sounds, std::size_t voiceCount=32, float cellSize=64.f);
+    EmitterManager(const EmitterManager&) = delete;
+    EmitterManager& operator=(const EmitterManager&) = delete;
+
+    /// @brief Start an emitter. It starts virtual and is heard after the next update if it is audible.
+    /// @param key Unique identifier of the sound to play
+    /// @param position Position of the emitter, relative to the listener if the sound is
+    /// @param loop Whether the emitter plays until it is stopped
+    /// @return Id of the emitter, 0 if key has no buffer
+    EmitterId play(std::string_view key, const Vec3 &position, bool loop=false);
+
+    /// @brief Stop an emitter. Does nothing if it has already ended.
+    void stop(EmitterId emitter);
+
+    /// @brief Stop every emitter
+    void stopAll();
+
+    /// @brief Move an emitter
+    void setPosition(EmitterId emitter, const Vec3 &position);
+
+    /// @brief Get the position of an emitter that has not ended
+    /// @throws std::out_of_range if the emitter has ended
+    Vec3 getPosition(EmitterId emitter) const;
+
+    /// @brief Returns true if an emitter has not ended, whether it is virtual or not
+    bool isPlaying(EmitterId emitter) const;
+
+    /// @brief Returns true if an emitter has not ended and plays on no voice
+    bool isVirtual(EmitterId emitter) const;
+
+    /// @brief Get how far an emitter is into its sound, which advances for virtual emitters as well
+    /// @return Playing offset, 0 if the emitter has ended
+    sf::Time getPlayingOffset(EmitterId emitter) const;
+
+    /// @brief Set the gain below which emitters are not heard, between 0 and 1. Defaults to 0.01, about -40 dB.
+    void setAudibleThreshold(float gain);
+
+    /// @brief Get the gain below which emitters are not heard
+    float getAudibleThreshold() const;
+
+    /// @brief Get the maximum number of emitters that play on a voice at the same time
+    std::size_t getVoiceCount() const;
+
+    /// @brief Get the number of emitters that have not ended
+    std::size_t getEmitterCount() const;
+
+    /// @brief Get the number of emitters that play on a voice
+    std::size_t getRealCount() const;
+
+    /// @brief Advance the emitters and give the voices to the loudest emitters the listener can hear.
+    /// When more emitters are audible than there are voices, emitters in front of the listener win over equally loud ones behind it.
+    /// Call this once per frame. Emitters that lose their voice become virtual, and emitters that get one start at their current offset.
+    /// @param listener Listener whose position and direction are used. Its global volume scales the gain of every emitter.
+    /// @param elapsed Time since the last update
+    void update(const Listener &listener, sf::Time elapsed);
+
+private:
+    static constexpr std::uint32_t NO_VOICE = UINT32_MAX;
+    static constexpr std::size_t SWEEP_COUNT = 64; ///< Emitters that update checks for a removed sound besides the ones near the listener
+
+    struct Emitter
+    {
+        SoundManager::Handle source;
+        const sf::SoundBuffer *buffer = nullptr; ///< Buffer of the source when the emitter started
+        sf::Time duration;
+        Vec3 position;
+        sf::Time start;          ///< Time of the manager when the emitter started
+        float pitch = 1.f;
+        std::uint64_t selected = 0; ///< Last update that gave the emitter a voice
+        std::uint32_t generation = 1;
+        std::uint32_t voice = NO_VOICE;
+        bool gridded = false;    ///< Whether the grid or m_ungridded holds the emitter
+        bool loop = false;
+        bool active = false;
+    };
+
+    struct Voice
+    {
+        sf::Sound sound;
+        std::uint32_t emitter = 0;
+        bool used = false;
+    };
+
+    /// @brief End time of an emitter that does not loop
+    struct Ending
+    {
+        sf::Time time;
+        EmitterId emitter;
+
+        bool operator>(const Ending &other) const;
+    };
+
+    /// @brief Audible emitter that competes for a voice
+    struct Candidate
+    {
+        float priority;
+        std::uint32_t emitter;
+    };
+
+    /// @brief Get the emitter an id refers to, nullptr if it has ended
+    Emitter* findEmitter(EmitterId id);
+
+    /// @brief Get the emitter an id refers to, nullptr if it has ended or its sound has been removed
+    const Emitter* findPlaying(EmitterId id) const;
+
+    /// @brief Get the sf::Sound an emitter plays, nullptr if it has been removed or its buffer has changed
+    const sf::Sound* getSource(const Emitter &emitter) const;
+
+    /// @brief Get how far an emitter is into its sound
+    sf::Time getOffset(const Emitter &emitter) const;
+
+    /// @brief Get the distance beyond which a sound is quieter than the audible threshold, infinity if it never is
+    float getAudibleRadius(const sf::Sound &source) const;
+
+    /// @brief Add an emitter to the grid, or to the emitters the grid cannot find
+    void place(std::uint32_t index, const sf::Sound &source);
+
+    /// @brief Play an emitter on a free voice
+    void promote(std::uint32_t index);
+
+    /// @brief Stop the voice of an emitter, so it becomes virtual
+    void demote(Emitter &emitter);
+
+    /// @brief End an emitter and return it to the free list
+    void release(std::uint32_t index);
+
+    SoundManager &m_sounds;
+    SpatialGrid m_grid;
+    float m_threshold = 0.01f;
+    sf::Time m_time;
+    std::uint64_t m_updateCount = 0;
+    std::size_t m_activeCount = 0;
+    std::size_t m_realCount = 0;
+    std::size_t m_sweepIndex = 0;
+    float m_maxRadius = 0.f; ///< Largest audible radius of a bounded emitter that has started since the manager was last empty
+
+    std::vector<Emitter> m_emitters;
+    std::vector<std::uint32_t> m_freeEmitters;
+    std::vector<std::uint32_t> m_ungridded; ///< Emitters that the grid cannot find, since they are heard at any distance or move with the listener
+    std::vector<Voice> m_voices;
+    std::priority_queue<Ending, std::vector<Ending>, std::greater<Ending>> m_endings;
+    std::vector<std::uint32_t> m_found;
+    std::vector<Candidate> m_candidates;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_MANAGERS_EMITTERMANAGER_HPP_
\ No newline at end of file
@@ -26,9 +26,14 @@
 #define _SFEX_MANAGERS_MANAGERBASE_HPP_
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <optional>
+#include <cstdint>
+#include <limits>
+#include <initializer_list>
+#include <utility>
 
 namespace sfex
 {
@@ -38,6 +43,67 @@ template<typename T>
 class ManagerBase : public std::unordered_map<std::string, T>
 {
 public:
+    using Map = std::unordered_map<std::string, T>;
+
+    /// @brief Reference to a stored resource that is resolved with an array lookup instead of hashing the key.
+    /// Handles of removed resources become stale and resolve to nullptr, even if the key is loaded again.
+    struct Handle
+    {
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+
+        bool operator==(const Handle &other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const Handle &other) const { return !(*this == other); }
+    };
+
+    /// @brief Counters of the memory budget
+    struct CacheStatistics
+    {
+        std::uint64_t hits = 0;      ///< Lookups through get(), acquire() or reference() that found their resource
+        std::uint64_t misses = 0;    ///< Lookups through get(), acquire() or reference() that did not, e.g. because the resource has been evicted
+        std::uint64_t evictions = 0; ///< Resources removed to stay within the memory budget
+        std::size_t memoryUsage = 0; ///< Bytes of all resources with a known size
+        std::size_t memoryBudget = 0;///< Configured budget, 0 means unlimited
+    };
+
+    /// @brief Counted reference to a stored resource. A resource is never evicted while a reference to it exists.
+    /// The manager must outlive its references and must not be moved while they exist.
+    class Reference
+    {
+    public:
+        Reference() = default;
+        Reference(const Reference &other);
+        Reference(Reference &&other) noexcept;
+        Reference& operator=(Reference other) noexcept;
+        ~Reference();
+
+        /// @brief Get the resource, or nullptr if the reference is empty or the resource has been removed
+        T* get() const;
+
+        /// @brief Get the handle of the resource
+        const Handle& getHandle() const;
+
+        /// @brief Returns true if the reference points to a resource that is still stored
+        bool isValid() const;
+
+    private:
+        friend class ManagerBase;
+        Reference(ManagerBase *manager, const Handle &handle);
+
+        ManagerBase *m_manager = nullptr;
+        Handle m_handle;
+    };
+
+    ManagerBase() = default;
+    ManagerBase(ManagerBase &&other) = default;
+    ManagerBase& operator=(ManagerBase &&other) = default;
+    virtual ~ManagerBase() = default;
+
+    /// @brief Copy the resources and the budget. Handles of other are not valid for the copy and the sizes of the resources are not copied.
+    ManagerBase(const ManagerBase &other);
+
+    /// @brief Copy the resources and the budget. Every handle of this manager becomes stale.
+    ManagerBase& operator=(const ManagerBase &other);
 
     enum class FilterType
     {
@@ -47,28 +113,252 @@ public:
         Does_not_contain,
     };
     
-    /// @brief A function to check if the key is present in the hashmap
+    /// @brief A function to check if the key is present in the hashmap. Does not allocate, also when called with a string literal.
     /// @param key Key to check
     /// @return true if the key is present in the hashmap
-    bool contains(const std::string &key) const;
+    bool contains(std::string_view key) const;
+
+    /// @brief Get the resource stored under key. Does not allocate, also when called with a string literal.
+    /// @param key Key of the resource
+    /// @return Pointer to the resource, or nullptr if the key is not present
+    T* get(std::string_view key);
+
+    /// @brief Get the resource stored under key. Does not allocate, also when called with a string literal.
+    /// @param key Key of the resource
+    /// @return Pointer to the resource, or nullptr if the key is not present
+    const T* get(std::string_view key) const;
 
     /// @brief Get all keys
     /// @return All keys in a vector
     std::vector<std::string> keys() const;
 
-    /// @brief Filter each key by pattern and method then return matching keys
+    /// @brief Filter each key by pattern and method then return matching keys.
+    /// Starts_with and Ends_with use sorted key indexes that are built on first use and kept up to date afterwards,
+    /// so they cost O(log n + matches) instead of a scan over every key. Their results are sorted.
     /// @param pattern Pattern to look for while filtering
     /// @param method Filtering method to use while filtering
     /// @return Keys that are filtered
-    std::vector<std::string> filter(std::string pattern, FilterType method);
+    std::vector<std::string> filter(std::string_view pattern, FilterType method);
 
-    /// @brief Remove a key from the hashmap
+    /// @brief Remove a key from the hashmap. If the resource has aliases, it stays stored under one of them.
     /// @param key Key to remove
-    void remove(const std::string &key);
+    void remove(std::string_view key);
 
     /// @brief Remove multiple keys from the hashmap
     /// @param keys Keys to remove
     void remove(const std::vector<std::string> &keys);
+
+    /// @brief Get a handle to the resource stored under key. Acquiring the same key again returns the same handle.
+    /// @param key Key of the resource
+    /// @return Handle to the resource, or an invalid handle if the key is not present
+    Handle acquire(std::string_view key);
+
+    /// @brief Get the resource a handle refers to
+    /// @param handle Handle returned by acquire()
+    /// @return Pointer to the resource, or nullptr if the handle is stale or invalid
+    T* get(const Handle &handle);
+
+    /// @brief Get the resource a handle refers to
+    /// @param handle Handle returned by acquire()
+    /// @return Pointer to the resource, or nullptr if the handle is stale or invalid
+    const T* get(const Handle &handle) const;
+
+    /// @brief Returns true if the handle refers to a resource that is still stored
+    bool contains(const Handle &handle) const;
+
+    /// @brief Get a counted reference to the resource stored under key. Referenced resources are never evicted.
+    /// @param key Key of the resource
+    /// @return Reference to the resource, or an empty reference if the key is not present
+    Reference reference(std::string_view key);
+
+    /// @brief Set the number of bytes a resource occupies. Only resources with a size count towards the budget and can be evicted.
+    /// Evicts other resources if the budget is exceeded.
+    /// @param key Key of the resource
+    /// @param bytes Size of the resource in bytes
+    void setResourceSize(std::string_view key, std::size_t bytes);
+
+    /// @brief Limit the bytes occupied by resources with a known size. When the limit is exceeded, the least recently used resources without references are removed.
+    /// @param bytes Budget in bytes, 0 means unlimited
+    void setMemoryBudget(std::size_t bytes);
+
+    /// @brief Get the memory budget in bytes, 0 means unlimited
+    std::size_t getMemoryBudget() const;
+
+    /// @brief Get the bytes occupied by resources with a known size
+    std::size_t getMemoryUsage() const;
+
+    /// @brief Get the hit, miss and eviction counters
+    CacheStatistics getCacheStatistics() const;
+
+    /// @brief Make alias another key of the resource stored under key. Looking up the alias gives that resource, so several keys can share one resource without copies.
+    /// Aliases are not listed by keys(), filter() or iteration, and the functions inherited from std::unordered_map such as at, find and count do not resolve them. Removing an alias only removes the alias. Removing the key of a resource that has aliases
+    /// with remove() or erase(key) moves the resource to one of its aliases, while erasing it by iterator, clearing or evicting also removes the aliases.
+    /// @param alias Key to add. A resource stored under it is removed.
+    /// @param key Key of the resource, or another alias of it
+    /// @return False if key is not present
+    bool addAlias(const std::string &alias, std::string_view key);
+
+    /// @brief Returns true if key is an alias of another key
+    bool isAlias(std::string_view key) const;
+
+    /// @brief Get every alias together with the key of the resource it refers to
+    const std::unordered_map<std::string, std::string>& getAliases() const;
+
+    /// @brief Access the resource stored under key or the resource an alias refers to, default constructing it if the key is not present
+    T& operator[](const std::string &key);
+
+    /// @brief Access the resource stored under key or the resource an alias refers to, default constructing it if the key is not present
+    T& operator[](std::string &&key);
+
+    /// @brief Insert a resource if its key is not present
+    /// @return Iterator to the resource with that key and true if it has been inserted
+    std::pair<typename Map::iterator, bool> insert(const typename Map::value_type &value);
+
+    /// @brief Insert a resource if its key is not present
+    /// @return Iterator to the resource with that key and true if it has been inserted
+    std::pair<typename Map::iterator, bool> insert(typename Map::value_type &&value);
+
+    /// @brief Insert every resource whose key is not present yet
+    void insert(std::initializer_list<typename Map::value_type> values);
+
+    /// @brief Insert every resource in [first, last) whose key is not present yet
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    /// @brief Insert a node extracted from another map if its key is not present. Lets resources that cannot be moved be built outside of the manager.
+    /// @return Position of the resource with that key, whether the node has been inserted, and the node if it has not
+    typename Map::insert_return_type insert(typename Map::node_type &&node);
+
+    /// @brief Construct a resource in place if its key is not present
+    /// @return Iterator to the resource with that key and true if it has been inserted
+    template<typename... Args>
+    std::pair<typename Map::iterator, bool> emplace(Args&&... args);
+
+    /// @brief Construct a resource from args if key is not present
+    /// @return Iterator to the resource with that key and true if it has been inserted
+    template<typename... Args>
+    std::pair<typename Map::iterator, bool> try_emplace(const std::string &key, Args&&... args);
+
+    /// @brief Remove every resource. Every handle becomes stale.
+    void clear();
+
+    /// @brief Remove the resource stored under key, making its handle stale. Removes only the alias if key is an alias, and moves the resource to one of its aliases if it has any.
+    /// @return Number of removed keys
+    typename Map::size_type erase(const std::string &key);
+
+    /// @brief Remove the resource at position together with its aliases, making its handle stale
+    /// @return Iterator following the removed resource
+    typename Map::iterator erase(typename Map::const_iterator position);
+
+    /// @brief Remove the resources in [first, last), making their handles stale
+    /// @return Iterator following the last removed resource
+    typename Map::iterator erase(typename Map::const_iterator first, typename Map::const_iterator last);
+
+protected:
+    /// @brief Called right before a resource is removed, also when it is evicted or the manager is cleared
+    /// @param key Key of the resource
+    /// @param resource Resource that is about to be removed
+    virtual void onErase(const std::string &key, T &resource);
+
+    /// @brief Called after the key of a resource has been removed and the resource has moved to one of its aliases
+    /// @param oldKey Removed key
+    /// @param newKey Former alias that the resource is stored under now
+    /// @param resource Resource that has moved
+    virtual void onRename(const std::string &oldKey, const std::string &newKey, T &resource);
+
+    /// @brief Count the size of a resource towards another resource instead, for resources that share memory when the one it is counted for goes away.
+    /// The memory usage stays the same and nothing is evicted, so it can be called from onErase.
+    /// @param from Key of the resource whose size moves, its size becomes unknown
+    /// @param to Key of the resource that takes over the size, replacing its own size
+    void moveResourceSize(std::string_view from, std::string_view to);
+
+    /// @brief Copy key into a per thread buffer that is reused by every lookup, so maps keyed by std::string can be searched with a std::string_view without allocating
+    static const std::string& lookupKey(std::string_view key);
+
+private:
+    // These would store or take out resources without updating the slots, aliases and budget
+    using Map::insert_or_assign;
+    using Map::emplace_hint;
+    using Map::extract;
+    using Map::merge;
+    using Map::swap;
+    friend void swap(ManagerBase &lhs, ManagerBase &rhs) = delete;
+
+    static constexpr std::uint32_t NoSlot = std::numeric_limits<std::uint32_t>::max();
+
+    struct Slot
+    {
+        T *resource = nullptr;
+        const std::string *key = nullptr;
+        std::uint32_t generation = 0;
+        std::uint32_t referenceCount = 0;
+        std::size_t bytes = 0;
+        bool sized = false;
+        // Links of the usage list of the resources that have a size
+        std::uint32_t newer = NoSlot;
+        std::uint32_t older = NoSlot;
+    };
+
+    /// @brief Get the slot of a resource, giving it one if needed
+    std::uint32_t acquireSlot(typename Map::iterator it);
+
+    /// @brief Make the handle of a resource stale, if it has one
+    void releaseSlot(const T *resource);
+
+    /// @brief Mark a resource as the most recently used one, if it has a size
+    void touch(std::uint32_t index);
+
+    /// @brief Remove a slot from the usage list
+    void unlink(std::uint32_t index);
+
+    /// @brief Remove least recently used resources without references until the budget is met
+    /// @param keep Slot that must not be evicted
+    void evict(std::uint32_t keep);
+
+    void addReference(const Handle &handle);
+    void removeReference(const Handle &handle);
+
+    /// @brief Find a key or the key an alias refers to without constructing a std::string for it
+    typename Map::iterator lookup(std::string_view key);
+
+    /// @brief Find a key or the key an alias refers to without constructing a std::string for it
+    typename Map::const_iterator lookup(std::string_view key) const;
+
+    /// @brief Remove every alias of the resource stored under key
+    void removeAliasesOf(const std::string &key);
+
+    /// @brief Store the resource at it under its alphabetically first alias, pointing the other aliases to that key. Keeps its handle valid.
+    /// @return False if the resource has no aliases
+    bool moveToAlias(typename Map::iterator it);
+
+    /// @brief Add a newly inserted key to the key indexes, if they have been built. An alias with the same name is dropped.
+    void indexKey(const std::string &key);
+
+    /// @brief Remove a key that is about to be erased from the key indexes, if they have been built
+    void unindexKey(const std::string &key);
+
+    /// @brief Build the key indexes from every stored key
+    void buildKeyIndex();
+
+    /// @brief Order of the suffix index. Compares the keys read backwards.
+    static bool isReverseLess(std::string_view left, std::string_view right);
+
+    // Elements of an unordered_map never move, so the slots can point into it directly
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+    std::unordered_map<const T*, std::uint32_t> m_slotOfResource;
+
+    std::uint32_t m_newestSlot = NoSlot;
+    std::uint32_t m_oldestSlot = NoSlot;
+    CacheStatistics m_statistics;
+
+    // Views into the keys of the map, sorted forwards for Starts_with and backwards for Ends_with
+    bool m_keyIndexBuilt = false;
+    std::vector<std::string_view> m_sortedKeys;
+    std::vector<std::string_view> m_sortedReversedKeys;
+
+    // Alias to the key of the resource it refers to. Aliases never refer to other aliases.
+    std::unordered_map<std::string, std::string> m_aliases;
 };
 
 } // namespace sfex
@@ -23,14 +23,115 @@
 //
 
 #include <SFEX/Managers/ManagerBase.hpp>
+#include <algorithm>
 
 namespace sfex
 {
 
 template<typename T>
-bool ManagerBase<T>::contains(const std::string &key) const
+ManagerBase<T>::Reference::Reference(ManagerBase *manager, const Handle &handle):
+    m_manager(manager), m_handle(handle)
 {
-    return (this->find(key) != this->end());
+    if(m_manager) m_manager->addReference(m_handle);
+}
+
+template<typename T>
+ManagerBase<T>::Reference::Reference(const Reference &other):
+    Reference(other.m_manager, other.m_handle)
+{
+}
+
+template<typename T>
+ManagerBase<T>::Reference::Reference(Reference &&other) noexcept:
+    m_manager(other.m_manager), m_handle(other.m_handle)
+{
+    other.m_manager = nullptr;
+}
+
+template<typename T>
+typename ManagerBase<T>::Reference& ManagerBase<T>::Reference::operator=(Reference other) noexcept
+{
+    std::swap(m_manager, other.m_manager);
+    std::swap(m_handle, other.m_handle);
+    return *this;
+}
+
+template<typename T>
+ManagerBase<T>::Reference::~Reference()
+{
+    if(m_manager) m_manager->removeReference(m_handle);
+}
+
+template<typename T>
+T* ManagerBase<T>::Reference::get() const
+{
+    if(!m_manager) return nullptr;
+    return m_manager->get(m_handle);
+}
+
+template<typename T>
+const typename ManagerBase<T>::Handle& ManagerBase<T>::Reference::getHandle() const
+{
+    return m_handle;
+}
+
+template<typename T>
+bool ManagerBase<T>::Reference::isValid() const
+{
+    return m_manager && m_manager->contains(m_handle);
+}
+
+template<typename T>
+ManagerBase<T>::ManagerBase(const ManagerBase &other):
+    Map(other), m_aliases(other.m_aliases)
+{
+    m_statistics.memoryBudget = other.m_statistics.memoryBudget;
+}
+
+template<typename T>
+ManagerBase<T>& ManagerBase<T>::operator=(const ManagerBase &other)
+{
+    if(this == &other) return *this;
+
+    clear();
+    Map::operator=(other);
+    m_keyIndexBuilt = false;
+    m_aliases = other.m_aliases;
+    m_statistics.memoryBudget = other.m_statistics.memoryBudget;
+    return *this;
+}
+
+template<typename T>
+bool ManagerBase<T>::contains(std::string_view key) const
+{
+    return (lookup(key) != this->end());
+}
+
+template<typename T>
+T* ManagerBase<T>::get(std::string_view key)
+{
+    auto it = lookup(key);
+    if(it == this->end())
+    {
+        ++m_statistics.misses;
+        return nullptr;
+    }
+
+    ++m_statistics.hits;
+    if(m_newestSlot != NoSlot)
+    {
+        auto slotIt = m_slotOfResource.find(&it->second);
+        if(slotIt != m_slotOfResource.end()) touch(slotIt->second);
+    }
+    return &it->second;
+}
+
+template<typename T>
+const T* ManagerBase<T>::get(std::string_view key) const
+{
+    auto it = lookup(key);
+    if(it == this->end()) return nullptr;
+    return &it->second;
 }
 
 template<typename T>
@@ -45,48 +146,62 @@ std::vector<std::string> ManagerBase<T>::keys() const
 }
 
 template<typename T>
-std::vector<std::string> ManagerBase<T>::filter(std::string pattern, ManagerBase<T>::FilterType method)
+std::vector<std::string> ManagerBase<T>::filter(std::string_view pattern, ManagerBase<T>::FilterType method)
 {
     std::vector<std::string> result;
-    for(auto &p : *this)
+    switch (method)
     {
-        bool filtered = false;
-        switch (method)
+        case FilterType::Starts_with:
         {
-            case FilterType::Starts_with:
+            if(!m_keyIndexBuilt) buildKeyIndex();
+            auto it = std::lower_bound(m_sortedKeys.begin(), m_sortedKeys.end(), pattern);
+            for(; it != m_sortedKeys.end() && it->substr(0, pattern.length()) == pattern; ++it)
             {
-                filtered = p.first.find(pattern) == 0;
-                break;
+                result.emplace_back(*it);
             }
-            case FilterType::Ends_with:
+            break;
+        }
+        case FilterType::Ends_with:
+        {
+            if(!m_keyIndexBuilt) buildKeyIndex();
+            auto it = std::lower_bound(m_sortedReversedKeys.begin(), m_sortedReversedKeys.end(), pattern, &ManagerBase<T>::isReverseLess);
+            for(; it != m_sortedReversedKeys.end() && it->length() >= pattern.length() && it->substr(it->length() - pattern.length()) == pattern; ++it)
             {
-                filtered = p.first.substr(p.first.length() - pattern.length(), pattern.length()) == pattern;
-                break;
+                result.emplace_back(*it);
             }
-            case FilterType::Contains:
+            break;
+        }
+        case FilterType::Contains:
+        {
+            for(auto &p : *this)
             {
-                filtered = p.first.find(pattern) != std::string::npos;
-                break;
+                if(p.first.find(pattern) != std::string::npos) result.push_back(p.first);
             }
-            case FilterType::Does_not_contain:
+            break;
+        }
+        case FilterType::Does_not_contain:
+        {
+            for(auto &p : *this)
             {
-                filtered = p.first.find(pattern) == std::string::npos;
-                break;
+                if(p.first.find(pattern) == std::string::npos) result.push_back(p.first);
             }
-            
-            default:
-                break;
+            break;
         }
-        if (filtered) result.push_back(p.first);
+        
+        default:
+            break;
     }
     return result;
 }
 
 template<typename T>
-void ManagerBase<T>::remove(const std::string &key)
+void ManagerBase<T>::remove(std::string_view key)
 {
-    if(!this->contains(key)) return;
-    this->erase(key);
+    if(!m_aliases.empty() && m_aliases.erase(lookupKey(key))) return;
+
+    auto it = lookup(key);
+    if(it == this->end() || moveToAlias(it)) return;
+    this->erase(it);
 }
 
 template<typename T>
@@ -98,4 +213,529 @@ void ManagerBase<T>::remove(const std::vector<std::string> &keys)
     }
 }
 
+template<typename T>
+typename ManagerBase<T>::Handle ManagerBase<T>::acquire(std::string_view key)
+{
+    auto it = lookup(key);
+    if(it == this->end())
+    {
+        ++m_statistics.misses;
+        return Handle();
+    }
+
+    ++m_statistics.hits;
+    std::uint32_t index = acquireSlot(it);
+    touch(index);
+    return {index, m_slots[index].generation};
+}
+
+template<typename T>
+T* ManagerBase<T>::get(const Handle &handle)
+{
+    if(handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+    {
+        ++m_statistics.misses;
+        return nullptr;
+    }
+
+    ++m_statistics.hits;
+    touch(handle.index);
+    return m_slots[handle.index].resource;
+}
+
+template<typename T>
+const T* ManagerBase<T>::get(const Handle &handle) const
+{
+    if(handle.index >= m_slots.size()) return nullptr;
+
+    const Slot &slot = m_slots[handle.index];
+    if(slot.generation != handle.generation) return nullptr;
+    return slot.resource;
+}
+
+template<typename T>
+bool ManagerBase<T>::contains(const Handle &handle) const
+{
+    return get(handle) != nullptr;
+}
+
+template<typename T>
+typename ManagerBase<T>::Reference ManagerBase<T>::reference(std::string_view key)
+{
+    Handle handle = acquire(key);
+    if(!contains(handle)) return Reference();
+    return Reference(this, handle);
+}
+
+template<typename T>
+void ManagerBase<T>::setResourceSize(std::string_view key, std::size_t bytes)
+{
+    auto it = lookup(key);
+    if(it == this->end()) return;
+
+    std::uint32_t index = acquireSlot(it);
+    Slot &slot = m_slots[index];
+    if(slot.sized) m_statistics.memoryUsage -= slot.bytes;
+    slot.bytes = bytes;
+    slot.sized = true;
+    m_statistics.memoryUsage += bytes;
+
+    touch(index);
+    evict(index);
+}
+
+template<typename T>
+void ManagerBase<T>::moveResourceSize(std::string_view from, std::string_view to)
+{
+    auto fromIt = lookup(from);
+    auto toIt = lookup(to);
+    if(fromIt == this->end() || toIt == this->end() || fromIt == toIt) return;
+
+    auto slotIt = m_slotOfResource.find(&fromIt->second);
+    if(slotIt == m_slotOfResource.end() || !m_slots[slotIt->second].sized) return;
+    std::uint32_t fromIndex = slotIt->second;
+    std::uint32_t toIndex = acquireSlot(toIt);
+
+    // A resource that already has a size keeps its place in the usage list, so an eviction that is running can go on
+    Slot &target = m_slots[toIndex];
+    if(target.sized) m_statistics.memoryUsage -= target.bytes;
+    target.bytes = m_slots[fromIndex].bytes;
+    if(!target.sized)
+    {
+        target.sized = true;
+        touch(toIndex);
+    }
+
+    unlink(fromIndex);
+    m_slots[fromIndex].bytes = 0;
+    m_slots[fromIndex].sized = false;
+}
+
+template<typename T>
+void ManagerBase<T>::setMemoryBudget(std::size_t bytes)
+{
+    m_statistics.memoryBudget = bytes;
+    evict(NoSlot);
+}
+
+template<typename T>
+std::size_t ManagerBase<T>::getMemoryBudget() const
+{
+    return m_statistics.memoryBudget;
+}
+
+template<typename T>
+std::size_t ManagerBase<T>::getMemoryUsage() const
+{
+    return m_statistics.memoryUsage;
+}
+
+template<typename T>
+typename ManagerBase<T>::CacheStatistics ManagerBase<T>::getCacheStatistics() const
+{
+    return m_statistics;
+}
+
+template<typename T>
+bool ManagerBase<T>::addAlias(const std::string &alias, std::string_view key)
+{
+    auto it = lookup(key);
+    if(it == this->end()) return false;
+    if(it->first == alias) return true;
+
+    // The resource may be stored under alias itself, so keep a copy of the key it goes by
+    std::string target = it->first;
+    m_aliases.erase(alias);
+    erase(alias);
+    m_aliases[alias] = std::move(target);
+    return true;
+}
+
+template<typename T>
+bool ManagerBase<T>::isAlias(std::string_view key) const
+{
+    return !m_aliases.empty() && m_aliases.find(lookupKey(key)) != m_aliases.end();
+}
+
+template<typename T>
+const std::unordered_map<std::string, std::string>& ManagerBase<T>::getAliases() const
+{
+    return m_aliases;
+}
+
+template<typename T>
+T& ManagerBase<T>::operator[](const std::string &key)
+{
+    if(!m_aliases.empty())
+    {
+        auto aliasIt = m_aliases.find(key);
+        if(aliasIt != m_aliases.end()) return Map::find(aliasIt->second)->second;
+    }
+
+    auto [it, inserted] = Map::try_emplace(key);
+    if(inserted) indexKey(it->first);
+    return it->second;
+}
+
+template<typename T>
+T& ManagerBase<T>::operator[](std::string &&key)
+{
+    if(!m_aliases.empty())
+    {
+        auto aliasIt = m_aliases.find(key);
+        if(aliasIt != m_aliases.end()) return Map::find(aliasIt->second)->second;
+    }
+
+    auto [it, inserted] = Map::try_emplace(std::move(key));
+    if(inserted) indexKey(it->first);
+    return it->second;
+}
+
+template<typename T>
+std::pair<typename ManagerBase<T>::Map::iterator, bool> ManagerBase<T>::insert(const typename Map::value_type &value)
+{
+    auto result = Map::insert(value);
+    if(result.second) indexKey(result.first->first);
+    return result;
+}
+
+template<typename T>
+std::pair<typename ManagerBase<T>::Map::iterator, bool> ManagerBase<T>::insert(typename Map::value_type &&value)
+{
+    auto result = Map::insert(std::move(value));
+    if(result.second) indexKey(result.first->first);
+    return result;
+}
+
+template<typename T>
+void ManagerBase<T>::insert(std::initializer_list<typename Map::value_type> values)
+{
+    insert(values.begin(), values.end());
+}
+
+template<typename T>
+template<typename InputIt>
+void ManagerBase<T>::insert(InputIt first, InputIt last)
+{
+    for(; first != last; ++first)
+    {
+        insert(*first);
+    }
+}
+
+template<typename T>
+typename ManagerBase<T>::Map::insert_return_type ManagerBase<T>::insert(typename Map::node_type &&node)
+{
+    auto result = Map::insert(std::move(node));
+    if(result.inserted) indexKey(result.position->first);
+    return result;
+}
+
+template<typename T>
+template<typename... Args>
+std::pair<typename ManagerBase<T>::Map::iterator, bool> ManagerBase<T>::emplace(Args&&... args)
+{
+    auto result = Map::emplace(std::forward<Args>(args)...);
+    if(result.second) indexKey(result.first->first);
+    return result;
+}
+
+template<typename T>
+template<typename... Args>
+std::pair<typename ManagerBase<T>::Map::iterator, bool> ManagerBase<T>::try_emplace(const std::string &key, Args&&... args)
+{
+    auto result = Map::try_emplace(key, std::forward<Args>(args)...);
+    if(result.second) indexKey(result.first->first);
+    return result;
+}
+
+template<typename T>
+void ManagerBase<T>::clear()
+{
+    for(auto &p : *this)
+    {
+        onErase(p.first, p.second);
+    }
+
+    for(auto &slot : m_slots)
+    {
+        if(slot.resource) ++slot.generation;
+        slot = Slot{nullptr, nullptr, slot.generation};
+    }
+    m_freeSlots.clear();
+    for(std::size_t i = m_slots.size(); i > 0; --i)
+    {
+        m_freeSlots.push_back(static_cast<std::uint32_t>(i - 1));
+    }
+    m_slotOfResource.clear();
+    m_newestSlot = NoSlot;
+    m_oldestSlot = NoSlot;
+    m_statistics.memoryUsage = 0;
+    m_sortedKeys.clear();
+    m_sortedReversedKeys.clear();
+    m_aliases.clear();
+    Map::clear();
+}
+
+template<typename T>
+typename ManagerBase<T>::Map::size_type ManagerBase<T>::erase(const std::string &key)
+{
+    if(!m_aliases.empty() && m_aliases.erase(key)) return 1;
+
+    auto it = this->find(key);
+    if(it == this->end()) return 0;
+
+    if(!moveToAlias(it)) erase(it);
+    return 1;
+}
+
+template<typename T>
+typename ManagerBase<T>::Map::iterator ManagerBase<T>::erase(typename Map::const_iterator position)
+{
+    // Erasing an empty range turns the const_iterator into an iterator
+    auto it = Map::erase(position, position);
+    onErase(it->first, it->second);
+    releaseSlot(&it->second);
+    unindexKey(it->first);
+    removeAliasesOf(it->first);
+    return Map::erase(it);
+}
+
+template<typename T>
+typename ManagerBase<T>::Map::iterator ManagerBase<T>::erase(typename Map::const_iterator first, typename Map::const_iterator last)
+{
+    auto it = Map::erase(first, first);
+    while(it != last)
+    {
+        it = erase(it);
+    }
+    return it;
+}
+
+template<typename T>
+void ManagerBase<T>::onErase(const std::string &key, T &resource)
+{
+}
+
+template<typename T>
+void ManagerBase<T>::onRename(const std::string &oldKey, const std::string &newKey, T &resource)
+{
+}
+
+template<typename T>
+std::uint32_t ManagerBase<T>::acquireSlot(typename Map::iterator it)
+{
+    auto slotIt = m_slotOfResource.find(&it->second);
+    if(slotIt != m_slotOfResource.end()) return slotIt->second;
+
+    std::uint32_t index;
+    if(!m_freeSlots.empty())
+    {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    m_slots[index].resource = &it->second;
+    m_slots[index].key = &it->first;
+    m_slotOfResource.emplace(&it->second, index);
+    return index;
+}
+
+template<typename T>
+void ManagerBase<T>::releaseSlot(const T *resource)
+{
+    auto slotIt = m_slotOfResource.find(resource);
+    if(slotIt == m_slotOfResource.end()) return;
+
+    std::uint32_t index = slotIt->second;
+    Slot &slot = m_slots[index];
+    if(slot.sized)
+    {
+        unlink(index);
+        m_statistics.memoryUsage -= slot.bytes;
+    }
+    slot = Slot{nullptr, nullptr, slot.generation + 1};
+    m_freeSlots.push_back(index);
+    m_slotOfResource.erase(slotIt);
+}
+
+template<typename T>
+void ManagerBase<T>::touch(std::uint32_t index)
+{
+    if(!m_slots[index].sized || m_newestSlot == index) return;
+
+    if(m_slots[index].newer != NoSlot || m_slots[index].older != NoSlot || m_oldestSlot == index) unlink(index);
+
+    Slot &slot = m_slots[index];
+    slot.older = m_newestSlot;
+    slot.newer = NoSlot;
+    if(m_newestSlot != NoSlot) m_slots[m_newestSlot].newer = index;
+    m_newestSlot = index;
+    if(m_oldestSlot == NoSlot) m_oldestSlot = index;
+}
+
+template<typename T>
+void ManagerBase<T>::unlink(std::uint32_t index)
+{
+    Slot &slot = m_slots[index];
+    if(slot.newer != NoSlot) m_slots[slot.newer].older = slot.older;
+    else if(m_newestSlot == index) m_newestSlot = slot.older;
+    if(slot.older != NoSlot) m_slots[slot.older].newer = slot.newer;
+    else if(m_oldestSlot == index) m_oldestSlot = slot.newer;
+    slot.newer = NoSlot;
+    slot.older = NoSlot;
+}
+
+template<typename T>
+void ManagerBase<T>::evict(std::uint32_t keep)
+{
+    if(m_statistics.memoryBudget == 0) return;
+
+    std::uint32_t index = m_oldestSlot;
+    while(m_statistics.memoryUsage > m_statistics.memoryBudget && index != NoSlot)
+    {
+        std::uint32_t newer = m_slots[index].newer;
+        if(index != keep && m_slots[index].referenceCount == 0)
+        {
+            erase(Map::find(*m_slots[index].key));
+            ++m_statistics.evictions;
+        }
+        index = newer;
+    }
+}
+
+template<typename T>
+void ManagerBase<T>::addReference(const Handle &handle)
+{
+    if(handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation) return;
+    ++m_slots[handle.index].referenceCount;
+}
+
+template<typename T>
+void ManagerBase<T>::removeReference(const Handle &handle)
+{
+    if(handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation) return;
+    if(--m_slots[handle.index].referenceCount == 0) evict(NoSlot);
+}
+
+template<typename T>
+typename ManagerBase<T>::Map::iterator ManagerBase<T>::lookup(std::string_view key)
+{
+    const std::string &buffer = lookupKey(key);
+    auto it = this->find(buffer);
+    if(it != this->end() || m_aliases.empty()) return it;
+
+    auto aliasIt = m_aliases.find(buffer);
+    if(aliasIt == m_aliases.end()) return it;
+    return this->find(aliasIt->second);
+}
+
+template<typename T>
+typename ManagerBase<T>::Map::const_iterator ManagerBase<T>::lookup(std::string_view key) const
+{
+    const std::string &buffer = lookupKey(key);
+    auto it = this->find(buffer);
+    if(it != this->end() || m_aliases.empty()) return it;
+
+    auto aliasIt = m_aliases.find(buffer);
+    if(aliasIt == m_aliases.end()) return it;
+    return this->find(aliasIt->second);
+}
+
+template<typename T>
+void ManagerBase<T>::removeAliasesOf(const std::string &key)
+{
+    for(auto it = m_aliases.begin(); it != m_aliases.end();)
+    {
+        if(it->second == key) it = m_aliases.erase(it);
+        else ++it;
+    }
+}
+
+template<typename T>
+bool ManagerBase<T>::moveToAlias(typename Map::iterator it)
+{
+    if(m_aliases.empty()) return false;
+
+    const std::string *heir = nullptr;
+    for(auto &alias : m_aliases)
+    {
+        if(alias.second == it->first && (!heir || alias.first < *heir)) heir = &alias.first;
+    }
+    if(!heir) return false;
+
+    std::string oldKey = it->first;
+    std::string newKey = *heir;
+    m_aliases.erase(newKey);
+    for(auto &alias : m_aliases)
+    {
+        if(alias.second == oldKey) alias.second = newKey;
+    }
+
+    // Changing the key of an extracted node keeps the resource and its key at the same address, so its slot stays valid
+    unindexKey(it->first);
+    auto node = Map::extract(it);
+    node.key() = newKey;
+    auto result = Map::insert(std::move(node));
+    indexKey(result.position->first);
+
+    onRename(oldKey, result.position->first, result.position->second);
+    return true;
+}
+
+template<typename T>
+const std::string& ManagerBase<T>::lookupKey(std::string_view key)
+{
+    // std::unordered_map only gets heterogeneous lookup in C++20, so the key is copied into a buffer that keeps its capacity between calls instead
+    static thread_local std::string buffer;
+    buffer.assign(key.data(), key.size());
+    return buffer;
+}
+
+template<typename T>
+void ManagerBase<T>::indexKey(const std::string &key)
+{
+    if(!m_aliases.empty()) m_aliases.erase(key);
+    if(!m_keyIndexBuilt) return;
+
+    m_sortedKeys.insert(std::lower_bound(m_sortedKeys.begin(), m_sortedKeys.end(), std::string_view(key)), key);
+    m_sortedReversedKeys.insert(std::lower_bound(m_sortedReversedKeys.begin(), m_sortedReversedKeys.end(), std::string_view(key), &ManagerBase<T>::isReverseLess), key);
+}
+
+template<typename T>
+void ManagerBase<T>::unindexKey(const std::string &key)
+{
+    if(!m_keyIndexBuilt) return;
+
+    // Keys are unique, so the first element that is not less than key is the key itself
+    m_sortedKeys.erase(std::lower_bound(m_sortedKeys.begin(), m_sortedKeys.end(), std::string_view(key)));
+    m_sortedReversedKeys.erase(std::lower_bound(m_sortedReversedKeys.begin(), m_sortedReversedKeys.end(), std::string_view(key), &ManagerBase<T>::isReverseLess));
+}
+
+template<typename T>
+void ManagerBase<T>::buildKeyIndex()
+{
+    m_sortedKeys.clear();
+    for(auto &p : *this)
+    {
+        m_sortedKeys.emplace_back(p.first);
+    }
+    m_sortedReversedKeys = m_sortedKeys;
+
+    std::sort(m_sortedKeys.begin(), m_sortedKeys.end());
+    std::sort(m_sortedReversedKeys.begin(), m_sortedReversedKeys.end(), &ManagerBase<T>::isReverseLess);
+    m_keyIndexBuilt = true;
+}
+
+template<typename T>
+bool ManagerBase<T>::isReverseLess(std::string_view left, std::string_view right)
+{
+    return std::lexicographical_compare(left.rbegin(), left.rend(), right.rbegin(), right.rend());
+}
+
 } // namespace sfex
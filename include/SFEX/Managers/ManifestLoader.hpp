@@ -0,0 +1,172 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_MANAGERS_MANIFEST_LOADER_HPP_
+#define _SFEX_MANAGERS_MANIFEST_LOADER_HPP_
+
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFEX/General/Multitype.hpp>
+#include <SFEX/General/WorkerPool.hpp>
+#include <SFEX/Managers/MusicManager.hpp>
+#include <SFEX/Managers/SoundManager.hpp>
+#include <SFEX/Managers/TextureManager.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sfex
+{
+
+/// @brief Loads the assets listed in a manifest into a TextureManager, a SoundManager and a MusicManager.
+/// A manifest is a map with the optional sections "textures", "sounds" and "music", each mapping keys to file paths:
+/// { "textures": { "player": "gfx/player.png" }, "sounds": { "jump": "sfx/jump.ogg" }, "music": { "theme": "music/theme.ogg" } }
+/// Files are sorted by path, so files of the same directory are read one after another, and split into a few runs that are read in parallel.
+/// Textures and sounds are decoded on a worker pool, while storing them in their managers happens in update on the thread that owns the OpenGL context.
+/// Musics are streamed by sf::Music, so they are only opened in update.
+class ManifestLoader
+{
+public:
+    /// @brief Construct a loader that stores assets in the given managers. The managers have to outlive the loader.
+    ManifestLoader(TextureManager &textures, SoundManager &sounds, MusicManager &music);
+    ManifestLoader(const ManifestLoader&) = delete;
+    ManifestLoader& operator=(const ManifestLoader&) = delete;
+
+    /// @brief Start loading every asset listed in a manifest. Can be called again to queue more assets.
+    /// @param manifest Manifest to load
+    /// @param directory Directory that relative paths are resolved against
+    /// @throws std::invalid_argument if the manifest is not a map, has an unknown section or lists a path that is not a string. Nothing is queued then.
+    void load(const Multitype &manifest, const std::string &directory="");
+
+    /// @brief Parse a JSON manifest file and start loading its assets. Relative paths are resolved against the directory of the manifest.
+    /// @param filename Path of the manifest file
+    /// @return True if the manifest could be read
+    /// @throws std::runtime_error on parse errors, std::invalid_argument on malformed manifests
+    bool loadFromFile(const std::string &filename);
+
+    /// @brief Store decoded assets in their managers. Call this once per frame on the thread that owns the OpenGL context.
+    /// @param maxAssets Maximum number of textures and sounds to store in this call
+    /// @return Number of assets that have been stored or have failed
+    std::size_t update(std::size_t maxAssets=4);
+
+    /// @brief Block until every queued asset has been loaded. The calling thread helps decoding while it waits.
+    void finish();
+
+    /// @brief Get the fraction of the queued bytes whose assets are done, between 0 and 1
+    float getProgress() const;
+
+    /// @brief Get the file size of the assets that have been stored or have failed
+    std::size_t getLoadedBytes() const;
+
+    /// @brief Get the file size of every queued texture and sound. Musics are not read up front, so they do not count.
+    std::size_t getTotalBytes() const;
+
+    /// @brief Get the number of assets that have neither been stored nor failed yet
+    std::size_t getPendingCount() const;
+
+    /// @brief Returns true if every queued asset has been stored or has failed
+    bool isDone() const;
+
+    /// @brief Get the keys of the assets that could not be loaded
+    const std::vector<std::string>& getFailedKeys() const;
+
+    /// @brief Read files at most this many at a time. Use 1 for spinning disks. Takes effect with the next load.
+    void setMaxParallelReads(std::size_t maxReads);
+
+    /// @brief Read and decode on the given pool instead of a pool owned by the loader. The pool has to outlive the loads.
+    void setWorkerPool(WorkerPool &pool);
+
+private:
+    enum class AssetType
+    {
+        Texture,
+        Sound,
+        Music,
+    };
+
+    struct Request
+    {
+        AssetType type;
+        std::string key;
+        std::string filename;
+        std::size_t size;
+    };
+
+    /// @brief Asset that has been read and decoded by a worker
+    struct Decoded
+    {
+        AssetType type;
+        std::string key;
+        std::size_t size;
+        bool failed = false;
+        sf::Image image{};
+        std::vector<sf::Int16> samples{};
+        unsigned int channelCount = 0;
+        unsigned int sampleRate = 0;
+    };
+
+    /// @brief Decoded assets waiting for the owning thread. Shared with the worker tasks, so they can finish after the loader is gone.
+    struct DecodedQueue
+    {
+        std::mutex mutex;
+        std::vector<Decoded> assets;
+    };
+
+    /// @brief Read the file at index of a run, queue the read of the next file and decode this one
+    static void readRun(WorkerPool &pool, const std::shared_ptr<DecodedQueue> &queue, const std::shared_ptr<std::vector<Request>> &run, std::size_t index);
+
+    /// @brief Decode the content of a file
+    static void decode(Decoded &asset, const std::vector<char> &data);
+
+    /// @brief Store a decoded asset in its manager
+    void store(Decoded &asset);
+
+    /// @brief Account an asset that has been stored or has failed
+    void finishAsset(const std::string &key, std::size_t size, bool failed);
+
+    /// @brief Get the pool used for reading and decoding, creating one if none has been set
+    WorkerPool& getWorkerPool();
+
+    TextureManager &m_textures;
+    SoundManager &m_sounds;
+    MusicManager &m_music;
+
+    std::shared_ptr<DecodedQueue> m_queue;
+    std::vector<Request> m_musicRequests;
+    std::vector<std::string> m_failedKeys;
+    std::size_t m_loadedBytes = 0;
+    std::size_t m_totalBytes = 0;
+    std::size_t m_pendingCount = 0;
+    std::size_t m_maxParallelReads = 4;
+
+    std::shared_ptr<WorkerPool> m_ownedPool;
+    WorkerPool *m_pool = nullptr;
+};
+
+} // namespace sfex
+
+
+#endif // !_SFEX_MANAGERS_MANIFEST_LOADER_HPP_
\ No newline at end of file
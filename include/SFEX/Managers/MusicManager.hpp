@@ -25,62 +25,107 @@
 #ifndef _SFEX_MANAGERS_MUSICMANAGER_HPP_
 #define _SFEX_MANAGERS_MUSICMANAGER_HPP_
 
+#include <deque>
+#include <memory>
 #include <unordered_map>
 #include <string>
 #include <SFML/Audio/Music.hpp>
+#include <SFEX/General/Pack.hpp>
 #include <SFEX/Managers/ManagerBase.hpp>
 
 namespace sfex
 {
 
 /// @brief Simple music manager class that stores musics in a hashmap and can play them. Inherits from ManagerBase<sf::Music>
+/// Every source is parsed once, and musics stay open while they are stored. Opening a key again reopens its sf::Music in place, so references and handles to it stay valid, but stops it. Queued musics start from their open state when the previous one ends.
 class MusicManager : public ManagerBase<sf::Music>
 {
 public:
 
-    /// @brief Open a music from an audio file
+    /// @brief Open a music from an audio file. A failed open keeps the music stored under key.
     /// @param key Unique identifier of music
     /// @param filename Path of the file to load
     /// @return True if loading was successfull
     bool openFromFile(const std::string &key, const std::string &filename);
 
-    /// @brief Open a music from memory
+    /// @brief Open a music from memory. The data has to stay valid while the music is stored. A failed open keeps the music stored under key.
     /// @param key Unique identifier of muic
     /// @param data Pointer to data on the memory
     /// @param size Size of the data on the memory
     /// @return True if loading was successfull
     bool openFromMemory(const std::string &key, const void *data, std::size_t size);
 
-    /// @brief Open a music from stream
+    /// @brief Open a music from stream. The stream has to stay valid while the music is stored. A failed open keeps the music stored under key.
     /// @param key Unique identifier of music
     /// @param stream Source stream to read from
     /// @return True if loading was successfull
     bool openFromStream(const std::string &key, sf::InputStream &stream);
 
-    /// @brief Play music corresponding to key
+    /// @brief Open a music from an entry of a pack. The manager keeps the stream of the entry, but the pack has to stay open while the music is stored. A failed open keeps the music stored under key.
     /// @param key Unique identifier of music
-    void play(const std::string &key);
+    /// @param pack Pack to read from
+    /// @param name Name of the entry
+    /// @return True if loading was successfull
+    bool openFromPack(const std::string &key, const Pack &pack, std::string_view name);
+
+    /// @brief Play music corresponding to key. It becomes the current music that queued musics follow.
+    /// @param key Unique identifier of music
+    void play(std::string_view key);
+
+    /// @brief Queue a music to start when the current one ends. Queued musics are already open and rewound, so starting them only starts the stream.
+    /// Without a current music the queued music starts on the next update.
+    /// @param key Unique identifier of music
+    void queue(std::string_view key);
+
+    /// @brief Remove every queued music
+    void clearQueue();
+
+    /// @brief Get the number of queued musics
+    std::size_t getQueueSize() const;
+
+    /// @brief Get the key of the current music, empty if there is none
+    const std::string& getCurrent() const;
+
+    /// @brief Start the next queued music when the current one has ended. Call this once per frame, a queued music starts at most one frame after the previous one ends.
+    void update();
 
     /// @brief Pause music corresponding to key
     /// @param key Unique identifier of music
-    void pause(const std::string &key);
+    void pause(std::string_view key);
 
     /// @brief Stop music corresponding to key
     /// @param key Unique identifier of music
-    void stop(const std::string &key);
+    void stop(std::string_view key);
 
     /// @brief Get the total duration of music corresponding to key
     /// @param key Unique identifier of the music
     /// @return Duration of the music
-    sf::Time getDuration(const std::string &key);
+    sf::Time getDuration(std::string_view key);
 
     /// @brief Get the playing status of the music corresponding to key
     /// @param key Unique identifier of the music
     /// @return Duration of the music
-    sf::Music::Status getStatus(const std::string &key);
+    sf::Music::Status getStatus(std::string_view key);
+
+protected:
+    /// @brief Stops a music that is removed and drops its pack stream
+    void onErase(const std::string &key, sf::Music &music) override;
+
+    /// @brief Moves the pack stream of a music to its new key
+    void onRename(const std::string &oldKey, const std::string &newKey, sf::Music &music) override;
 
 private:
-    
+    /// @brief Open a music with open and store it under key, keeping the stored music if that fails.
+    /// A stored music is only reopened once the source has been opened successfully on a separate music.
+    /// @return True if loading was successfull
+    template<typename Open>
+    bool openMusic(const std::string &key, Open&& open);
+
+    /// @brief Streams of the musics opened from packs. sf::Music reads from its stream while playing.
+    std::unordered_map<std::string, std::unique_ptr<PackStream>> m_streams;
+
+    std::string m_current;
+    std::deque<std::string> m_queue;
 };
 
 } // namespace sfex
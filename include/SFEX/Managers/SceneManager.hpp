@@ -43,7 +43,7 @@ public:
 
     /// @brief Set active scene of the scene manager. It does nothing if key is not valid.
     /// @param key Unique identifier of key
-    void setActiveScene(const std::string &key);
+    void setActiveScene(std::string_view key);
     
     /// @brief Get a shared pointer to the active scene. 
     /// @return A shared pointer to the active scene
@@ -25,19 +25,48 @@
 #ifndef _SFEX_MANAGERS_SOUNDMANAGER_HPP_
 #define _SFEX_MANAGERS_SOUNDMANAGER_HPP_
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
+#include <SFEX/General/FileWatcher.hpp>
+#include <SFEX/General/Mixer.hpp>
+#include <SFEX/General/Pack.hpp>
+#include <SFEX/General/WorkerPool.hpp>
 #include <SFEX/Numeric/Vector3.hpp>
+#include <SFEX/Managers/AsyncLoad.hpp>
 #include <SFEX/Managers/ManagerBase.hpp>
 
 namespace sfex
 {
 
 /// @brief Simple sound manager class that stores sounds and their buffers into seperate hashmaps. Inherits from ManagerBase<sf::Sound>
+/// Every loaded sound counts sample count * 2 bytes towards the memory budget.
+/// Loaded content is fingerprinted with xxHash, and sounds loaded from identical content share one buffer, which counts towards the budget only once until the last sound that plays it is removed.
+/// Sounds are played on a fixed pool of voices shared by all keys, so a key can overlap with itself and the number of OpenAL sources stays bounded.
+/// The sf::Sound stored under a key holds the buffer and the settings, e.g. volume, pitch and position, that are copied to a voice when the key is played.
+/// Sound files can be decoded asynchronously on a worker pool, with plays of a key that is still loading either queued or ignored, and preloaded in sets per scene.
+/// With hot reloading, changed sound files are decoded again on a worker pool and processReloads loads the samples into the buffers the sounds already play.
 class SoundManager : public ManagerBase<sf::Sound>
 {
 public:
+    SoundManager() = default;
+    SoundManager(SoundManager &&other) = default;
+    SoundManager& operator=(SoundManager &&other) = default;
+
+    /// @brief Stops the voices started with mix before the buffers they play are destroyed
+    ~SoundManager();
+
+    /// @brief Copy the sounds and their buffers. Watched files stay with the original manager.
+    SoundManager(const SoundManager &other);
+
+    /// @brief Copy the sounds and their buffers. Watched files stay with the original manager.
+    SoundManager& operator=(const SoundManager &other);
 
     /// @brief Loads sf::SoundBuffer from file then creates a sf::Sound from it
     /// @param key Unique identifier of sound
@@ -58,6 +87,13 @@ public:
     /// @return True if loading was successfull
     bool loadFromStream(const std::string &key, sf::InputStream &stream);
 
+    /// @brief Loads sf::SoundBuffer from an entry of a pack then creates a sf::Sound from it
+    /// @param key Unique identifier of sound
+    /// @param pack Pack to read from
+    /// @param name Name of the entry
+    /// @return True if loading was successfull
+    bool loadFromPack(const std::string &key, const Pack &pack, std::string_view name);
+
     /// @brief Load the sound buffer from an array of audio samples then create an sf::Sound to 
     /// @param key Unique identifier of sound
     /// @param sample Pointer to the array of samples in memory
@@ -67,31 +103,260 @@ public:
     /// @return True if loading was successfull
     bool loadFromSamples(const std::string &key, const sf::Int16 *sample, sf::Uint64 sampleCount, unsigned int channelCount, unsigned int sampleRate);
 
-    /// @brief Play sound corresponding to key
+    /// @brief Decode a sound file on a worker and queue its buffer. The sound becomes available after processUploads has stored it.
+    /// Loading key again, synchronously or asynchronously, supersedes a load that is still running.
     /// @param key Unique identifier of sound
-    void play(const std::string &key);
+    /// @param filename Path of the file to load
+    /// @return Handle to query the state of the load
+    AsyncLoad loadAsync(const std::string &key, const std::string &filename);
+
+    /// @brief Store sounds that have been decoded by loadAsync and start their queued plays. Call this once per frame.
+    /// @param maxUploads Maximum number of sounds to store in this call
+    /// @return Number of sounds that have been stored
+    std::size_t processUploads(std::size_t maxUploads=1);
 
-    /// @brief Pause sound corresponding to key
+    /// @brief Get the number of decoded sounds that wait for processUploads
+    std::size_t getPendingUploadCount() const;
+
+    /// @brief Returns true if key is being loaded by loadAsync
+    bool isLoading(std::string_view key) const;
+
+    /// @brief Choose what play does with a key that is still being loaded by loadAsync and has no sound yet
+    /// @param queue True to play the sound once it has been stored, false to ignore the play. Defaults to true.
+    void setQueuePendingPlays(bool queue);
+
+    /// @brief Add a sound to the preload set of a scene
+    /// @param scene Name of the scene
     /// @param key Unique identifier of sound
-    void pause(const std::string &key);
+    /// @param filename Path of the file to load
+    void addToPreloadSet(const std::string &scene, const std::string &key, const std::string &filename);
 
-    /// @brief Stop sound corresponding to key
+    /// @brief Start loading every sound of the preload set of a scene that is neither stored nor being loaded
+    /// @param scene Name of the scene
+    /// @return Number of loads that have been started
+    std::size_t preload(const std::string &scene);
+
+    /// @brief Returns true while sounds of the preload set of a scene are being loaded
+    bool isPreloading(const std::string &scene) const;
+
+    /// @brief Remove the sounds of the preload set of a scene, e.g. after switching to the next scene
+    /// @param scene Name of the scene
+    /// @param nextScene Name of a scene whose preload set keeps its sounds
+    void unloadPreloadSet(const std::string &scene, const std::string &nextScene="");
+
+    /// @brief Play sound corresponding to key. Resumes the voices of key if they are paused, otherwise starts a new voice.
+    /// A key at its polyphony limit restarts its oldest voice. When every voice is busy, the quietest one is stolen, and of equally quiet ones the oldest.
     /// @param key Unique identifier of sound
-    void stop(const std::string &key);
+    void play(std::string_view key);
+
+    /// @brief Pause every voice of the sound corresponding to key
+    /// @param key Unique identifier of sound
+    void pause(std::string_view key);
+
+    /// @brief Stop every voice of the sound corresponding to key
+    /// @param key Unique identifier of sound
+    void stop(std::string_view key);
+
+    /// @brief Play the sound corresponding to key on a software mixer instead of a voice of the manager, e.g. to play many copies of it through one MixerStream.
+    /// The gain, pitch and loop of the voice are taken from the sf::Sound stored under key. The voice plays the buffer of key without copying it,
+    /// so the manager stops it when that buffer is destroyed or reloaded, e.g. after the last key that uses it has been removed or evicted.
+    /// @param mixer Mixer to play on. It has to outlive the manager.
+    /// @param key Unique identifier of sound
+    /// @param bus Bus of the voice
+    /// @return Id of the voice, 0 if key has no buffer or every voice of the mixer is playing
+    Mixer::VoiceId mix(Mixer &mixer, std::string_view key, Mixer::Bus bus=Mixer::Bus::Sfx);
+
+    /// @brief Set the number of voices sounds are played on. Stops every voice. 0 plays the sf::Sound stored under a key itself, which restarts it on every play.
+    /// Voices are created on the first play. Defaults to 32.
+    void setVoiceCount(std::size_t count);
+
+    /// @brief Get the number of voices sounds are played on
+    std::size_t getVoiceCount() const;
+
+    /// @brief Get the number of voices that are playing or paused
+    std::size_t getActiveVoiceCount() const;
+
+    /// @brief Limit the number of voices a key plays on at the same time
+    /// @param key Unique identifier of sound
+    /// @param limit Maximum number of voices, 0 for no limit
+    void setPolyphony(const std::string &key, std::size_t limit);
+
+    /// @brief Get the number of voices a key can play on at the same time, 0 if it is not limited
+    std::size_t getPolyphony(std::string_view key) const;
+
+    /// @brief Set the polyphony limit of keys that have none of their own. Defaults to 4.
+    void setDefaultPolyphony(std::size_t limit);
 
     /// @brief Get the total duration of sound corresponding to key
     /// @param key Unique identifier of the sound
     /// @return Duration of the sound
-    sf::Time getDuration(const std::string &key);
+    sf::Time getDuration(std::string_view key);
 
     /// @brief Get the playing status of the sound corresponding to key
     /// @param key Unique identifier of the sound
     /// @return Duration of the sound
-    sf::Sound::Status getStatus(const std::string &key);
+    sf::Sound::Status getStatus(std::string_view key);
+
+    /// @brief Watch the files of keys loaded from now on with loadFromFile, and reload a key when its file changes.
+    /// Keys loaded while hot reloading get their own buffer instead of sharing one with identical content, so a changed file only affects its own keys.
+    /// Disabling hot reloading stops watching every file.
+    void setHotReload(bool enable);
+
+    /// @brief Returns true if the files of loaded keys are watched
+    bool isHotReloading() const;
+
+    /// @brief Start decoding changed files on the worker pool and load the ones that have been decoded into the buffers of their sounds, so the sf::Sound objects stay valid.
+    /// Call this once per frame. A file that cannot be decoded, e.g. because it is still being written, leaves its sound unchanged.
+    /// @param maxUploads Maximum number of buffers to load in this call
+    /// @return Number of sounds that have been reloaded
+    std::size_t processReloads(std::size_t maxUploads=1);
+
+    /// @brief Decode changed files on the given pool instead of a pool owned by the manager. The pool has to outlive the decodes.
+    void setWorkerPool(WorkerPool &pool);
+
+    /// @brief Get the bytes that sounds sharing a buffer through identical content would occupy with their own buffers
+    std::size_t getDeduplicatedMemory() const;
+
+protected:
+    /// @brief Drops the buffer of a sound that is removed
+    void onErase(const std::string &key, sf::Sound &sound) override;
+
+    /// @brief Moves the buffer of a sound to its new key
+    void onRename(const std::string &oldKey, const std::string &newKey, sf::Sound &sound) override;
 
 private:
-    /// @brief Hashmap to store all soundbuffers
-    std::unordered_map<std::string, sf::SoundBuffer> m_buffers; 
+    /// @brief Buffer decoded from one content, with the number of sounds that play it
+    struct SharedBuffer
+    {
+        sf::SoundBuffer buffer;
+        std::size_t users = 0;
+        std::string owner; ///< Key whose budget the buffer counts towards
+    };
+
+    /// @brief Samples of a sound file that have been decoded on a worker
+    struct Decoded
+    {
+        std::string key;
+        std::uint64_t content;
+        std::vector<sf::Int16> samples;
+        unsigned int channelCount;
+        unsigned int sampleRate;
+        AsyncLoad load;
+    };
+
+    /// @brief Decoded sounds waiting for the owning thread. Shared with the decoding tasks, so they can finish after the manager has been moved.
+    struct DecodedQueue
+    {
+        mutable std::mutex mutex;
+        std::vector<Decoded> sounds;
+    };
+
+    /// @brief Sound that is being loaded by loadAsync
+    struct PendingLoad
+    {
+        std::string filename;
+        AsyncLoad load;
+        bool playQueued = false;
+    };
+
+    /// @brief File a key has been loaded from while hot reloading
+    struct ReloadSource
+    {
+        std::string filename;
+        std::string watchPath;
+        AsyncLoad load;
+    };
+
+    /// @brief Pooled sf::Sound that plays the buffer of a key
+    struct Voice
+    {
+        sf::Sound sound;
+        const sf::Sound *source = nullptr;
+        std::uint64_t order = 0;
+    };
+
+    /// @brief Voice started by mix, together with the buffer it plays
+    struct MixedVoice
+    {
+        Mixer *mixer;
+        Mixer::VoiceId id;
+        const sf::SoundBuffer *buffer;
+    };
+
+    /// @brief Voices started by mix. Assigning stops the voices that are replaced, before the buffers they play are.
+    struct MixedVoices
+    {
+        std::vector<MixedVoice> voices;
+
+        MixedVoices() = default;
+        MixedVoices(const MixedVoices &other) = delete;
+        MixedVoices(MixedVoices &&other) noexcept;
+        MixedVoices& operator=(const MixedVoices &other) = delete;
+        MixedVoices& operator=(MixedVoices &&other) noexcept;
+
+        /// @brief Stop the voices that play buffer
+        void stop(const sf::SoundBuffer &buffer);
+
+        /// @brief Stop every voice
+        void stopAll();
+    };
+
+    /// @brief Pick the voice a new play of source uses
+    Voice& findVoice(const sf::Sound *source, std::size_t polyphony);
+
+    /// @brief Stop the voices that play source and detach them from its buffer
+    void releaseVoices(const sf::Sound *source);
+
+    /// @brief Get the gain a sound is heard with, from its volume and its distance to the listener
+    static float getAudibleGain(const sf::Sound &sound);
+
+    /// @brief Get the pool used to decode files, creating one if none has been set
+    WorkerPool& getWorkerPool();
+
+    /// @brief Decode a sound file on a worker and queue the samples on queue
+    void decodeAsync(const std::shared_ptr<DecodedQueue> &queue, const std::string &key, const std::string &filename, AsyncLoad load, Priority priority);
+
+    /// @brief Watch the file key has been loaded from, if hot reloading is enabled
+    void watchFile(const std::string &key, const std::string &filename);
+
+    /// @brief Stop watching the file key has been loaded from
+    void unwatchFile(const std::string &key);
+
+    /// @brief Create the sound of key from the buffer with the given content, decoding the buffer with load if no sound uses that content yet
+    /// @return True if loading was successfull
+    template<typename Load>
+    bool loadBuffer(const std::string &key, std::uint64_t content, Load&& load);
+
+    /// @brief Drop the use of the buffer with the given content by key, destroying it after the last one. The size moves to another user if key was charged for it.
+    void releaseBuffer(const std::string &key, std::uint64_t content);
+
+    // Declared before the buffers, so move assignment stops the voices before the buffers they play are replaced
+    MixedVoices m_mixedVoices;
+
+    /// @brief Hashmap to store all soundbuffers by the hash of their content
+    std::unordered_map<std::uint64_t, SharedBuffer> m_buffers;
+
+    /// @brief Content hash of the buffer of every sound
+    std::unordered_map<std::string, std::uint64_t> m_contentOfKey;
+
+    std::shared_ptr<DecodedQueue> m_uploadQueue;
+    std::unordered_map<std::string, PendingLoad> m_pendingLoads;
+    bool m_queuePendingPlays = true;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> m_preloadSets;
+
+    // Declared after the buffers, so the voices let go of them first
+    std::vector<Voice> m_voices;
+    std::size_t m_voiceCount = 32;
+    std::uint64_t m_playCount = 0;
+    std::unordered_map<std::string, std::size_t> m_polyphony;
+    std::size_t m_defaultPolyphony = 4;
+
+    std::unique_ptr<FileWatcher> m_watcher;
+    std::unordered_map<std::string, ReloadSource> m_reloadSources;
+    std::shared_ptr<DecodedQueue> m_reloadQueue;
+
+    std::shared_ptr<WorkerPool> m_ownedPool;
+    WorkerPool *m_pool = nullptr;
 };
 
 } // namespace sfex
@@ -48,6 +48,12 @@ public:
     /// @param texture Texture of the sprite corresponding to key
     void setTexture(const std::string &key, const sf::Texture &texture);
 
+    /// @brief Creates a new sprite that shows a part of a texture or modifies an existing one.
+    /// @param key Key value
+    /// @param texture Texture of the sprite corresponding to key
+    /// @param rect Part of the texture to show, for example the rect of an sfex::TextureAtlas::Region
+    void setTexture(const std::string &key, const sf::Texture &texture, const sf::IntRect &rect);
+
 private:
 
 };
@@ -25,16 +25,46 @@
 #ifndef _SFEX_GRAPHICS_TEXTURE_MANAGER_HPP_
 #define _SFEX_GRAPHICS_TEXTURE_MANAGER_HPP_
 
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFEX/General/FileWatcher.hpp>
+#include <SFEX/General/Pack.hpp>
+#include <SFEX/General/WorkerPool.hpp>
+#include <SFEX/Graphics/ImageCache.hpp>
+#include <SFEX/Graphics/ImagePyramid.hpp>
+#include <SFEX/Graphics/TextureAtlas.hpp>
+#include <SFEX/Managers/AsyncLoad.hpp>
 #include <SFEX/Managers/ManagerBase.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace sfex
 {
 
 /// @brief Loads textures from various resources and stores them in a hashmap. Inherits from sfex::ManagerBase<sf::Texture>
+/// Every loaded texture counts width * height * 4 bytes towards the memory budget.
+/// Loaded content is fingerprinted with xxHash. With deduplication enabled, a key whose content has already been loaded becomes an alias of the existing texture instead of getting a copy.
+/// Textures can also be loaded asynchronously: files are decoded on a worker pool, while the upload to the GPU happens in processUploads on the thread that owns the OpenGL context.
+/// Textures can be loaded at a reduced resolution, or at the smallest resolution that is still sharp at a given size, from a box filtered pyramid built on the CPU.
+/// Decoded pixels of texture files can be kept in a cache directory, so later runs map and upload them instead of decoding the files again.
+/// In streaming mode a key shows a small placeholder right away, and processStreaming loads the requested textures by priority and swaps them into the same sf::Texture object.
+/// With hot reloading, changed texture files are decoded again on the worker pool and processReloads uploads them into the sf::Texture objects that already hold them.
 class TextureManager : public ManagerBase<sf::Texture>
 {
 public:
+    TextureManager();
+    TextureManager(TextureManager &&other) = default;
+    TextureManager& operator=(TextureManager &&other) = default;
+
+    /// @brief Copy the textures. Pending asynchronous loads and watched files stay with the original manager.
+    TextureManager(const TextureManager &other);
+
+    /// @brief Copy the textures. Pending asynchronous loads and watched files stay with the original manager.
+    TextureManager& operator=(const TextureManager &other);
 
     /// @brief Creates an empty texture
     /// @param key Unique identifier of texture
@@ -72,8 +102,250 @@ public:
     /// @return True if loading was successfull
     bool loadFromImage(const std::string &key, const sf::Image &image, const sf::IntRect &area=sf::IntRect());
 
+    /// @brief Load texture from an entry of a pack
+    /// @param key Unique identifier of texture
+    /// @param pack Pack to read from
+    /// @param name Name of the entry
+    /// @param area Area of the texture to load
+    /// @return True if loading was successfull
+    bool loadFromPack(const std::string &key, const Pack &pack, std::string_view name, const sf::IntRect &area=sf::IntRect());
+
+    /// @brief Load the smallest level of the image pyramid that is at least as large as size, so small sprites do not sample huge textures
+    /// @param key Unique identifier of texture
+    /// @param image Image to load into the texture
+    /// @param size Size the texture is drawn at
+    /// @return True if loading was successfull
+    bool loadForSize(const std::string &key, const sf::Image &image, const sf::Vector2u &size);
+
+    /// @brief Load the smallest level of the image pyramid of a file that is at least as large as size
+    /// @param key Unique identifier of texture
+    /// @param filename Path of the texture file to load
+    /// @param size Size the texture is drawn at
+    /// @return True if loading was successfull
+    bool loadForSize(const std::string &key, const std::string &filename, const sf::Vector2u &size);
+
+    /// @brief Load every page of an atlas. Page i is stored under sfex::TextureAtlas::getPageKey(prefix, i).
+    /// @param prefix Prefix of the page keys
+    /// @param atlas Atlas to load the pages of
+    /// @return True if loading was successfull
+    bool loadFromAtlas(const std::string &prefix, const TextureAtlas &atlas);
+
+    /// @brief Decode a texture file on a worker and queue its upload. The texture becomes available after processUploads has uploaded it.
+    /// @param key Unique identifier of texture
+    /// @param filename Path of the texture file to load
+    /// @param area Area of the texture to load
+    /// @return Handle to query the state of the load
+    AsyncLoad loadAsync(const std::string &key, const std::string &filename, const sf::IntRect &area=sf::IntRect());
+
+    /// @brief Upload textures that have been decoded by loadAsync. Call this once per frame on the thread that owns the OpenGL context.
+    /// @param maxUploads Maximum number of textures to upload in this call
+    /// @return Number of textures that have been uploaded
+    std::size_t processUploads(std::size_t maxUploads=1);
+
+    /// @brief Get the number of decoded textures that wait for processUploads
+    std::size_t getPendingUploadCount() const;
+
+    /// @brief Get the texture of key, requesting it in streaming mode if it is not stored. A requested key holds a copy of the placeholder until processStreaming has swapped in the full texture.
+    /// Requesting a key that is still being streamed updates its priority. Streamed textures do not share content with other keys.
+    /// @param key Unique identifier of texture
+    /// @param filename Path of the texture file to load
+    /// @param priority Requests with lower values are loaded first, e.g. the distance to the camera
+    /// @return The stored texture, which is the placeholder while the load is pending
+    const sf::Texture& stream(const std::string &key, const std::string &filename, float priority=0.f);
+
+    /// @brief Start loading requested textures in priority order and swap decoded ones in. Call this once per frame on the thread that owns the OpenGL context.
+    /// @return Number of textures that have been swapped in
+    std::size_t processStreaming();
+
+    /// @brief Returns true if key shows the placeholder while its texture is being streamed
+    bool isStreaming(const std::string &key) const;
+
+    /// @brief Get the number of streamed textures that are being decoded or wait to be swapped in
+    std::size_t getStreamingLoadCount() const;
+
+    /// @brief Bound the work of streaming
+    /// @param maxLoads Maximum number of textures that are decoded or wait to be swapped in at the same time
+    /// @param maxUploadBytes Maximum number of pixel bytes processStreaming uploads per call. A texture larger than this is uploaded on its own.
+    void setStreamingLimits(std::size_t maxLoads, std::size_t maxUploadBytes);
+
+    /// @brief Set the image that streamed keys show until their texture has been loaded. Defaults to a 2x2 grey image.
+    void setPlaceholder(const sf::Image &image);
+
+    /// @brief Generate mipmaps with sf::Texture::generateMipmap for every texture loaded from now on, so heavily downscaled sprites do not shimmer
+    void setMipmapping(bool generate);
+
+    /// @brief Returns true if mipmaps are generated for loaded textures
+    bool isMipmapping() const;
+
+    /// @brief Load textures from now on at 1 / 2^level of their resolution, e.g. 1 for half the width and height on low-spec profiles. 0 loads the full resolution.
+    /// The reduction uses the worker pool set with setWorkerPool for large images, and happens on the workers for asynchronous loads.
+    void setResolutionLevel(unsigned int level);
+
+    /// @brief Get the level textures are loaded at
+    unsigned int getResolutionLevel() const;
+
+    /// @brief Keep the decoded pixels of texture files in directory. loadFromFile, loadAsync and stream upload cached pixels directly, and decode and cache the file when it has no valid entry.
+    /// @param directory Directory of the cache files, an empty directory disables the cache
+    /// @param compress Store the pixels LZ4 compressed, trading decompression time for disk space
+    void setCacheDirectory(const std::string &directory, bool compress=false);
+
+    /// @brief Get the cache of decoded texture files
+    const ImageCache& getImageCache() const;
+
+    /// @brief Watch the files of keys loaded from now on with loadFromFile, loadAsync or stream, and reload a key when its file changes.
+    /// Keys loaded while hot reloading get their own texture instead of sharing one with identical content, so a changed file only affects its own keys.
+    /// Disabling hot reloading stops watching every file.
+    void setHotReload(bool enable);
+
+    /// @brief Returns true if the files of loaded keys are watched
+    bool isHotReloading() const;
+
+    /// @brief Start decoding changed files on the worker pool and upload the ones that have been decoded into the textures that hold them, so sprites keep referring to the same sf::Texture.
+    /// Call this once per frame on the thread that owns the OpenGL context. A file that cannot be decoded, e.g. because it is still being written, leaves its texture unchanged.
+    /// @param maxUploads Maximum number of textures to upload in this call
+    /// @return Number of textures that have been reloaded
+    std::size_t processReloads(std::size_t maxUploads=1);
+
+    /// @brief Decode asynchronous loads on the given pool instead of a pool owned by the manager. The pool has to outlive the loads.
+    void setWorkerPool(WorkerPool &pool);
+
+    /// @brief Let new keys whose content has already been loaded become aliases of the existing texture instead of getting a copy. Disabled by default.
+    /// Aliases resolve through get, contains, acquire and operator[], but not through at, find, count, iteration, keys() or filter(), see ManagerBase::addAlias.
+    void setDeduplication(bool enable);
+
+    /// @brief Returns true if new keys with identical content share one texture
+    bool isDeduplicating() const;
+
+    /// @brief Get the bytes that keys sharing a texture through identical content would occupy with their own copies
+    std::size_t getDeduplicatedMemory() const;
+
+protected:
+    /// @brief Forgets the content of a texture that is removed
+    void onErase(const std::string &key, sf::Texture &texture) override;
+
+    /// @brief Moves the content of a texture to its new key
+    void onRename(const std::string &oldKey, const std::string &newKey, sf::Texture &texture) override;
+
 private:
+    struct Upload
+    {
+        std::string key;
+        sf::Image image;
+        sf::IntRect area;
+        AsyncLoad load;
+        std::string filename;
+        sf::IntRect fileArea;
+        std::uint64_t content; ///< Content key of the file, hashed while decoding
+    };
+
+    /// @brief Decoded images waiting for the owning thread. Shared with the decoding tasks, so they can finish after the manager has been moved.
+    struct UploadQueue
+    {
+        mutable std::mutex mutex;
+        std::vector<Upload> uploads;
+    };
+
+    /// @brief Texture that has been requested with stream
+    struct StreamRequest
+    {
+        std::string filename;
+        float priority;
+        AsyncLoad load;
+    };
+
+    /// @brief File a key has been loaded from while hot reloading
+    struct ReloadSource
+    {
+        std::string filename;
+        std::string watchPath;
+        sf::IntRect area;
+        AsyncLoad load;
+    };
+
+    /// @brief Get the pool used by loadAsync, creating one if none has been set
+    WorkerPool& getWorkerPool();
+
+    /// @brief Decode a texture file on a worker and queue the image on queue
+    void decodeAsync(const std::shared_ptr<UploadQueue> &queue, const std::string &key, const std::string &filename, const sf::IntRect &area, AsyncLoad load, Priority priority);
+
+    /// @brief Swap decoded streamed textures in, the most urgent first, until the upload budget is spent
+    std::size_t uploadStreamed();
+
+    /// @brief Start decoding the most urgent requests until the load limit is reached
+    void startStreamed();
+
+    /// @brief Get the decoded image of a file from the cache, or decode the file and cache it
+    /// @param contentHash Receives the xxHash64 of the file
+    static bool decodeFile(const ImageCache &cache, const std::string &filename, sf::Image &image, std::uint64_t &contentHash);
+
+    /// @brief Load a texture from decoded pixels of a file that hashes to contentHash
+    bool loadDecoded(const std::string &key, std::uint64_t contentHash, const Vec2u &size, const std::uint8_t *pixels, const sf::IntRect &area);
+
+    /// @brief Store an image under key at the resolution level of the manager
+    /// @param content Content key to share the texture by, or nullptr to hash the pixels
+    bool loadReduced(const std::string &key, const sf::Image &image, const sf::IntRect &area, const std::uint64_t *content);
+
+    /// @brief Store an image under key at the resolution it has
+    /// @param content Content key to share the texture by, or nullptr to hash the pixels
+    bool storeImage(const std::string &key, const sf::Image &image, const sf::IntRect &area, const std::uint64_t *content);
+
+    /// @brief Build the pyramid of the given area of an image
+    /// @return False if the area is empty
+    static bool buildPyramid(const sf::Image &image, const sf::IntRect &area, std::size_t levelCount, WorkerPool *pool, ImagePyramid &pyramid);
+
+    /// @brief Reduce the given area of an image by level halvings, or as many as its size allows
+    /// @return False if the area is empty
+    static bool reduceImage(const sf::Image &image, const sf::IntRect &area, unsigned int level, WorkerPool *pool, sf::Image &reduced);
+
+    /// @brief Watch the file key has been loaded from, if hot reloading is enabled
+    void watchFile(const std::string &key, const std::string &filename, const sf::IntRect &area);
+
+    /// @brief Stop watching the file key has been loaded from
+    void unwatchFile(const std::string &key);
+
+    /// @brief Account the size of a texture that has just been loaded
+    void updateResourceSize(const std::string &key);
+
+    /// @brief Make a new key an alias of the texture that has been loaded from the same content, if there is one. A key that holds its own texture is not turned into an alias.
+    /// @return True if key refers to a texture with that content now
+    bool shareContent(const std::string &key, std::uint64_t content);
+
+    /// @brief Store a newly loaded texture under key. Aliases of the previous texture under key keep referring to it.
+    /// @param content Hash of the content the texture has been loaded from, or nullptr if it has not been loaded from content
+    void store(const std::string &key, sf::Texture &texture, const std::uint64_t *content);
+
+    /// @brief Returns true if another key is an alias of the texture stored under key
+    bool hasAliases(const std::string &key) const;
+
+    /// @brief Forget the content of the texture stored under key
+    void forgetContent(const std::string &key);
+
+    std::unordered_map<std::uint64_t, std::string> m_keyOfContent;
+    std::unordered_map<std::string, std::uint64_t> m_contentOfKey;
+
+    std::shared_ptr<UploadQueue> m_uploadQueue;
+
+    std::unordered_map<std::string, StreamRequest> m_streamRequests;
+    std::set<std::pair<float, std::string>> m_streamOrder; ///< Priorities and keys of the requests that have not started decoding
+    std::shared_ptr<UploadQueue> m_streamQueue;
+    std::vector<Upload> m_streamUploads;
+    std::vector<std::pair<std::string, AsyncLoad>> m_streamLoads;
+    std::size_t m_maxStreamLoads = 4;
+    std::size_t m_maxStreamUploadBytes = 4 * 1024 * 1024;
+    sf::Image m_placeholder;
+
+    bool m_mipmapping = false;
+    unsigned int m_resolutionLevel = 0;
+    bool m_deduplication = false;
+
+    ImageCache m_cache;
+
+    std::unique_ptr<FileWatcher> m_watcher;
+    std::unordered_map<std::string, ReloadSource> m_reloadSources;
+    std::shared_ptr<UploadQueue> m_reloadQueue;
 
+    std::shared_ptr<WorkerPool> m_ownedPool;
+    WorkerPool *m_pool = nullptr;
 };
 
 } // namespace sfex
@@ -0,0 +1,81 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef _SFEX_GENERAL_FILE_IO_HPP_
+#define _SFEX_GENERAL_FILE_IO_HPP_
+
+#include <SFML/System/InputStream.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Helpers shared by the sources that read files and binary formats. Not part of the installed headers.
+
+namespace sfex
+{
+
+namespace impl
+{
+
+/// @brief Read a little endian unsigned integer of size bytes
+inline std::uint64_t readInteger(const char *bytes, std::size_t size)
+{
+    std::uint64_t value = 0;
+    for(std::size_t i = size; i > 0; --i) value = (value << 8) | static_cast<unsigned char>(bytes[i - 1]);
+    return value;
+}
+
+/// @brief Append the lowest size bytes of value to output, little endian
+inline void writeInteger(std::vector<char> &output, std::uint64_t value, std::size_t size)
+{
+    for(std::size_t i = 0; i < size; ++i) output.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/// @brief Read a whole file into data
+inline bool readFile(const std::string &filename, std::vector<char> &data)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if(!file) return false;
+
+    data.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(data.data(), static_cast<std::streamsize>(data.size())));
+}
+
+/// @brief Read a whole stream into data, from its beginning
+inline bool readStream(sf::InputStream &stream, std::vector<char> &data)
+{
+    sf::Int64 size = stream.getSize();
+    if(size < 0 || stream.seek(0) != 0) return false;
+
+    data.resize(static_cast<std::size_t>(size));
+    return stream.read(data.data(), size) == size;
+}
+
+} // namespace impl
+
+} // namespace sfex
+
+#endif // !_SFEX_GENERAL_FILE_IO_HPP_
\ No newline at end of file
@@ -0,0 +1,254 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/FileWatcher.hpp>
+#include <chrono>
+#include <filesystem>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace sfex
+{
+
+namespace
+{
+
+constexpr std::chrono::milliseconds PollInterval(250);
+
+// A missing file gets a zero time and size, so it counts as changed when it appears
+void getStamp(const std::string &path, std::int64_t &time, std::uintmax_t &size)
+{
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    time = error ? 0 : static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+    size = std::filesystem::file_size(path, error);
+    if(error) size = 0;
+}
+
+} // namespace
+
+FileWatcher::FileWatcher()
+{
+#ifdef __linux__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_fd != -1)
+    {
+        // The thread blocks in poll, writing to this descriptor wakes it up to stop
+        m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(m_wakeFd == -1)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+#endif
+    m_thread = std::thread(&FileWatcher::run, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+#ifdef __linux__
+    if(m_wakeFd != -1)
+    {
+        std::uint64_t one = 1;
+        if(::write(m_wakeFd, &one, sizeof(one)) < 0) {}
+    }
+#endif
+    m_thread.join();
+
+#ifdef __linux__
+    if(m_fd != -1)
+    {
+        ::close(m_fd);
+        ::close(m_wakeFd);
+    }
+#endif
+}
+
+bool FileWatcher::watch(const std::string &filename)
+{
+    std::string path = getWatchPath(filename);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_files.find(path);
+    if(it != m_files.end())
+    {
+        ++it->second.count;
+        return true;
+    }
+
+    WatchedFile file;
+    file.count = 1;
+    file.directory = std::filesystem::path(path).parent_path().string();
+    if(!watchDirectory(file.directory)) return false;
+
+    getStamp(path, file.time, file.size);
+    m_files.emplace(std::move(path), std::move(file));
+    return true;
+}
+
+void FileWatcher::unwatch(const std::string &filename)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_files.find(getWatchPath(filename));
+    if(it == m_files.end() || --it->second.count > 0) return;
+
+    unwatchDirectory(it->second.directory);
+    m_files.erase(it);
+}
+
+bool FileWatcher::isWatching(const std::string &filename) const
+{
+    std::string path = getWatchPath(filename);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_files.find(path) != m_files.end();
+}
+
+std::size_t FileWatcher::getWatchCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_files.size();
+}
+
+std::vector<std::string> FileWatcher::pollChanges()
+{
+    std::vector<std::string> changes;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    changes.swap(m_changes);
+    m_changed.clear();
+    return changes;
+}
+
+std::string FileWatcher::getWatchPath(const std::string &filename)
+{
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::absolute(filename, error);
+    return error ? filename : path.lexically_normal().string();
+}
+
+void FileWatcher::run()
+{
+    while(m_running)
+    {
+#ifdef __linux__
+        if(m_fd != -1)
+        {
+            pollfd descriptors[2] = {{m_fd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+            if(::poll(descriptors, 2, -1) > 0 && (descriptors[0].revents & POLLIN)) readEvents();
+            continue;
+        }
+#endif
+        checkTimes();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait_for(lock, PollInterval, [this](){ return !m_running; });
+    }
+}
+
+bool FileWatcher::watchDirectory(const std::string &directory)
+{
+#ifdef __linux__
+    if(m_fd == -1) return true;
+
+    auto it = m_watchOfDirectory.find(directory);
+    if(it == m_watchOfDirectory.end())
+    {
+        // Closing a written file and moving a file in cover saving in place and saving by replacing
+        int watch = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if(watch == -1) return false;
+
+        it = m_watchOfDirectory.emplace(directory, std::make_pair(watch, std::size_t(0))).first;
+        m_directoryOfWatch[watch] = directory;
+    }
+    ++it->second.second;
+#endif
+    return true;
+}
+
+void FileWatcher::unwatchDirectory(const std::string &directory)
+{
+#ifdef __linux__
+    auto it = m_watchOfDirectory.find(directory);
+    if(it == m_watchOfDirectory.end() || --it->second.second > 0) return;
+
+    inotify_rm_watch(m_fd, it->second.first);
+    m_directoryOfWatch.erase(it->second.first);
+    m_watchOfDirectory.erase(it);
+#endif
+}
+
+void FileWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    while(true)
+    {
+        ssize_t length = ::read(m_fd, buffer, sizeof(buffer));
+        if(length <= 0) return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(ssize_t offset = 0; offset < length;)
+        {
+            const inotify_event *event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            auto directory = m_directoryOfWatch.find(event->wd);
+            if(directory == m_directoryOfWatch.end() || event->len == 0) continue;
+            addChange((std::filesystem::path(directory->second) / event->name).string());
+        }
+    }
+#endif
+}
+
+void FileWatcher::checkTimes()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(auto &[path, file] : m_files)
+    {
+        std::int64_t time;
+        std::uintmax_t size;
+        getStamp(path, time, size);
+        if(time == file.time && size == file.size) continue;
+
+        file.time = time;
+        file.size = size;
+        addChange(path);
+    }
+}
+
+void FileWatcher::addChange(const std::string &path)
+{
+    if(m_files.find(path) == m_files.end()) return;
+    if(m_changed.insert(path).second) m_changes.push_back(path);
+}
+
+} // namespace sfex
\ No newline at end of file
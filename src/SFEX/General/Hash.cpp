@@ -0,0 +1,133 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/Hash.hpp>
+
+namespace sfex
+{
+
+namespace
+{
+
+constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+std::uint64_t rotateLeft(std::uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// XXH64 is defined on little endian words. Reading byte by byte works on any alignment and endianness.
+std::uint64_t read64(const unsigned char *bytes)
+{
+    std::uint64_t value = 0;
+    for(int i = 7; i >= 0; --i) value = (value << 8) | bytes[i];
+    return value;
+}
+
+std::uint32_t read32(const unsigned char *bytes)
+{
+    std::uint32_t value = 0;
+    for(int i = 3; i >= 0; --i) value = (value << 8) | bytes[i];
+    return value;
+}
+
+std::uint64_t hashRound(std::uint64_t accumulator, std::uint64_t input)
+{
+    accumulator += input * Prime2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * Prime1;
+}
+
+std::uint64_t mergeRound(std::uint64_t accumulator, std::uint64_t value)
+{
+    accumulator ^= hashRound(0, value);
+    return accumulator * Prime1 + Prime4;
+}
+
+} // namespace
+
+std::uint64_t xxHash64(const void *data, std::size_t size, std::uint64_t seed)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    const unsigned char *end = bytes + size;
+    std::uint64_t hash;
+
+    if(size >= 32)
+    {
+        std::uint64_t v1 = seed + Prime1 + Prime2;
+        std::uint64_t v2 = seed + Prime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - Prime1;
+
+        const unsigned char *limit = end - 32;
+        do
+        {
+            v1 = hashRound(v1, read64(bytes));
+            v2 = hashRound(v2, read64(bytes + 8));
+            v3 = hashRound(v3, read64(bytes + 16));
+            v4 = hashRound(v4, read64(bytes + 24));
+            bytes += 32;
+        } while(bytes <= limit);
+
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else hash = seed + Prime5;
+
+    hash += static_cast<std::uint64_t>(size);
+
+    for(; bytes + 8 <= end; bytes += 8)
+    {
+        hash ^= hashRound(0, read64(bytes));
+        hash = rotateLeft(hash, 27) * Prime1 + Prime4;
+    }
+    if(bytes + 4 <= end)
+    {
+        hash ^= static_cast<std::uint64_t>(read32(bytes)) * Prime1;
+        hash = rotateLeft(hash, 23) * Prime2 + Prime3;
+        bytes += 4;
+    }
+    for(; bytes < end; ++bytes)
+    {
+        hash ^= (*bytes) * Prime5;
+        hash = rotateLeft(hash, 11) * Prime1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace sfex
\ No newline at end of file
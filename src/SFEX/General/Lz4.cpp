@@ -0,0 +1,170 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/Lz4.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace sfex
+{
+
+namespace
+{
+
+// Limits of the block format: the last 5 bytes are always literals and the last match starts at least 12 bytes before the end
+constexpr std::size_t MinMatch = 4;
+constexpr std::size_t LastLiterals = 5;
+constexpr std::size_t MatchFindLimit = 12;
+constexpr std::size_t MaxOffset = 65535;
+constexpr int HashBits = 12;
+
+std::uint32_t read32(const unsigned char *bytes)
+{
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+std::uint32_t hashSequence(std::uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+void writeLength(std::vector<char> &output, std::size_t length)
+{
+    for(; length >= 255; length -= 255) output.push_back(static_cast<char>(255));
+    output.push_back(static_cast<char>(length));
+}
+
+void writeSequence(std::vector<char> &output, const unsigned char *literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+{
+    std::size_t matchCode = matchLength >= MinMatch ? matchLength - MinMatch : 0;
+    unsigned char token = static_cast<unsigned char>((literalCount < 15 ? literalCount : 15) << 4);
+    token |= static_cast<unsigned char>(matchCode < 15 ? matchCode : 15);
+    output.push_back(static_cast<char>(token));
+
+    if(literalCount >= 15) writeLength(output, literalCount - 15);
+    output.insert(output.end(), literals, literals + literalCount);
+
+    // The last sequence only has literals
+    if(matchLength == 0) return;
+
+    output.push_back(static_cast<char>(offset & 0xFF));
+    output.push_back(static_cast<char>(offset >> 8));
+    if(matchCode >= 15) writeLength(output, matchCode - 15);
+}
+
+} // namespace
+
+std::vector<char> Lz4::compress(const void *data, std::size_t size)
+{
+    const unsigned char *input = static_cast<const unsigned char*>(data);
+    std::vector<char> output;
+    output.reserve(size + size / 255 + 16);
+
+    std::size_t anchor = 0;
+    if(size > MatchFindLimit)
+    {
+        std::vector<std::size_t> table(std::size_t(1) << HashBits, SIZE_MAX);
+        std::size_t matchLimit = size - LastLiterals;
+
+        for(std::size_t position = 0; position + MatchFindLimit < size;)
+        {
+            std::uint32_t sequence = read32(input + position);
+            std::size_t &entry = table[hashSequence(sequence)];
+            std::size_t candidate = entry;
+            entry = position;
+
+            if(candidate == SIZE_MAX || position - candidate > MaxOffset || read32(input + candidate) != sequence)
+            {
+                ++position;
+                continue;
+            }
+
+            std::size_t length = MinMatch;
+            while(position + length < matchLimit && input[candidate + length] == input[position + length]) ++length;
+
+            writeSequence(output, input + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    writeSequence(output, input + anchor, size - anchor, 0, 0);
+    return output;
+}
+
+bool Lz4::decompress(const void *source, std::size_t sourceSize, void *destination, std::size_t destinationSize)
+{
+    const unsigned char *input = static_cast<const unsigned char*>(source);
+    const unsigned char *inputEnd = input + sourceSize;
+    unsigned char *output = static_cast<unsigned char*>(destination);
+    std::size_t written = 0;
+
+    auto readLength = [&](std::size_t length) -> std::size_t {
+        if(length != 15) return length;
+
+        unsigned char byte;
+        do
+        {
+            if(input == inputEnd) return SIZE_MAX;
+            byte = *input++;
+            length += byte;
+        } while(byte == 255);
+        return length;
+    };
+
+    while(input < inputEnd)
+    {
+        unsigned char token = *input++;
+
+        std::size_t literalCount = readLength(token >> 4);
+        if(literalCount == SIZE_MAX || literalCount > static_cast<std::size_t>(inputEnd - input) || literalCount > destinationSize - written) return false;
+        if(literalCount > 0) std::memcpy(output + written, input, literalCount);
+        input += literalCount;
+        written += literalCount;
+
+        // The last sequence ends after its literals
+        if(input == inputEnd) break;
+
+        if(inputEnd - input < 2) return false;
+        std::size_t offset = input[0] | (static_cast<std::size_t>(input[1]) << 8);
+        input += 2;
+        if(offset == 0 || offset > written) return false;
+
+        std::size_t matchLength = readLength(token & 0x0F);
+        if(matchLength == SIZE_MAX) return false;
+        matchLength += MinMatch;
+        if(matchLength > destinationSize - written) return false;
+
+        // Matches may overlap the bytes they produce, so they are copied byte by byte
+        const unsigned char *match = output + written - offset;
+        for(std::size_t i = 0; i < matchLength; ++i) output[written + i] = match[i];
+        written += matchLength;
+    }
+
+    return written == destinationSize;
+}
+
+} // namespace sfex
\ No newline at end of file
@@ -0,0 +1,164 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/MappedFile.hpp>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace sfex
+{
+
+MappedFile::MappedFile(MappedFile &&other) noexcept:
+    m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)), m_open(std::exchange(other.m_open, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if(this == &other) return *this;
+
+    close();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_open = std::exchange(other.m_open, false);
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty files cannot be mapped, but they can be opened
+    if(size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mapping) m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if(mapping) CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    if(size.QuadPart > 0 && !m_data) return false;
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    m_open = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(m_data) UnmapViewOfFile(m_data);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if(file < 0) return false;
+
+    struct stat status;
+    if(fstat(file, &status) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    // Empty files cannot be mapped, but they can be opened
+    std::size_t size = static_cast<std::size_t>(status.st_size);
+    if(size > 0)
+    {
+        void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if(data == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+        m_data = static_cast<const char*>(data);
+    }
+
+    // The mapping keeps the file alive on its own
+    ::close(file);
+    m_size = size;
+    m_open = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(m_data) munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#endif
+
+bool MappedFile::isOpen() const
+{
+    return m_open;
+}
+
+const char* MappedFile::getData() const
+{
+    return m_data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+
+} // namespace sfex
\ No newline at end of file
@@ -0,0 +1,390 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/Mixer.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SFEX_MIXER_SSE2
+#endif
+
+namespace sfex
+{
+
+namespace
+{
+
+/// @brief Frames mixed at a time, so the scratch buffer of one voice stays in the L1 cache
+constexpr std::size_t BLOCK_FRAMES = 256;
+
+/// @brief One frame in 32.32 fixed point
+constexpr std::uint64_t FRAME_STEP = std::uint64_t(1) << 32;
+
+/// @brief Lowest pitch a voice plays at, so it always advances
+constexpr float MIN_PITCH = 1.f / 1024.f;
+
+constexpr float SAMPLE_SCALE = 1.f / 32768.f;
+
+// Converts frames of 16 bit samples to stereo floats, duplicating mono samples to both channels
+void convertFrames(const std::int16_t *samples, unsigned int channelCount, float *output, std::size_t frameCount)
+{
+    std::size_t sampleCount = frameCount * channelCount;
+    std::size_t i = 0;
+
+#ifdef SFEX_MIXER_SSE2
+    const __m128 scale = _mm_set1_ps(SAMPLE_SCALE);
+    for(; i + 8 <= sampleCount; i += 8)
+    {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        // Sign extends each sample by placing it in the upper half of a 32 bit lane and shifting it down
+        __m128 low = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16)), scale);
+        __m128 high = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16)), scale);
+        if(channelCount == 2)
+        {
+            _mm_storeu_ps(output + i, low);
+            _mm_storeu_ps(output + i + 4, high);
+        }
+        else
+        {
+            _mm_storeu_ps(output + 2 * i, _mm_unpacklo_ps(low, low));
+            _mm_storeu_ps(output + 2 * i + 4, _mm_unpackhi_ps(low, low));
+            _mm_storeu_ps(output + 2 * i + 8, _mm_unpacklo_ps(high, high));
+            _mm_storeu_ps(output + 2 * i + 12, _mm_unpackhi_ps(high, high));
+        }
+    }
+#endif
+
+    for(; i < sampleCount; ++i)
+    {
+        float sample = samples[i] * SAMPLE_SCALE;
+        if(channelCount == 2) output[i] = sample;
+        else output[2 * i] = output[2 * i + 1] = sample;
+    }
+}
+
+// Adds frameCount stereo frames of source to output with a gain for each channel
+void accumulate(const float *source, float *output, std::size_t frameCount, float leftGain, float rightGain)
+{
+    std::size_t i = 0;
+
+#ifdef SFEX_MIXER_SSE2
+    const __m128 gain = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for(; i + 4 <= 2 * frameCount; i += 4)
+    {
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain));
+        _mm_storeu_ps(output + i, sum);
+    }
+#endif
+
+    for(; i < 2 * frameCount; i += 2)
+    {
+        output[i] += source[i] * leftGain;
+        output[i + 1] += source[i + 1] * rightGain;
+    }
+}
+
+// Converts samples to 16 bits, rounding to the nearest value and clipping what exceeds the range
+void convertToInt16(const float *samples, std::int16_t *output, std::size_t sampleCount)
+{
+    std::size_t i = 0;
+
+#ifdef SFEX_MIXER_SSE2
+    const __m128 scale = _mm_set1_ps(32767.f);
+    const __m128 limit = _mm_set1_ps(32767.f);
+    for(; i + 8 <= sampleCount; i += 8)
+    {
+        // Clamps before converting, since values out of the 32 bit range convert to the lowest integer
+        __m128 low = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(samples + i), scale), limit), _mm_sub_ps(_mm_setzero_ps(), limit));
+        __m128 high = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(samples + i + 4), scale), limit), _mm_sub_ps(_mm_setzero_ps(), limit));
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+#endif
+
+    for(; i < sampleCount; ++i)
+    {
+        float sample = std::clamp(samples[i] * 32767.f, -32767.f, 32767.f);
+        output[i] = static_cast<std::int16_t>(std::lrint(sample));
+    }
+}
+
+} // namespace
+
+Mixer::Mixer(unsigned int sampleRate, std::size_t maxVoices):
+    m_sampleRate(std::max(sampleRate, 1u)), m_maxVoices(std::min<std::size_t>(maxVoices, UINT32_MAX)), m_scratch(2 * BLOCK_FRAMES)
+{
+}
+
+unsigned int Mixer::getSampleRate() const
+{
+    return m_sampleRate;
+}
+
+std::size_t Mixer::getMaxVoices() const
+{
+    return m_maxVoices;
+}
+
+Mixer::VoiceId Mixer::play(const Source &source)
+{
+    return play(source, VoiceSettings());
+}
+
+Mixer::VoiceId Mixer::play(const Source &source, const VoiceSettings &settings)
+{
+    if(!source.samples || (source.channelCount != 1 && source.channelCount != 2) || source.sampleRate == 0) return 0;
+    if(source.sampleCount < source.channelCount) return 0;
+
+    std::lock_guard lock(m_mutex);
+    std::uint32_t index;
+    if(!m_freeVoices.empty())
+    {
+        index = m_freeVoices.back();
+        m_freeVoices.pop_back();
+    }
+    else
+    {
+        if(m_voices.size() >= m_maxVoices) return 0;
+        index = static_cast<std::uint32_t>(m_voices.size());
+        m_voices.emplace_back();
+        m_voices.back().generation = 1;
+    }
+
+    Voice &voice = m_voices[index];
+    voice.source = source;
+    voice.settings = settings;
+    voice.position = 0;
+    voice.active = true;
+    voice.activeIndex = m_activeVoices.size();
+    m_activeVoices.push_back(index);
+    return (static_cast<VoiceId>(voice.generation) << 32) | index;
+}
+
+void Mixer::stop(VoiceId voice)
+{
+    std::lock_guard lock(m_mutex);
+    if(Voice *found = findVoice(voice)) release(*found);
+}
+
+void Mixer::stopAll()
+{
+    std::lock_guard lock(m_mutex);
+    while(!m_activeVoices.empty()) release(m_voices[m_activeVoices.back()]);
+}
+
+bool Mixer::isPlaying(VoiceId voice) const
+{
+    std::lock_guard lock(m_mutex);
+    return findVoice(voice) != nullptr;
+}
+
+std::size_t Mixer::getVoiceCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_activeVoices.size();
+}
+
+void Mixer::setGain(VoiceId voice, float gain)
+{
+    std::lock_guard lock(m_mutex);
+    if(Voice *found = findVoice(voice)) found->settings.gain = gain;
+}
+
+void Mixer::setPan(VoiceId voice, float pan)
+{
+    std::lock_guard lock(m_mutex);
+    if(Voice *found = findVoice(voice)) found->settings.pan = pan;
+}
+
+void Mixer::setPitch(VoiceId voice, float pitch)
+{
+    std::lock_guard lock(m_mutex);
+    if(Voice *found = findVoice(voice)) found->settings.pitch = pitch;
+}
+
+void Mixer::setBusGain(Bus bus, float gain)
+{
+    std::lock_guard lock(m_mutex);
+    m_buses[static_cast<std::size_t>(bus)].gain = gain;
+}
+
+float Mixer::getBusGain(Bus bus) const
+{
+    std::lock_guard lock(m_mutex);
+    return m_buses[static_cast<std::size_t>(bus)].gain;
+}
+
+void Mixer::setBusPaused(Bus bus, bool paused)
+{
+    std::lock_guard lock(m_mutex);
+    m_buses[static_cast<std::size_t>(bus)].paused = paused;
+}
+
+bool Mixer::isBusPaused(Bus bus) const
+{
+    std::lock_guard lock(m_mutex);
+    return m_buses[static_cast<std::size_t>(bus)].paused;
+}
+
+void Mixer::setMasterGain(float gain)
+{
+    std::lock_guard lock(m_mutex);
+    m_masterGain = gain;
+}
+
+float Mixer::getMasterGain() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_masterGain;
+}
+
+void Mixer::render(float *output, std::size_t frameCount)
+{
+    std::lock_guard lock(m_mutex);
+    mix(output, frameCount);
+}
+
+void Mixer::render(std::int16_t *output, std::size_t frameCount)
+{
+    // m_output is shared by every caller, so it is only used under the lock
+    std::lock_guard lock(m_mutex);
+    m_output.resize(2 * frameCount);
+    mix(m_output.data(), frameCount);
+    convertToInt16(m_output.data(), output, 2 * frameCount);
+}
+
+void Mixer::mix(float *output, std::size_t frameCount)
+{
+    std::fill(output, output + 2 * frameCount, 0.f);
+    for(std::size_t offset = 0; offset < frameCount; offset += BLOCK_FRAMES)
+    {
+        std::size_t blockFrames = std::min(BLOCK_FRAMES, frameCount - offset);
+        // Iterates backwards, so releasing a voice only moves one that has already been mixed
+        for(std::size_t i = m_activeVoices.size(); i-- > 0;)
+        {
+            Voice &voice = m_voices[m_activeVoices[i]];
+            const BusState &bus = m_buses[static_cast<std::size_t>(voice.settings.bus)];
+            if(bus.paused) continue;
+
+            std::size_t rendered = renderVoice(voice, blockFrames);
+            // The bus and master gains are folded into the gain of the voice, which mixes the same as summing scaled buses
+            float gain = voice.settings.gain * bus.gain * m_masterGain;
+            float pan = std::clamp(voice.settings.pan, -1.f, 1.f);
+            float leftGain, rightGain;
+            if(voice.source.channelCount == 1)
+            {
+                float angle = (pan + 1.f) * 0.785398163f;
+                leftGain = gain * std::cos(angle);
+                rightGain = gain * std::sin(angle);
+            }
+            else
+            {
+                leftGain = gain * std::min(1.f - pan, 1.f);
+                rightGain = gain * std::min(1.f + pan, 1.f);
+            }
+            accumulate(m_scratch.data(), output + 2 * offset, rendered, leftGain, rightGain);
+            std::uint64_t end = static_cast<std::uint64_t>(voice.source.sampleCount / voice.source.channelCount) << 32;
+            if(rendered < blockFrames || (!voice.settings.loop && voice.position >= end)) release(voice);
+        }
+    }
+}
+
+Mixer::Voice* Mixer::findVoice(VoiceId id)
+{
+    std::uint32_t index = static_cast<std::uint32_t>(id);
+    if(index >= m_voices.size()) return nullptr;
+    Voice &voice = m_voices[index];
+    if(!voice.active || voice.generation != static_cast<std::uint32_t>(id >> 32)) return nullptr;
+    return &voice;
+}
+
+const Mixer::Voice* Mixer::findVoice(VoiceId id) const
+{
+    return const_cast<Mixer*>(this)->findVoice(id);
+}
+
+std::size_t Mixer::renderVoice(Voice &voice, std::size_t frameCount)
+{
+    const Source &source = voice.source;
+    const std::uint64_t sourceFrames = source.sampleCount / source.channelCount;
+    const std::uint64_t end = sourceFrames << 32;
+    double ratio = static_cast<double>(std::max(voice.settings.pitch, MIN_PITCH)) * source.sampleRate / m_sampleRate;
+    const std::uint64_t step = std::max<std::uint64_t>(static_cast<std::uint64_t>(ratio * FRAME_STEP + 0.5), 1);
+
+    float *output = m_scratch.data();
+    std::size_t written = 0;
+    while(written < frameCount)
+    {
+        if(voice.position >= end)
+        {
+            if(!voice.settings.loop) break;
+            voice.position %= end;
+        }
+
+        if(step == FRAME_STEP && (voice.position & (FRAME_STEP - 1)) == 0)
+        {
+            // Playing at the rate of the output on whole frames needs no interpolation
+            std::uint64_t frame = voice.position >> 32;
+            std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(frameCount - written, sourceFrames - frame));
+            convertFrames(source.samples + frame * source.channelCount, source.channelCount, output + 2 * written, count);
+            written += count;
+            voice.position += count * FRAME_STEP;
+            continue;
+        }
+
+        // Interpolates linearly between two frames, with the one after the last being the first when looping and silence otherwise
+        for(; written < frameCount && voice.position < end; ++written, voice.position += step)
+        {
+            std::uint64_t frame = voice.position >> 32;
+            float fraction = static_cast<float>(voice.position & (FRAME_STEP - 1)) * (1.f / FRAME_STEP);
+            std::uint64_t next = frame + 1;
+            bool hasNext = next < sourceFrames || voice.settings.loop;
+            if(next >= sourceFrames) next = 0;
+            for(unsigned int c = 0; c < 2; ++c)
+            {
+                unsigned int channel = source.channelCount == 2 ? c : 0;
+                float a = source.samples[frame * source.channelCount + channel] * SAMPLE_SCALE;
+                float b = hasNext ? source.samples[next * source.channelCount + channel] * SAMPLE_SCALE : 0.f;
+                output[2 * written + c] = a + (b - a) * fraction;
+            }
+        }
+    }
+    return written;
+}
+
+void Mixer::release(Voice &voice)
+{
+    std::uint32_t index = m_activeVoices[voice.activeIndex];
+    m_activeVoices[voice.activeIndex] = m_activeVoices.back();
+    m_voices[m_activeVoices.back()].activeIndex = voice.activeIndex;
+    m_activeVoices.pop_back();
+
+    voice.active = false;
+    if(++voice.generation == 0) voice.generation = 1;
+    m_freeVoices.push_back(index);
+}
+
+} // namespace sfex
\ No newline at end of file
@@ -0,0 +1,75 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/MixerStream.hpp>
+#include <algorithm>
+
+namespace sfex
+{
+
+MixerStream::MixerStream(Mixer &mixer, std::size_t chunkFrames):
+    m_mixer(mixer), m_samples(2 * std::max<std::size_t>(chunkFrames, 1))
+{
+    initialize(2, mixer.getSampleRate());
+}
+
+MixerStream::~MixerStream()
+{
+    // The audio thread has to stop before the members onGetData uses are destroyed
+    stop();
+}
+
+Mixer& MixerStream::getMixer() const
+{
+    return m_mixer;
+}
+
+Mixer::VoiceId MixerStream::playBuffer(const sf::SoundBuffer &buffer, const Mixer::VoiceSettings &settings)
+{
+    return m_mixer.play(getSource(buffer), settings);
+}
+
+Mixer::Source MixerStream::getSource(const sf::SoundBuffer &buffer)
+{
+    Mixer::Source source;
+    source.samples = buffer.getSamples();
+    source.sampleCount = static_cast<std::size_t>(buffer.getSampleCount());
+    source.channelCount = buffer.getChannelCount();
+    source.sampleRate = buffer.getSampleRate();
+    return source;
+}
+
+bool MixerStream::onGetData(Chunk &data)
+{
+    m_mixer.render(m_samples.data(), m_samples.size() / 2);
+    data.samples = m_samples.data();
+    data.sampleCount = m_samples.size();
+    return true;
+}
+
+void MixerStream::onSeek(sf::Time)
+{
+}
+
+} // namespace sfex
\ No newline at end of file
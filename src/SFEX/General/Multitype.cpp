@@ -142,7 +142,7 @@ Multitype::Multitype(const MultitypeMap &map_val)
     for(auto&[key, value] : map_val)
     {
         Pair p;
-        p.char_ptr = std::make_unique<char[]>(0);
+        p.char_ptr = std::make_unique<char[]>(key.length() + 1);
         std::memcpy(p.char_ptr.get(), key.c_str(), key.length()+1);
         p.multitype = value;
         *(values.get() + i) = std::move(p);
@@ -0,0 +1,289 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/Pack.hpp>
+#include <SFEX/General/Lz4.hpp>
+#include "FileIo.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace sfex
+{
+
+namespace
+{
+
+// Layout, all integers little endian:
+// Header: "SFEXPACK", u32 version, u32 entry count, u32 alignment, u32 size of the name table, u64 reserved
+// Table of contents, sorted by name: u32 name offset, u32 name size, u64 offset, u64 stored size, u64 original size, u32 flags, u32 reserved
+// Name table, then the entries at aligned offsets
+const char PackSignature[8] = {'S', 'F', 'E', 'X', 'P', 'A', 'C', 'K'};
+constexpr std::uint32_t PackVersion = 1;
+constexpr std::size_t HeaderSize = 32;
+constexpr std::size_t TocEntrySize = 40;
+constexpr std::uint32_t CompressedFlag = 1;
+
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+sf::Int64 PackStream::read(void *data, sf::Int64 size)
+{
+    if(!m_open) return -1;
+    if(size <= 0) return 0;
+
+    std::size_t count = std::min(static_cast<std::size_t>(size), m_size - m_position);
+    if(count > 0) std::memcpy(data, m_data + m_position, count);
+    m_position += count;
+    return static_cast<sf::Int64>(count);
+}
+
+sf::Int64 PackStream::seek(sf::Int64 position)
+{
+    if(!m_open) return -1;
+
+    m_position = position < 0 ? 0 : std::min(static_cast<std::size_t>(position), m_size);
+    return static_cast<sf::Int64>(m_position);
+}
+
+sf::Int64 PackStream::tell()
+{
+    if(!m_open) return -1;
+    return static_cast<sf::Int64>(m_position);
+}
+
+sf::Int64 PackStream::getSize()
+{
+    if(!m_open) return -1;
+    return static_cast<sf::Int64>(m_size);
+}
+
+const char* PackStream::getData() const
+{
+    return m_data;
+}
+
+void PackStream::open(const char *data, std::size_t size)
+{
+    m_data = data;
+    m_size = size;
+    m_position = 0;
+    m_open = true;
+}
+
+void PackStream::close()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+    m_open = false;
+}
+
+bool Pack::openFromFile(const std::string &filename)
+{
+    close();
+    if(!m_file.open(filename)) return false;
+
+    const char *data = m_file.getData();
+    std::size_t fileSize = m_file.getSize();
+    if(fileSize < HeaderSize || std::memcmp(data, PackSignature, sizeof(PackSignature)) != 0 || impl::readInteger(data + 8, 4) != PackVersion)
+    {
+        close();
+        return false;
+    }
+
+    std::uint64_t entryCount = impl::readInteger(data + 12, 4);
+    std::uint64_t namesSize = impl::readInteger(data + 20, 4);
+    std::uint64_t namesOffset = HeaderSize + entryCount * TocEntrySize;
+    if(namesOffset + namesSize > fileSize)
+    {
+        close();
+        return false;
+    }
+
+    m_entries.reserve(static_cast<std::size_t>(entryCount));
+    for(std::uint64_t i = 0; i < entryCount; ++i)
+    {
+        const char *toc = data + HeaderSize + i * TocEntrySize;
+        std::uint64_t nameOffset = impl::readInteger(toc, 4);
+        std::uint64_t nameSize = impl::readInteger(toc + 4, 4);
+
+        Entry entry;
+        entry.offset = impl::readInteger(toc + 8, 8);
+        entry.size = impl::readInteger(toc + 16, 8);
+        entry.originalSize = impl::readInteger(toc + 24, 8);
+        entry.compressed = (impl::readInteger(toc + 32, 4) & CompressedFlag) != 0;
+
+        // Lookups rely on the table being strictly sorted, and entries must not point outside of the file
+        bool valid = nameOffset + nameSize <= namesSize && entry.offset <= fileSize && entry.size <= fileSize - entry.offset;
+        if(valid) entry.name = std::string_view(data + namesOffset + nameOffset, static_cast<std::size_t>(nameSize));
+        if(!valid || (!m_entries.empty() && !(m_entries.back().name < entry.name)))
+        {
+            close();
+            return false;
+        }
+        m_entries.push_back(entry);
+    }
+    return true;
+}
+
+void Pack::close()
+{
+    m_entries.clear();
+    m_file.close();
+}
+
+bool Pack::contains(std::string_view name) const
+{
+    return find(name) != nullptr;
+}
+
+const Pack::Entry* Pack::find(std::string_view name) const
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name, [](const Entry &entry, std::string_view name){
+        return entry.name < name;
+    });
+    if(it == m_entries.end() || it->name != name) return nullptr;
+    return &*it;
+}
+
+const std::vector<Pack::Entry>& Pack::getEntries() const
+{
+    return m_entries;
+}
+
+bool Pack::openStream(std::string_view name, PackStream &stream) const
+{
+    // A failed open must not leave the stream reading its previous entry, whose buffer may be resized below
+    stream.close();
+    const Entry *entry = find(name);
+    if(!entry) return false;
+
+    const char *data = m_file.getData() + entry->offset;
+    if(!entry->compressed)
+    {
+        stream.m_buffer.clear();
+        stream.open(data, static_cast<std::size_t>(entry->size));
+        return true;
+    }
+
+    stream.m_buffer.resize(static_cast<std::size_t>(entry->originalSize));
+    if(!Lz4::decompress(data, static_cast<std::size_t>(entry->size), stream.m_buffer.data(), stream.m_buffer.size())) return false;
+
+    stream.open(stream.m_buffer.data(), stream.m_buffer.size());
+    return true;
+}
+
+PackWriter::PackWriter(std::size_t alignment):
+    m_alignment(alignment), m_blobs()
+{
+    if(alignment == 0 || (alignment & (alignment - 1)) != 0) throw std::invalid_argument("Pack alignment has to be a power of two");
+}
+
+void PackWriter::add(const std::string &name, const void *data, std::size_t size, bool compress)
+{
+    const char *bytes = static_cast<const char*>(data);
+    Blob blob{std::vector<char>(), size, false};
+    if(compress)
+    {
+        std::vector<char> compressed = Lz4::compress(data, size);
+        if(compressed.size() < size)
+        {
+            blob.data = std::move(compressed);
+            blob.compressed = true;
+        }
+    }
+    if(!blob.compressed) blob.data.assign(bytes, bytes + size);
+
+    m_blobs[name] = std::move(blob);
+}
+
+bool PackWriter::addFromFile(const std::string &name, const std::string &filename, bool compress)
+{
+    std::vector<char> data;
+    if(!impl::readFile(filename, data)) return false;
+
+    add(name, data.data(), data.size(), compress);
+    return true;
+}
+
+std::size_t PackWriter::getEntryCount() const
+{
+    return m_blobs.size();
+}
+
+bool PackWriter::saveToFile(const std::string &filename) const
+{
+    std::vector<char> names;
+    for(auto &pair : m_blobs) names.insert(names.end(), pair.first.begin(), pair.first.end());
+
+    std::vector<char> header;
+    header.insert(header.end(), PackSignature, PackSignature + sizeof(PackSignature));
+    impl::writeInteger(header, PackVersion, 4);
+    impl::writeInteger(header, m_blobs.size(), 4);
+    impl::writeInteger(header, m_alignment, 4);
+    impl::writeInteger(header, names.size(), 4);
+    impl::writeInteger(header, 0, 8);
+
+    std::uint64_t offset = alignUp(HeaderSize + m_blobs.size() * TocEntrySize + names.size(), m_alignment);
+    std::uint64_t nameOffset = 0;
+    for(auto &pair : m_blobs)
+    {
+        const Blob &blob = pair.second;
+        impl::writeInteger(header, nameOffset, 4);
+        impl::writeInteger(header, pair.first.size(), 4);
+        impl::writeInteger(header, offset, 8);
+        impl::writeInteger(header, blob.data.size(), 8);
+        impl::writeInteger(header, blob.originalSize, 8);
+        impl::writeInteger(header, blob.compressed ? CompressedFlag : 0, 4);
+        impl::writeInteger(header, 0, 4);
+
+        nameOffset += pair.first.size();
+        offset = alignUp(offset + blob.data.size(), m_alignment);
+    }
+    header.insert(header.end(), names.begin(), names.end());
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file) return false;
+
+    const std::vector<char> padding(m_alignment, 0);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    std::uint64_t position = header.size();
+    for(auto &pair : m_blobs)
+    {
+        const Blob &blob = pair.second;
+        std::uint64_t start = alignUp(position, m_alignment);
+        file.write(padding.data(), static_cast<std::streamsize>(start - position));
+        file.write(blob.data.data(), static_cast<std::streamsize>(blob.data.size()));
+        position = start + blob.data.size();
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace sfex
\ No newline at end of file
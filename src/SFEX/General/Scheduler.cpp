@@ -0,0 +1,429 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/Scheduler.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace sfex
+{
+
+namespace impl
+{
+
+void JobControl::cancel()
+{
+    m_cancelled = true;
+}
+
+bool JobControl::isCancelled() const
+{
+    return m_cancelled;
+}
+
+void JobControl::recordRun(const sf::Time &tick, const sf::Time &start, const sf::Time &end, const sf::Time &nextTick)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    sf::Time jitter = start - tick;
+
+    ++m_statistics.runCount;
+    m_totalJitter += jitter.asMicroseconds();
+    m_statistics.lastJitter = jitter;
+    m_statistics.averageJitter = sf::microseconds(m_totalJitter / static_cast<sf::Int64>(m_statistics.runCount));
+    m_statistics.maxJitter = std::max(m_statistics.maxJitter, jitter);
+    m_statistics.lastRunDuration = end - start;
+    m_statistics.maxRunDuration = std::max(m_statistics.maxRunDuration, end - start);
+    if(end > nextTick) ++m_statistics.overrunCount;
+}
+
+void JobControl::recordSkippedTicks(std::uint64_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics.skippedTicks += count;
+}
+
+JobStatistics JobControl::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void JobControl::fail(std::exception_ptr exception)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exception = exception;
+    }
+    cancel();
+}
+
+std::exception_ptr JobControl::getException() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_exception;
+}
+
+} // namespace impl
+
+JobHandle::JobHandle(std::shared_ptr<impl::JobControl> control):
+    m_control(std::move(control))
+{
+}
+
+void JobHandle::cancel()
+{
+    if(m_control) m_control->cancel();
+}
+
+bool JobHandle::isActive() const
+{
+    return m_control && !m_control->isCancelled();
+}
+
+bool JobHandle::isValid() const
+{
+    return static_cast<bool>(m_control);
+}
+
+JobStatistics JobHandle::getStatistics() const
+{
+    if(!m_control) return JobStatistics();
+    return m_control->getStatistics();
+}
+
+std::exception_ptr JobHandle::getException() const
+{
+    if(!m_control) return nullptr;
+    return m_control->getException();
+}
+
+Scheduler::DelayAwaiter::DelayAwaiter(Scheduler &scheduler, const sf::Time &delay, Target target):
+    m_scheduler(scheduler), m_delay(delay), m_target(target)
+{
+}
+
+bool Scheduler::DelayAwaiter::await_ready() const
+{
+    // Resuming on the main thread has to go through update() even without a delay, the awaiting coroutine might be running on a worker
+    return m_delay <= sf::Time::Zero && m_target == Target::Worker;
+}
+
+void Scheduler::DelayAwaiter::await_resume() const
+{
+}
+
+Scheduler::NextFrameAwaiter::NextFrameAwaiter(Scheduler &scheduler):
+    m_scheduler(scheduler)
+{
+}
+
+bool Scheduler::NextFrameAwaiter::await_ready() const
+{
+    return false;
+}
+
+void Scheduler::NextFrameAwaiter::await_resume() const
+{
+}
+
+Scheduler::Scheduler(std::size_t workerCount, std::size_t realtimeWorkerCount):
+    m_workerCount(workerCount), m_realtimeWorkerCount(realtimeWorkerCount), m_timerSequence(0), m_cancelGeneration(0), m_timerRunning(true), m_virtualClock(nullptr), m_frameCount(0)
+{
+}
+
+Scheduler::Scheduler(VirtualClock &clock, std::size_t workerCount, std::size_t realtimeWorkerCount):
+    m_workerCount(workerCount), m_realtimeWorkerCount(realtimeWorkerCount), m_timerSequence(0), m_cancelGeneration(0), m_timerRunning(true), m_virtualClock(&clock), m_frameCount(0)
+{
+}
+
+Scheduler::~Scheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        m_timerRunning = false;
+    }
+    m_timerCondition.notify_all();
+    if(m_timerThread.joinable()) m_timerThread.join();
+
+    cancelAll();
+
+    // The pool runs its remaining tasks before it is gone, and those may still post to the queues below
+    m_workerPool.reset();
+    m_timers.clear();
+    m_mainThreadTasks.clear();
+}
+
+void Scheduler::cancelAll()
+{
+    // Every job that is not running right now waits for its next tick in the timer heap. A running one is cancelled when it queues its next tick.
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    ++m_cancelGeneration;
+    for(auto &timer : m_timers)
+    {
+        if(timer.job) timer.job->cancel();
+    }
+}
+
+WorkerPool& Scheduler::getWorkerPool()
+{
+    std::call_once(m_workerPoolFlag, [this](){
+        m_workerPool = std::make_unique<WorkerPool>(m_workerCount, m_realtimeWorkerCount);
+    });
+    return *m_workerPool;
+}
+
+void Scheduler::dispatch(TaskGraph &graph)
+{
+    graph.run(getWorkerPool());
+}
+
+void Scheduler::update()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_runningMainThreadTasks.swap(m_mainThreadTasks);
+    }
+    ++m_frameCount;
+
+    for(auto &task : m_runningMainThreadTasks)
+    {
+        task();
+    }
+    m_runningMainThreadTasks.clear();
+}
+
+std::uint64_t Scheduler::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+void Scheduler::advance(const sf::Time &time)
+{
+    if(!m_virtualClock) throw std::logic_error("Scheduler::advance() can only be used with a VirtualClock");
+    sf::Time target = now() + std::max(time, sf::Time::Zero);
+
+    std::unique_lock<std::mutex> lock(m_timerMutex);
+    while(!m_timers.empty() && m_timers.front().deadline <= target)
+    {
+        std::pop_heap(m_timers.begin(), m_timers.end(), &Scheduler::isLater);
+        Timer timer = std::move(m_timers.back());
+        m_timers.pop_back();
+
+        lock.unlock();
+        m_virtualClock->advance(timer.deadline - now());
+        if(timer.target == Target::Worker)
+        {
+            timer.task();
+        }
+        else
+        {
+            dispatch(timer.target, std::move(timer.task));
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    m_virtualClock->advance(target - now());
+}
+
+Scheduler::DelayAwaiter Scheduler::delay(const sf::Time &time, Target target)
+{
+    return DelayAwaiter(*this, time, target);
+}
+
+Scheduler::NextFrameAwaiter Scheduler::nextFrame()
+{
+    return NextFrameAwaiter(*this);
+}
+
+void Scheduler::addTimer(const sf::Time &delay, Target target, impl::Task task)
+{
+    addTimerAt(now() + delay, target, std::move(task));
+}
+
+void Scheduler::addTimerAt(const sf::Time &deadline, Target target, impl::Task task)
+{
+    startTimerThread();
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        pushTimer({deadline, 0, target, std::move(task), nullptr});
+    }
+    m_timerCondition.notify_one();
+}
+
+void Scheduler::pushTimer(Timer timer)
+{
+    timer.sequence = m_timerSequence++;
+    m_timers.push_back(std::move(timer));
+    std::push_heap(m_timers.begin(), m_timers.end(), &Scheduler::isLater);
+}
+
+void Scheduler::startTimerThread()
+{
+    if(m_virtualClock) return;
+    std::call_once(m_timerThreadFlag, [this](){
+        // Tasks that the destructor drains may still add timers, which are dropped instead of starting a thread nobody joins
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        if(m_timerRunning) m_timerThread = std::thread(&Scheduler::timerLoop, this);
+    });
+}
+
+void Scheduler::dispatch(Target target, impl::Task task)
+{
+    if(target == Target::Worker)
+    {
+        getWorkerPool().push(std::move(task));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadTasks.push_back(std::move(task));
+}
+
+bool Scheduler::isLater(const Timer &left, const Timer &right)
+{
+    if(left.deadline != right.deadline) return left.deadline > right.deadline;
+    return left.sequence > right.sequence;
+}
+
+void Scheduler::timerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_timerMutex);
+    while(m_timerRunning)
+    {
+        if(m_timers.empty())
+        {
+            m_timerCondition.wait(lock);
+            continue;
+        }
+
+        sf::Time current = now();
+        sf::Time deadline = m_timers.front().deadline;
+        if(deadline > current)
+        {
+            m_timerCondition.wait_for(lock, std::chrono::microseconds((deadline - current).asMicroseconds()));
+            continue;
+        }
+
+        std::pop_heap(m_timers.begin(), m_timers.end(), &Scheduler::isLater);
+        Timer timer = std::move(m_timers.back());
+        m_timers.pop_back();
+
+        lock.unlock();
+        dispatch(timer.target, std::move(timer.task));
+        lock.lock();
+    }
+}
+
+JobHandle Scheduler::startRepeatingJob(const sf::Time &period, CatchUpPolicy policy, impl::Task body)
+{
+    auto job = std::make_shared<RepeatingJob>();
+    job->control = std::make_shared<impl::JobControl>();
+    job->body = std::move(body);
+    job->period = std::max(period, sf::microseconds(1));
+    job->policy = policy;
+    job->tick = now();
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        job->cancelGeneration = m_cancelGeneration;
+    }
+
+    queueRepeatingJob(job);
+    return JobHandle(job->control);
+}
+
+void Scheduler::runRepeatingJob(const std::shared_ptr<RepeatingJob> &job)
+{
+    if(job->control->isCancelled()) return;
+
+    sf::Time start = now();
+    sf::Int64 period = job->period.asMicroseconds();
+    sf::Int64 ticksBehind = (start - job->tick).asMicroseconds() / period;
+
+    if(job->policy == CatchUpPolicy::Skip && ticksBehind > 0)
+    {
+        // Too late for this tick, drop it together with the ones that have passed since and wait for the next one that is still ahead
+        job->control->recordSkippedTicks(static_cast<std::uint64_t>(ticksBehind) + 1);
+        job->tick += sf::microseconds(ticksBehind * period) + job->period;
+        queueRepeatingJob(job);
+        return;
+    }
+
+    // A job that throws stops, like a task whose exception is kept by its future instead of leaving the worker
+    std::exception_ptr exception;
+    try
+    {
+        job->body();
+    }
+    catch(...)
+    {
+        exception = std::current_exception();
+    }
+    sf::Time end = now();
+    job->control->recordRun(job->tick, start, end, job->tick + job->period);
+    if(exception)
+    {
+        job->control->fail(exception);
+        return;
+    }
+
+    if(job->policy == CatchUpPolicy::Burst)
+    {
+        job->tick += job->period;
+    }
+    else
+    {
+        // Continue with the first tick that is still ahead, every tick passed so far was covered by this run
+        sf::Int64 ticksPassed = (end - job->tick).asMicroseconds() / period;
+        job->control->recordSkippedTicks(static_cast<std::uint64_t>(ticksPassed));
+        job->tick += sf::microseconds(ticksPassed * period) + job->period;
+    }
+
+    if(job->control->isCancelled()) return;
+    queueRepeatingJob(job);
+}
+
+void Scheduler::queueRepeatingJob(const std::shared_ptr<RepeatingJob> &job)
+{
+    startTimerThread();
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        if(job->cancelGeneration != m_cancelGeneration)
+        {
+            job->control->cancel();
+            return;
+        }
+        pushTimer({job->tick, 0, Target::Worker, [this, job](){ runRepeatingJob(job); }, job->control});
+    }
+    m_timerCondition.notify_one();
+}
+
+sf::Time Scheduler::now() const
+{
+    if(m_virtualClock) return m_virtualClock->getElapsedTime();
+    return m_clock.getElapsedTime();
+}
+
+} // namespace sfex
@@ -0,0 +1,171 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/SpatialGrid.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sfex
+{
+
+namespace
+{
+
+/// @brief Cell coordinates are clamped to 21 bits, so the three of them fit into one 64 bit key
+constexpr std::int32_t MAX_CELL = (1 << 20) - 1;
+
+} // namespace
+
+SpatialGrid::SpatialGrid(float cellSize):
+    m_cellSize(cellSize > 0.f ? cellSize : 1.f)
+{
+}
+
+float SpatialGrid::getCellSize() const
+{
+    return m_cellSize;
+}
+
+void SpatialGrid::insert(std::uint32_t id, const Vec3 &position)
+{
+    if(id >= m_points.size()) m_points.resize(static_cast<std::size_t>(id) + 1);
+
+    Point &point = m_points[id];
+    std::uint64_t cell = getCellKey(getCellCoordinate(position.x), getCellCoordinate(position.y), getCellCoordinate(position.z));
+    point.position = position;
+    if(point.used)
+    {
+        if(point.cell == cell) return;
+        unlink(id);
+    }
+    else
+    {
+        point.used = true;
+        ++m_size;
+    }
+
+    std::vector<std::uint32_t> &ids = m_cells[cell];
+    point.cell = cell;
+    point.cellIndex = static_cast<std::uint32_t>(ids.size());
+    ids.push_back(id);
+}
+
+void SpatialGrid::remove(std::uint32_t id)
+{
+    if(!contains(id)) return;
+    unlink(id);
+    m_points[id].used = false;
+    --m_size;
+}
+
+bool SpatialGrid::contains(std::uint32_t id) const
+{
+    return id < m_points.size() && m_points[id].used;
+}
+
+const Vec3& SpatialGrid::getPosition(std::uint32_t id) const
+{
+    if(!contains(id)) throw std::out_of_range("SpatialGrid does not contain the point");
+    return m_points[id].position;
+}
+
+std::size_t SpatialGrid::getSize() const
+{
+    return m_size;
+}
+
+void SpatialGrid::clear()
+{
+    m_points.clear();
+    m_cells.clear();
+    m_size = 0;
+}
+
+void SpatialGrid::query(const Vec3 &center, float radius, std::vector<std::uint32_t> &ids) const
+{
+    if(radius < 0.f || m_size == 0) return;
+
+    float radius2 = radius * radius;
+    std::int32_t minX = getCellCoordinate(center.x - radius), maxX = getCellCoordinate(center.x + radius);
+    std::int32_t minY = getCellCoordinate(center.y - radius), maxY = getCellCoordinate(center.y + radius);
+    std::int32_t minZ = getCellCoordinate(center.z - radius), maxZ = getCellCoordinate(center.z + radius);
+
+    // A sphere that overlaps more cells than are stored is answered by visiting the stored ones instead
+    double cellCount = (maxX - minX + 1.0) * (maxY - minY + 1.0) * (maxZ - minZ + 1.0);
+    if(cellCount > static_cast<double>(m_cells.size()))
+    {
+        for(const auto &[key, cell] : m_cells) queryCell(cell, center, radius2, ids);
+        return;
+    }
+
+    for(std::int32_t x = minX; x <= maxX; ++x)
+    {
+        for(std::int32_t y = minY; y <= maxY; ++y)
+        {
+            for(std::int32_t z = minZ; z <= maxZ; ++z)
+            {
+                auto found = m_cells.find(getCellKey(x, y, z));
+                if(found != m_cells.end()) queryCell(found->second, center, radius2, ids);
+            }
+        }
+    }
+}
+
+std::int32_t SpatialGrid::getCellCoordinate(float coordinate) const
+{
+    float cell = std::floor(coordinate / m_cellSize);
+    // Also maps NaN to a cell, since it fails both comparisons
+    if(!(cell > -MAX_CELL)) return -MAX_CELL;
+    if(!(cell < MAX_CELL)) return MAX_CELL;
+    return static_cast<std::int32_t>(cell);
+}
+
+std::uint64_t SpatialGrid::getCellKey(std::int32_t x, std::int32_t y, std::int32_t z)
+{
+    constexpr std::uint64_t mask = (std::uint64_t(1) << 21) - 1;
+    return (static_cast<std::uint64_t>(x) & mask) | ((static_cast<std::uint64_t>(y) & mask) << 21) | ((static_cast<std::uint64_t>(z) & mask) << 42);
+}
+
+void SpatialGrid::queryCell(const std::vector<std::uint32_t> &cell, const Vec3 &center, float radius2, std::vector<std::uint32_t> &ids) const
+{
+    for(std::uint32_t id : cell)
+    {
+        Vec3 offset = m_points[id].position - center;
+        if(offset.magnitude2() <= radius2) ids.push_back(id);
+    }
+}
+
+void SpatialGrid::unlink(std::uint32_t id)
+{
+    Point &point = m_points[id];
+    auto found = m_cells.find(point.cell);
+    std::vector<std::uint32_t> &ids = found->second;
+    ids[point.cellIndex] = ids.back();
+    m_points[ids.back()].cellIndex = point.cellIndex;
+    ids.pop_back();
+    if(ids.empty()) m_cells.erase(found);
+}
+
+} // namespace sfex
\ No newline at end of file
@@ -0,0 +1,230 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/TaskGraph.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace sfex
+{
+
+TaskGraph::NodeId TaskGraph::addNode(const std::string &name, std::function<void()> work)
+{
+    Node node;
+    node.name = name;
+    node.work = std::move(work);
+    m_nodes.push_back(std::move(node));
+    m_prepared = false;
+    return m_nodes.size() - 1;
+}
+
+void TaskGraph::addEdge(NodeId before, NodeId after)
+{
+    if(before >= m_nodes.size() || after >= m_nodes.size())
+    {
+        throw std::invalid_argument("TaskGraph::addEdge: node does not exist!");
+    }
+    if(before == after)
+    {
+        throw std::invalid_argument("TaskGraph::addEdge: a node can not depend on itself!");
+    }
+
+    m_nodes[before].successors.push_back(after);
+    m_nodes[after].predecessors.push_back(before);
+    m_prepared = false;
+}
+
+void TaskGraph::clear()
+{
+    m_nodes.clear();
+    m_order.clear();
+    m_roots.clear();
+    m_remainingPredecessors.reset();
+    m_criticalPathEnd = InvalidNode;
+    m_lastDuration = sf::Time::Zero;
+    m_prepared = false;
+}
+
+std::size_t TaskGraph::getNodeCount() const
+{
+    return m_nodes.size();
+}
+
+const std::string& TaskGraph::getNodeName(NodeId node) const
+{
+    return m_nodes.at(node).name;
+}
+
+void TaskGraph::run(WorkerPool &pool)
+{
+    prepare();
+    if(m_nodes.empty()) return;
+
+    for(NodeId i = 0; i < m_nodes.size(); ++i)
+    {
+        m_remainingPredecessors[i].store(m_nodes[i].predecessors.size(), std::memory_order_relaxed);
+    }
+    m_pool = &pool;
+    m_exception = nullptr;
+    m_pendingNodes.store(m_nodes.size(), std::memory_order_release);
+    m_clock.restart();
+
+    for(std::size_t i = 1; i < m_roots.size(); ++i)
+    {
+        NodeId root = m_roots[i];
+        pool.push([this, root](){ runFrom(root); });
+    }
+    runFrom(m_roots.front());
+
+    while(m_pendingNodes.load(std::memory_order_acquire) != 0)
+    {
+        if(!pool.runPendingTask()) std::this_thread::yield();
+    }
+    m_lastDuration = m_clock.getElapsedTime();
+    computeCriticalPath();
+
+    if(m_exception) std::rethrow_exception(m_exception);
+}
+
+sf::Time TaskGraph::getLastDuration() const
+{
+    return m_lastDuration;
+}
+
+sf::Time TaskGraph::getNodeDuration(NodeId node) const
+{
+    const Node &n = m_nodes.at(node);
+    return n.end - n.start;
+}
+
+sf::Time TaskGraph::getCriticalPathDuration() const
+{
+    if(m_criticalPathEnd == InvalidNode) return sf::Time::Zero;
+    return m_nodes[m_criticalPathEnd].pathDuration;
+}
+
+std::vector<TaskGraph::NodeId> TaskGraph::getCriticalPath() const
+{
+    std::vector<NodeId> path;
+    for(NodeId node = m_criticalPathEnd; node != InvalidNode; node = m_nodes[node].criticalPredecessor)
+    {
+        path.push_back(node);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void TaskGraph::prepare()
+{
+    if(m_prepared) return;
+
+    // Kahn's algorithm. The resulting order is used to compute the critical path without recursion.
+    std::vector<std::size_t> inDegree(m_nodes.size());
+    m_order.clear();
+    m_roots.clear();
+    for(NodeId i = 0; i < m_nodes.size(); ++i)
+    {
+        inDegree[i] = m_nodes[i].predecessors.size();
+        if(inDegree[i] == 0)
+        {
+            m_order.push_back(i);
+            m_roots.push_back(i);
+        }
+    }
+    for(std::size_t i = 0; i < m_order.size(); ++i)
+    {
+        for(NodeId successor : m_nodes[m_order[i]].successors)
+        {
+            if(--inDegree[successor] == 0) m_order.push_back(successor);
+        }
+    }
+    if(m_order.size() != m_nodes.size())
+    {
+        throw std::runtime_error("TaskGraph contains a cycle!");
+    }
+
+    m_remainingPredecessors = std::make_unique<std::atomic<std::size_t>[]>(m_nodes.size());
+    m_criticalPathEnd = InvalidNode;
+    m_prepared = true;
+}
+
+void TaskGraph::runFrom(NodeId node)
+{
+    while(node != InvalidNode)
+    {
+        Node &current = m_nodes[node];
+        current.start = m_clock.getElapsedTime();
+        try
+        {
+            if(current.work) current.work();
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(m_exceptionMutex);
+            if(!m_exception) m_exception = std::current_exception();
+        }
+        current.end = m_clock.getElapsedTime();
+
+        NodeId next = InvalidNode;
+        for(NodeId successor : current.successors)
+        {
+            if(m_remainingPredecessors[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+
+            if(next == InvalidNode) next = successor;
+            else m_pool->push([this, successor](){ runFrom(successor); });
+        }
+
+        m_pendingNodes.fetch_sub(1, std::memory_order_acq_rel);
+        node = next;
+    }
+}
+
+void TaskGraph::computeCriticalPath()
+{
+    m_criticalPathEnd = InvalidNode;
+    for(NodeId id : m_order)
+    {
+        Node &node = m_nodes[id];
+        node.criticalPredecessor = InvalidNode;
+        sf::Time longestInput = sf::Time::Zero;
+        for(NodeId predecessor : node.predecessors)
+        {
+            if(node.criticalPredecessor == InvalidNode || m_nodes[predecessor].pathDuration > longestInput)
+            {
+                longestInput = m_nodes[predecessor].pathDuration;
+                node.criticalPredecessor = predecessor;
+            }
+        }
+        node.pathDuration = longestInput + (node.end - node.start);
+
+        // Ties go to the node that comes later in topological order, so zero cost nodes at the end of a chain stay on the path
+        if(m_criticalPathEnd == InvalidNode || node.pathDuration >= m_nodes[m_criticalPathEnd].pathDuration)
+        {
+            m_criticalPathEnd = id;
+        }
+    }
+}
+
+} // namespace sfex
@@ -0,0 +1,386 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/General/WorkerPool.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace sfex
+{
+
+namespace
+{
+    thread_local const WorkerPool *t_currentPool = nullptr;
+    thread_local std::size_t t_workerIndex = 0;
+}
+
+namespace impl
+{
+
+Task::Task(Task&& other) noexcept
+{
+    moveFrom(other);
+}
+
+Task& Task::operator=(Task&& other) noexcept
+{
+    if(this != &other)
+    {
+        reset();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+Task::~Task()
+{
+    reset();
+}
+
+void Task::operator()()
+{
+    m_callable->run();
+}
+
+Task::operator bool() const
+{
+    return m_callable != nullptr;
+}
+
+bool Task::isInline() const
+{
+    return static_cast<const void*>(m_callable) == static_cast<const void*>(m_buffer);
+}
+
+void Task::moveFrom(Task &other)
+{
+    if(!other.m_callable) return;
+
+    if(other.isInline())
+    {
+        m_callable = other.m_callable->moveTo(m_buffer);
+        other.reset();
+    }
+    else
+    {
+        m_callable = other.m_callable;
+        other.m_callable = nullptr;
+    }
+}
+
+void Task::reset()
+{
+    if(!m_callable) return;
+
+    if(isInline()) m_callable->~Concept();
+    else delete m_callable;
+    m_callable = nullptr;
+}
+
+bool TaskQueue::empty() const
+{
+    return m_size == 0;
+}
+
+void TaskQueue::pushBack(Task task)
+{
+    if(m_size == m_slots.size()) grow();
+    m_slots[(m_head + m_size) % m_slots.size()] = std::move(task);
+    ++m_size;
+}
+
+Task TaskQueue::popBack()
+{
+    --m_size;
+    return std::move(m_slots[(m_head + m_size) % m_slots.size()]);
+}
+
+Task TaskQueue::popFront()
+{
+    Task task = std::move(m_slots[m_head]);
+    m_head = (m_head + 1) % m_slots.size();
+    --m_size;
+    return task;
+}
+
+void TaskQueue::grow()
+{
+    std::vector<Task> slots(std::max<std::size_t>(m_slots.size() * 2, 64));
+    for(std::size_t i = 0; i < m_size; ++i)
+    {
+        slots[i] = std::move(m_slots[(m_head + i) % m_slots.size()]);
+    }
+    m_slots.swap(slots);
+    m_head = 0;
+}
+
+} // namespace impl
+
+WorkerPool::WorkerPool(std::size_t workerCount, std::size_t realtimeWorkerCount):
+    m_laneSequence(0), m_nextWorker(0), m_queuedTasks(0), m_sleepingWorkers(0), m_sleepingRealtimeWorkers(0), m_running(true)
+{
+    if(workerCount == 0) workerCount = std::thread::hardware_concurrency();
+    if(workerCount == 0) workerCount = 1;
+
+    m_workers.reserve(workerCount);
+    for(std::size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // Workers may steal from each other right away, so every deque has to exist before the first thread starts
+    for(std::size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers[i]->thread = std::thread(&WorkerPool::workerLoop, this, i);
+    }
+
+    m_realtimeWorkers.reserve(realtimeWorkerCount);
+    for(std::size_t i = 0; i < realtimeWorkerCount; ++i)
+    {
+        m_realtimeWorkers.emplace_back(&WorkerPool::realtimeWorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    m_running = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_all();
+    m_realtimeCondition.notify_all();
+
+    for(auto &worker : m_workers)
+    {
+        worker->thread.join();
+    }
+    for(auto &thread : m_realtimeWorkers)
+    {
+        thread.join();
+    }
+
+    // Continuations scheduled by the very last tasks may arrive after the workers have left
+    impl::Task task;
+    while(takeTask(m_workers.size(), task))
+    {
+        task();
+        task = impl::Task();
+    }
+}
+
+std::size_t WorkerPool::getWorkerCount() const
+{
+    return m_workers.size();
+}
+
+std::size_t WorkerPool::getRealtimeWorkerCount() const
+{
+    return m_realtimeWorkers.size();
+}
+
+std::uint64_t WorkerPool::getMissedDeadlineCount(Priority priority) const
+{
+    return m_lanes[static_cast<std::size_t>(priority)].missedDeadlines;
+}
+
+void WorkerPool::push(impl::Task task)
+{
+    std::size_t index = currentWorkerIndex();
+    if(index == m_workers.size())
+    {
+        index = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.pushBack(std::move(task));
+    }
+    m_queuedTasks.fetch_add(1);
+    wakeWorker(Priority::Normal);
+}
+
+void WorkerPool::push(impl::Task task, Priority priority)
+{
+    if(priority == Priority::Normal)
+    {
+        push(std::move(task));
+        return;
+    }
+
+    // Tasks without a deadline go after every task with one and keep their order among themselves
+    pushToLane(std::move(task), priority, sf::microseconds(std::numeric_limits<sf::Int64>::max()));
+}
+
+void WorkerPool::pushToLane(impl::Task task, Priority priority, const sf::Time &deadline)
+{
+    Lane &lane = m_lanes[static_cast<std::size_t>(priority)];
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.tasks.push_back({deadline, m_laneSequence.fetch_add(1, std::memory_order_relaxed), std::move(task)});
+        std::push_heap(lane.tasks.begin(), lane.tasks.end(), &WorkerPool::isLater);
+        lane.size.fetch_add(1);
+    }
+    m_queuedTasks.fetch_add(1);
+    wakeWorker(priority);
+}
+
+void WorkerPool::wakeWorker(Priority priority)
+{
+    bool wakeRealtime = priority == Priority::Realtime && m_sleepingRealtimeWorkers.load() != 0;
+    bool wakeWorker = m_sleepingWorkers.load() != 0;
+    if(!wakeRealtime && !wakeWorker) return;
+
+    // A worker that is about to sleep holds this mutex while it checks the queued task counts, so it either sees the new task or gets notified
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    if(wakeRealtime) m_realtimeCondition.notify_one();
+    if(wakeWorker) m_sleepCondition.notify_one();
+}
+
+bool WorkerPool::runPendingTask()
+{
+    impl::Task task;
+    if(!takeTask(currentWorkerIndex(), task)) return false;
+
+    task();
+    return true;
+}
+
+void WorkerPool::workerLoop(std::size_t index)
+{
+    t_currentPool = this;
+    t_workerIndex = index;
+
+    impl::Task task;
+    while(true)
+    {
+        if(takeTask(index, task))
+        {
+            task();
+            task = impl::Task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkers.fetch_add(1);
+        m_sleepCondition.wait(lock, [this](){ return m_queuedTasks.load() != 0 || !m_running.load(); });
+        m_sleepingWorkers.fetch_sub(1);
+
+        if(!m_running && m_queuedTasks.load() == 0) break;
+    }
+}
+
+void WorkerPool::realtimeWorkerLoop()
+{
+    Lane &lane = m_lanes[static_cast<std::size_t>(Priority::Realtime)];
+    impl::Task task;
+    while(true)
+    {
+        if(popLaneTask(Priority::Realtime, task))
+        {
+            task();
+            task = impl::Task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingRealtimeWorkers.fetch_add(1);
+        m_realtimeCondition.wait(lock, [this, &lane](){ return lane.size.load() != 0 || !m_running.load(); });
+        m_sleepingRealtimeWorkers.fetch_sub(1);
+
+        if(!m_running && lane.size.load() == 0) break;
+    }
+}
+
+bool WorkerPool::takeTask(std::size_t index, impl::Task &task)
+{
+    if(popLaneTask(Priority::Realtime, task) || popLaneTask(Priority::High, task) || popLaneTask(Priority::Normal, task)) return true;
+
+    if(index < m_workers.size())
+    {
+        if(popTask(index, task) || stealTask(index + 1, task)) return true;
+    }
+    else if(stealTask(m_nextWorker.load(std::memory_order_relaxed), task))
+    {
+        return true;
+    }
+
+    return popLaneTask(Priority::Background, task);
+}
+
+bool WorkerPool::popLaneTask(Priority priority, impl::Task &task)
+{
+    Lane &lane = m_lanes[static_cast<std::size_t>(priority)];
+    if(lane.size.load(std::memory_order_relaxed) == 0) return false;
+
+    std::lock_guard<std::mutex> lock(lane.mutex);
+    if(lane.tasks.empty()) return false;
+
+    std::pop_heap(lane.tasks.begin(), lane.tasks.end(), &WorkerPool::isLater);
+    task = std::move(lane.tasks.back().task);
+    lane.tasks.pop_back();
+    lane.size.fetch_sub(1);
+    m_queuedTasks.fetch_sub(1);
+    return true;
+}
+
+bool WorkerPool::isLater(const LaneTask &left, const LaneTask &right)
+{
+    if(left.deadline != right.deadline) return left.deadline > right.deadline;
+    return left.sequence > right.sequence;
+}
+
+bool WorkerPool::popTask(std::size_t index, impl::Task &task)
+{
+    Worker &worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if(worker.tasks.empty()) return false;
+
+    task = worker.tasks.popBack();
+    m_queuedTasks.fetch_sub(1);
+    return true;
+}
+
+bool WorkerPool::stealTask(std::size_t start, impl::Task &task)
+{
+    for(std::size_t i = 0; i < m_workers.size(); ++i)
+    {
+        Worker &worker = *m_workers[(start + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if(worker.tasks.empty()) continue;
+
+        task = worker.tasks.popFront();
+        m_queuedTasks.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+std::size_t WorkerPool::currentWorkerIndex() const
+{
+    if(t_currentPool == this) return t_workerIndex;
+    return m_workers.size();
+}
+
+} // namespace sfex
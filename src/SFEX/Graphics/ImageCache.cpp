@@ -0,0 +1,249 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/Graphics/ImageCache.hpp>
+#include <SFEX/General/Hash.hpp>
+#include <SFEX/General/Lz4.hpp>
+#include "../General/FileIo.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace sfex
+{
+
+namespace
+{
+
+// Layout, all integers little endian:
+// Header: "SFEXIMG\0", u32 version, u32 flags, u64 modification time of the source, u64 size of the source,
+// u64 xxHash64 of the source, u32 width, u32 height, u64 size of the pixel data, u64 reserved
+// Pixel data, RGBA row by row, optionally LZ4 compressed
+const char ImageSignature[8] = {'S', 'F', 'E', 'X', 'I', 'M', 'G', '\0'};
+constexpr std::uint32_t ImageVersion = 1;
+constexpr std::size_t HeaderSize = 64;
+constexpr std::size_t TimeOffset = 16;
+constexpr std::uint32_t CompressedFlag = 1;
+const char CacheExtension[] = ".sfeximg";
+
+bool getSourceStamp(const std::string &filename, std::uint64_t &time, std::uint64_t &size)
+{
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(filename, error);
+    if(error) return false;
+    auto writeTime = std::filesystem::last_write_time(filename, error);
+    if(error) return false;
+
+    time = static_cast<std::uint64_t>(writeTime.time_since_epoch().count());
+    size = static_cast<std::uint64_t>(fileSize);
+    return true;
+}
+
+} // namespace
+
+const Vec2u& ImageCache::Entry::getSize() const
+{
+    return m_size;
+}
+
+const std::uint8_t* ImageCache::Entry::getPixels() const
+{
+    return m_pixels;
+}
+
+std::uint64_t ImageCache::Entry::getContentHash() const
+{
+    return m_contentHash;
+}
+
+ImageCache::ImageCache(const std::string &directory, bool compress):
+    m_directory(directory), m_compress(compress)
+{
+}
+
+void ImageCache::setDirectory(const std::string &directory)
+{
+    m_directory = directory;
+}
+
+const std::string& ImageCache::getDirectory() const
+{
+    return m_directory;
+}
+
+void ImageCache::setCompression(bool compress)
+{
+    m_compress = compress;
+}
+
+bool ImageCache::isCompressing() const
+{
+    return m_compress;
+}
+
+bool ImageCache::isEnabled() const
+{
+    return !m_directory.empty();
+}
+
+bool ImageCache::find(const std::string &filename, Entry &entry) const
+{
+    std::uint64_t sourceTime, sourceSize;
+    if(!isEnabled() || !getSourceStamp(filename, sourceTime, sourceSize)) return false;
+
+    std::string cachePath = getCachePath(filename);
+    MappedFile file;
+    if(!file.open(cachePath) || file.getSize() < HeaderSize) return false;
+
+    const char *header = file.getData();
+    if(std::memcmp(header, ImageSignature, sizeof(ImageSignature)) != 0 || impl::readInteger(header + 8, 4) != ImageVersion) return false;
+
+    std::uint32_t flags = static_cast<std::uint32_t>(impl::readInteger(header + 12, 4));
+    std::uint64_t time = impl::readInteger(header + TimeOffset, 8);
+    std::uint64_t contentHash = impl::readInteger(header + 32, 8);
+    Vec2u size(static_cast<unsigned int>(impl::readInteger(header + 40, 4)), static_cast<unsigned int>(impl::readInteger(header + 44, 4)));
+    std::uint64_t payloadSize = impl::readInteger(header + 48, 8);
+    std::uint64_t pixelBytes = static_cast<std::uint64_t>(size.x) * size.y * 4;
+    bool compressed = (flags & CompressedFlag) != 0;
+
+    if(impl::readInteger(header + 24, 8) != sourceSize || pixelBytes == 0) return false;
+    if(payloadSize != file.getSize() - HeaderSize || (!compressed && payloadSize != pixelBytes)) return false;
+
+    if(time != sourceTime)
+    {
+        // A touched or copied source is still valid if its content is unchanged. Storing the new time skips hashing it next time.
+        std::vector<char> data;
+        if(!impl::readFile(filename, data) || xxHash64(data.data(), data.size()) != contentHash) return false;
+
+        std::vector<char> bytes;
+        impl::writeInteger(bytes, sourceTime, 8);
+        std::fstream cacheFile(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+        cacheFile.seekp(TimeOffset);
+        cacheFile.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    entry.m_buffer.clear();
+    if(compressed)
+    {
+        entry.m_buffer.resize(static_cast<std::size_t>(pixelBytes));
+        if(!Lz4::decompress(header + HeaderSize, static_cast<std::size_t>(payloadSize), entry.m_buffer.data(), entry.m_buffer.size())) return false;
+
+        entry.m_pixels = entry.m_buffer.data();
+        entry.m_file.close();
+    }
+    else
+    {
+        entry.m_pixels = reinterpret_cast<const std::uint8_t*>(header + HeaderSize);
+        entry.m_file = std::move(file);
+    }
+    entry.m_size = size;
+    entry.m_contentHash = contentHash;
+    return true;
+}
+
+bool ImageCache::store(const std::string &filename, std::uint64_t contentHash, const Vec2u &size, const std::uint8_t *pixels) const
+{
+    std::uint64_t sourceTime, sourceSize;
+    if(!isEnabled() || size.x == 0 || size.y == 0 || !getSourceStamp(filename, sourceTime, sourceSize)) return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if(error) return false;
+
+    std::size_t pixelBytes = static_cast<std::size_t>(size.x) * size.y * 4;
+    std::vector<char> payload;
+    if(m_compress) payload = Lz4::compress(pixels, pixelBytes);
+    bool compressed = m_compress && payload.size() < pixelBytes;
+    const char *data = compressed ? payload.data() : reinterpret_cast<const char*>(pixels);
+    std::size_t dataSize = compressed ? payload.size() : pixelBytes;
+
+    std::vector<char> header(ImageSignature, ImageSignature + sizeof(ImageSignature));
+    impl::writeInteger(header, ImageVersion, 4);
+    impl::writeInteger(header, compressed ? CompressedFlag : 0, 4);
+    impl::writeInteger(header, sourceTime, 8);
+    impl::writeInteger(header, sourceSize, 8);
+    impl::writeInteger(header, contentHash, 8);
+    impl::writeInteger(header, size.x, 4);
+    impl::writeInteger(header, size.y, 4);
+    impl::writeInteger(header, dataSize, 8);
+    impl::writeInteger(header, 0, 8);
+
+    // Writing to a temporary file first keeps readers and other threads storing the same image from seeing a partial file
+    std::string cachePath = getCachePath(filename);
+    std::string tempPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if(!file) return false;
+
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(data, static_cast<std::streamsize>(dataSize));
+        if(!file.flush())
+        {
+            file.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if(!error) return true;
+
+    std::filesystem::remove(tempPath, error);
+    return false;
+}
+
+void ImageCache::clear() const
+{
+    if(!isEnabled()) return;
+
+    std::error_code error;
+    for(std::filesystem::directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error))
+    {
+        const std::filesystem::path &path = it->path();
+        std::string name = path.filename().string();
+        if(path.extension() == CacheExtension || name.find(std::string(CacheExtension) + ".") != std::string::npos)
+        {
+            std::error_code removeError;
+            std::filesystem::remove(path, removeError);
+        }
+    }
+}
+
+std::string ImageCache::getCachePath(const std::string &filename) const
+{
+    // Every spelling of a path has to map to the same cache file
+    std::error_code error;
+    std::string source = std::filesystem::absolute(filename, error).lexically_normal().string();
+    if(error) source = filename;
+
+    static const char digits[] = "0123456789abcdef";
+    std::uint64_t hash = xxHash64(source.data(), source.size());
+    std::string name(16, '0');
+    for(std::size_t i = 0; i < 16; ++i) name[15 - i] = digits[(hash >> (4 * i)) & 0xF];
+    return (std::filesystem::path(m_directory) / (name + CacheExtension)).string();
+}
+
+} // namespace sfex
\ No newline at end of file
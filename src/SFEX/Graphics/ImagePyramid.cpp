@@ -0,0 +1,158 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/Graphics/ImagePyramid.hpp>
+#include <algorithm>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SFEX_IMAGE_PYRAMID_SSE2
+#endif
+
+namespace sfex
+{
+
+namespace
+{
+
+/// @brief Width of the source times the target rows of one task, so every task reads about 64 KiB of source pixels
+constexpr std::size_t GRAIN_PIXELS = 8192;
+
+void downscaleRow(const std::uint8_t *row0, const std::uint8_t *row1, unsigned int sourceWidth, std::uint8_t *target, unsigned int targetWidth)
+{
+    unsigned int x = 0;
+
+#ifdef SFEX_IMAGE_PYRAMID_SSE2
+    // Four target pixels at a time from eight source pixels of both rows, summed in 16 bits so the rounding matches the scalar path
+    if(sourceWidth > 1)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        for(; 2 * (x + 4) <= sourceWidth; x += 4)
+        {
+            __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x));
+            __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x + 16));
+            __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x));
+            __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x + 16));
+
+            // Each register holds the vertical sums of two neighbouring source pixels
+            __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+            __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+            __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+            __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+            __m128i t01 = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+            __m128i t23 = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+            t01 = _mm_srli_epi16(_mm_add_epi16(t01, two), 2);
+            t23 = _mm_srli_epi16(_mm_add_epi16(t23, two), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4 * x), _mm_packus_epi16(t01, t23));
+        }
+    }
+#endif
+
+    for(; x < targetWidth; ++x)
+    {
+        // A side of 1 pixel has no second column, so the same one is used twice
+        unsigned int x0 = 2 * x;
+        unsigned int x1 = std::min(x0 + 1, sourceWidth - 1);
+        for(unsigned int c = 0; c < 4; ++c)
+        {
+            unsigned int sum = row0[4 * x0 + c] + row0[4 * x1 + c] + row1[4 * x0 + c] + row1[4 * x1 + c];
+            target[4 * x + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+        }
+    }
+}
+
+} // namespace
+
+void ImagePyramid::build(const std::uint8_t *pixels, const Vec2u &size, std::size_t levelCount, WorkerPool *pool)
+{
+    m_levels.clear();
+    if(size.x == 0 || size.y == 0) return;
+
+    m_levels.push_back(Level{size, std::vector<std::uint8_t>(pixels, pixels + static_cast<std::size_t>(size.x) * size.y * 4)});
+    while((levelCount == 0 || m_levels.size() < levelCount) && (m_levels.back().size.x > 1 || m_levels.back().size.y > 1))
+    {
+        Vec2u levelSize = getDownscaledSize(m_levels.back().size);
+        Level level{levelSize, std::vector<std::uint8_t>(static_cast<std::size_t>(levelSize.x) * levelSize.y * 4)};
+        downscale(m_levels.back().pixels.data(), m_levels.back().size, level.pixels.data(), pool);
+        m_levels.push_back(std::move(level));
+    }
+}
+
+std::size_t ImagePyramid::getLevelCount() const
+{
+    return m_levels.size();
+}
+
+const Vec2u& ImagePyramid::getLevelSize(std::size_t level) const
+{
+    return m_levels.at(level).size;
+}
+
+const std::uint8_t* ImagePyramid::getLevelPixels(std::size_t level) const
+{
+    return m_levels.at(level).pixels.data();
+}
+
+std::size_t ImagePyramid::findLevel(const Vec2u &size) const
+{
+    std::size_t found = 0;
+    for(std::size_t level = 1; level < m_levels.size(); ++level)
+    {
+        if(m_levels[level].size.x < size.x || m_levels[level].size.y < size.y) break;
+        found = level;
+    }
+    return found;
+}
+
+Vec2u ImagePyramid::getDownscaledSize(const Vec2u &size)
+{
+    return Vec2u(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u));
+}
+
+void ImagePyramid::downscale(const std::uint8_t *source, const Vec2u &sourceSize, std::uint8_t *target, WorkerPool *pool)
+{
+    assert(sourceSize.x > 0 && sourceSize.y > 0);
+
+    Vec2u targetSize = getDownscaledSize(sourceSize);
+    std::size_t sourceStride = static_cast<std::size_t>(sourceSize.x) * 4;
+    std::size_t targetStride = static_cast<std::size_t>(targetSize.x) * 4;
+    auto downscaleTargetRow = [&](unsigned int y){
+        unsigned int y0 = 2 * y;
+        unsigned int y1 = std::min(y0 + 1, sourceSize.y - 1);
+        downscaleRow(source + y0 * sourceStride, source + y1 * sourceStride, sourceSize.x, target + y * targetStride, targetSize.x);
+    };
+
+    std::size_t grain = std::max<std::size_t>(GRAIN_PIXELS / sourceSize.x, 1);
+    if(!pool || targetSize.y <= grain)
+    {
+        for(unsigned int y = 0; y < targetSize.y; ++y) downscaleTargetRow(y);
+        return;
+    }
+    pool->parallel_for(Range<unsigned int>{0, targetSize.y}, grain, downscaleTargetRow);
+}
+
+} // namespace sfex
\ No newline at end of file
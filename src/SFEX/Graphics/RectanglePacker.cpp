@@ -0,0 +1,130 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/Graphics/RectanglePacker.hpp>
+#include <algorithm>
+
+namespace sfex
+{
+
+RectanglePacker::RectanglePacker(const Vec2u &size):
+    m_size(size), m_usedSize(0, 0), m_skyline()
+{
+    clear();
+}
+
+bool RectanglePacker::insert(const Vec2u &size, Vec2u &position)
+{
+    if(size.x == 0 || size.y == 0) return false;
+
+    std::size_t bestIndex = m_skyline.size();
+    unsigned int bestY = 0;
+
+    // Bottom-left: prefer the position where the top of the rectangle ends up lowest, then the leftmost one
+    for(std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        unsigned int y;
+        if(!fit(i, size, y)) continue;
+
+        if(bestIndex == m_skyline.size() || y + size.y < bestY + size.y)
+        {
+            bestIndex = i;
+            bestY = y;
+        }
+    }
+    if(bestIndex == m_skyline.size()) return false;
+
+    position = Vec2u(m_skyline[bestIndex].x, bestY);
+    m_skyline.insert(m_skyline.begin() + bestIndex, Segment{position.x, bestY + size.y, size.x});
+
+    // Cut the segments that are now covered by the new one
+    for(std::size_t i = bestIndex + 1; i < m_skyline.size();)
+    {
+        const Segment &previous = m_skyline[i - 1];
+        Segment &segment = m_skyline[i];
+        unsigned int previousEnd = previous.x + previous.width;
+        if(segment.x >= previousEnd) break;
+
+        unsigned int overlap = previousEnd - segment.x;
+        if(overlap >= segment.width)
+        {
+            m_skyline.erase(m_skyline.begin() + i);
+            continue;
+        }
+
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+
+    // Merge neighbouring segments at the same height
+    for(std::size_t i = 1; i < m_skyline.size();)
+    {
+        if(m_skyline[i - 1].y == m_skyline[i].y)
+        {
+            m_skyline[i - 1].width += m_skyline[i].width;
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+        else ++i;
+    }
+
+    m_usedSize.x = std::max(m_usedSize.x, position.x + size.x);
+    m_usedSize.y = std::max(m_usedSize.y, position.y + size.y);
+    return true;
+}
+
+void RectanglePacker::clear()
+{
+    m_skyline.assign(1, Segment{0, 0, m_size.x});
+    m_usedSize = Vec2u(0, 0);
+}
+
+const Vec2u& RectanglePacker::getSize() const
+{
+    return m_size;
+}
+
+const Vec2u& RectanglePacker::getUsedSize() const
+{
+    return m_usedSize;
+}
+
+bool RectanglePacker::fit(std::size_t index, const Vec2u &size, unsigned int &y) const
+{
+    unsigned int x = m_skyline[index].x;
+    if(size.x > m_size.x - x) return false;
+
+    y = 0;
+    unsigned int widthLeft = size.x;
+    for(std::size_t i = index; widthLeft > 0; ++i)
+    {
+        y = std::max(y, m_skyline[i].y);
+        if(size.y > m_size.y - y) return false;
+
+        widthLeft -= std::min(widthLeft, m_skyline[i].width);
+    }
+    return true;
+}
+
+} // namespace sfex
\ No newline at end of file
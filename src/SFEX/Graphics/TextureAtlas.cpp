@@ -0,0 +1,229 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/Graphics/TextureAtlas.hpp>
+#include <SFEX/Graphics/RectanglePacker.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace sfex
+{
+
+namespace
+{
+
+const char AtlasSignature[] = "SFEXAtlas";
+const int AtlasVersion = 1;
+
+std::string getPageFilename(const std::string &filename, std::size_t page)
+{
+    return filename + "." + std::to_string(page) + ".png";
+}
+
+} // namespace
+
+TextureAtlas::TextureAtlas(unsigned int pageSize, unsigned int padding):
+    m_pageSize(pageSize), m_padding(padding), m_images(), m_regions(), m_pages()
+{
+}
+
+void TextureAtlas::add(const std::string &key, const sf::Image &image)
+{
+    m_images[key] = image;
+}
+
+bool TextureAtlas::addFromFile(const std::string &key, const std::string &filename)
+{
+    sf::Image image;
+    if(!image.loadFromFile(filename)) return false;
+
+    m_images[key] = std::move(image);
+    return true;
+}
+
+bool TextureAtlas::build()
+{
+    // Packing tall images first gives flatter skylines. Ties are broken by key so the result does not depend on the insertion order.
+    std::vector<const std::pair<const std::string, sf::Image>*> order;
+    order.reserve(m_images.size());
+    for(const auto &pair : m_images) order.push_back(&pair);
+
+    std::stable_sort(order.begin(), order.end(), [](const auto *a, const auto *b){
+        sf::Vector2u sizeA = a->second.getSize();
+        sf::Vector2u sizeB = b->second.getSize();
+        if(sizeA.y != sizeB.y) return sizeA.y > sizeB.y;
+        return sizeA.x > sizeB.x;
+    });
+
+    // The padding is reserved on the right and bottom of every image, so each page gets room for the padding of its last row and column
+    Vec2u packerSize(m_pageSize + m_padding, m_pageSize + m_padding);
+    std::vector<RectanglePacker> packers;
+    std::map<std::string, Region> regions;
+
+    for(const auto *pair : order)
+    {
+        sf::Vector2u imageSize = pair->second.getSize();
+        Vec2u reserved(imageSize.x + m_padding, imageSize.y + m_padding);
+        Vec2u position;
+
+        std::size_t page = 0;
+        while(page < packers.size() && !packers[page].insert(reserved, position)) ++page;
+        if(page == packers.size())
+        {
+            packers.emplace_back(packerSize);
+            if(!packers.back().insert(reserved, position)) return false;
+        }
+
+        regions[pair->first] = Region{page, sf::IntRect(position.x, position.y, imageSize.x, imageSize.y)};
+    }
+
+    std::vector<sf::Image> pages(packers.size());
+    for(std::size_t i = 0; i < pages.size(); ++i)
+    {
+        const Vec2u &used = packers[i].getUsedSize();
+        pages[i].create(used.x - m_padding, used.y - m_padding, sf::Color::Transparent);
+    }
+    for(const auto &pair : regions)
+    {
+        const Region &region = pair.second;
+        pages[region.page].copy(m_images[pair.first], region.rect.left, region.rect.top);
+    }
+
+    m_pages = std::move(pages);
+    m_regions = std::move(regions);
+    m_images.clear();
+    return true;
+}
+
+bool TextureAtlas::contains(const std::string &key) const
+{
+    return m_regions.find(key) != m_regions.end();
+}
+
+const TextureAtlas::Region& TextureAtlas::getRegion(const std::string &key) const
+{
+    return m_regions.at(key);
+}
+
+const std::map<std::string, TextureAtlas::Region>& TextureAtlas::getRegions() const
+{
+    return m_regions;
+}
+
+std::vector<Animation::Frame> TextureAtlas::getFrames(const std::vector<std::string> &keys, const sf::Time &duration) const
+{
+    std::vector<Animation::Frame> frames;
+    frames.reserve(keys.size());
+    for(const std::string &key : keys)
+    {
+        const Region &region = getRegion(key);
+        if(!frames.empty() && region.page != getRegion(keys.front()).page)
+        {
+            throw std::invalid_argument("Frames of an animation have to be on the same atlas page");
+        }
+        frames.push_back(Animation::Frame{region.rect, duration});
+    }
+    return frames;
+}
+
+std::size_t TextureAtlas::getPageCount() const
+{
+    return m_pages.size();
+}
+
+const sf::Image& TextureAtlas::getPage(std::size_t page) const
+{
+    return m_pages.at(page);
+}
+
+std::string TextureAtlas::getPageKey(const std::string &prefix, std::size_t page)
+{
+    return prefix + std::to_string(page);
+}
+
+bool TextureAtlas::saveToFile(const std::string &filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if(!file) return false;
+
+    file << AtlasSignature << ' ' << AtlasVersion << '\n';
+    file << m_pageSize << ' ' << m_padding << ' ' << m_pages.size() << ' ' << m_regions.size() << '\n';
+    for(const auto &pair : m_regions)
+    {
+        const Region &region = pair.second;
+        file << region.page << ' ' << region.rect.left << ' ' << region.rect.top << ' ' << region.rect.width << ' ' << region.rect.height << ' ' << pair.first << '\n';
+    }
+    if(!file) return false;
+
+    for(std::size_t i = 0; i < m_pages.size(); ++i)
+    {
+        if(!m_pages[i].saveToFile(getPageFilename(filename, i))) return false;
+    }
+    return true;
+}
+
+bool TextureAtlas::loadFromFile(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if(!file) return false;
+
+    std::string signature;
+    int version = 0;
+    unsigned int pageSize = 0;
+    unsigned int padding = 0;
+    std::size_t pageCount = 0;
+    std::size_t regionCount = 0;
+    file >> signature >> version >> pageSize >> padding >> pageCount >> regionCount;
+    if(!file || signature != AtlasSignature || version != AtlasVersion) return false;
+
+    std::map<std::string, Region> regions;
+    for(std::size_t i = 0; i < regionCount; ++i)
+    {
+        Region region;
+        file >> region.page >> region.rect.left >> region.rect.top >> region.rect.width >> region.rect.height;
+        file.get();
+
+        std::string key;
+        std::getline(file, key);
+        if(!file || region.page >= pageCount) return false;
+
+        regions[key] = region;
+    }
+
+    std::vector<sf::Image> pages(pageCount);
+    for(std::size_t i = 0; i < pageCount; ++i)
+    {
+        if(!pages[i].loadFromFile(getPageFilename(filename, i))) return false;
+    }
+
+    m_pageSize = pageSize;
+    m_padding = padding;
+    m_pages = std::move(pages);
+    m_regions = std::move(regions);
+    return true;
+}
+
+} // namespace sfex
\ No newline at end of file
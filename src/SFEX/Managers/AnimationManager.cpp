@@ -31,20 +31,21 @@ AnimationManager::AnimationManager(): m_activeKey(std::nullopt)
 {
 }
 
-void AnimationManager::play(const std::string &key, bool restartIfSameKey)
+void AnimationManager::play(std::string_view key, bool restartIfSameKey)
 {
-    if(!this->contains(key)) return;
+    std::shared_ptr<Animation> *animation = this->get(key);
+    if(!animation) return;
     if(m_activeKey.has_value() && m_activeKey.value() == key)
     {
-        if(this->at(key)->isPaused() && restartIfSameKey) this->at(key)->play();
-        else this->at(key)->resume();
+        if((*animation)->isPaused() && restartIfSameKey) (*animation)->play();
+        else (*animation)->resume();
         return;
     }
-    if(this->at(key)->isFinished()) this->at(key)->play();
+    if((*animation)->isFinished()) (*animation)->play();
     
     if(m_activeKey.has_value()) this->at(m_activeKey.value())->pause();
-    m_activeKey = key;
-    this->at(m_activeKey.value())->play();
+    m_activeKey = std::string(key);
+    (*animation)->play();
 }
 
 void AnimationManager::pause()
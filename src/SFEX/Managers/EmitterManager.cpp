@@ -0,0 +1,352 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/Managers/EmitterManager.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace sfex
+{
+
+namespace
+{
+
+// Scales a time by a pitch in microseconds, since float seconds lose precision after a few hours
+sf::Time scaleTime(sf::Time time, double factor)
+{
+    return sf::microseconds(static_cast<sf::Int64>(static_cast<double>(time.asMicroseconds()) * factor));
+}
+
+} // namespace
+
+bool EmitterManager::Ending::operator>(const Ending &other) const
+{
+    return time > other.time;
+}
+
+EmitterManager::EmitterManager(SoundManager &sounds, std::size_t voiceCount, float cellSize):
+    m_sounds(sounds), m_grid(cellSize), m_voices(voiceCount)
+{
+}
+
+EmitterManager::EmitterId EmitterManager::play(std::string_view key, const Vec3 &position, bool loop)
+{
+    SoundManager::Handle handle = m_sounds.acquire(key);
+    const sf::Sound *source = m_sounds.get(handle);
+    if(!source || !source->getBuffer() || source->getBuffer()->getDuration() <= sf::Time::Zero) return 0;
+
+    std::uint32_t index;
+    if(!m_freeEmitters.empty())
+    {
+        index = m_freeEmitters.back();
+        m_freeEmitters.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(m_emitters.size());
+        m_emitters.emplace_back();
+    }
+
+    Emitter &emitter = m_emitters[index];
+    emitter.source = handle;
+    emitter.buffer = source->getBuffer();
+    emitter.duration = emitter.buffer->getDuration();
+    emitter.position = position;
+    emitter.start = m_time;
+    emitter.pitch = std::max(source->getPitch(), 1e-3f);
+    emitter.loop = loop;
+    emitter.active = true;
+    ++m_activeCount;
+
+    EmitterId id = (static_cast<EmitterId>(emitter.generation) << 32) | index;
+    if(!loop) m_endings.push(Ending{m_time + scaleTime(emitter.duration, 1.0 / emitter.pitch), id});
+
+    place(index, *source);
+    return id;
+}
+
+void EmitterManager::stop(EmitterId emitter)
+{
+    if(findEmitter(emitter)) release(static_cast<std::uint32_t>(emitter));
+}
+
+void EmitterManager::stopAll()
+{
+    for(std::uint32_t index = 0; index < m_emitters.size(); ++index)
+    {
+        if(m_emitters[index].active) release(index);
+    }
+    m_endings = decltype(m_endings)();
+}
+
+void EmitterManager::setPosition(EmitterId emitter, const Vec3 &position)
+{
+    Emitter *found = findEmitter(emitter);
+    if(!found) return;
+
+    found->position = position;
+    if(found->gridded) m_grid.insert(static_cast<std::uint32_t>(emitter), position);
+    if(found->voice != NO_VOICE) m_voices[found->voice].sound.setPosition(position.x, position.y, position.z);
+}
+
+Vec3 EmitterManager::getPosition(EmitterId emitter) const
+{
+    const Emitter *found = findPlaying(emitter);
+    if(!found) throw std::out_of_range("Emitter has ended");
+    return found->position;
+}
+
+bool EmitterManager::isPlaying(EmitterId emitter) const
+{
+    return findPlaying(emitter) != nullptr;
+}
+
+bool EmitterManager::isVirtual(EmitterId emitter) const
+{
+    const Emitter *found = findPlaying(emitter);
+    return found && found->voice == NO_VOICE;
+}
+
+sf::Time EmitterManager::getPlayingOffset(EmitterId emitter) const
+{
+    const Emitter *found = findPlaying(emitter);
+    return found ? getOffset(*found) : sf::Time::Zero;
+}
+
+void EmitterManager::setAudibleThreshold(float gain)
+{
+    m_threshold = std::clamp(gain, 0.f, 1.f);
+
+    // The audible radius of every emitter depends on the threshold, and emitters whose sound is gone have none
+    for(std::uint32_t index = 0; index < m_emitters.size(); ++index)
+    {
+        if(m_emitters[index].active && !getSource(m_emitters[index])) release(index);
+    }
+    m_grid.clear();
+    m_ungridded.clear();
+    m_maxRadius = 0.f;
+    for(std::uint32_t index = 0; index < m_emitters.size(); ++index)
+    {
+        if(m_emitters[index].active) place(index, *getSource(m_emitters[index]));
+    }
+}
+
+float EmitterManager::getAudibleThreshold() const
+{
+    return m_threshold;
+}
+
+std::size_t EmitterManager::getVoiceCount() const
+{
+    return m_voices.size();
+}
+
+std::size_t EmitterManager::getEmitterCount() const
+{
+    return m_activeCount;
+}
+
+std::size_t EmitterManager::getRealCount() const
+{
+    return m_realCount;
+}
+
+void EmitterManager::update(const Listener &listener, sf::Time elapsed)
+{
+    m_time += elapsed;
+    ++m_updateCount;
+
+    while(!m_endings.empty() && m_endings.top().time <= m_time)
+    {
+        EmitterId id = m_endings.top().emitter;
+        m_endings.pop();
+        if(findEmitter(id)) release(static_cast<std::uint32_t>(id));
+    }
+
+    // Emitters near the listener are checked below, the others a few per update so that none outlives its sound for long
+    for(std::size_t i = 0; i < SWEEP_COUNT && i < m_emitters.size(); ++i)
+    {
+        m_sweepIndex = (m_sweepIndex + 1) % m_emitters.size();
+        const Emitter &emitter = m_emitters[m_sweepIndex];
+        if(emitter.active && !getSource(emitter)) release(static_cast<std::uint32_t>(m_sweepIndex));
+    }
+
+    Vec3 listenerPosition = listener.getPosition();
+    Vec3 direction = listener.getDirection().normalized();
+    float globalGain = listener.getGlobalVolume() / 100.f;
+
+    m_found.clear();
+    m_grid.query(listenerPosition, m_maxRadius, m_found);
+    m_found.insert(m_found.end(), m_ungridded.begin(), m_ungridded.end());
+
+    m_candidates.clear();
+    for(std::uint32_t index : m_found)
+    {
+        const Emitter &emitter = m_emitters[index];
+        const sf::Sound *found = getSource(emitter);
+        if(!found)
+        {
+            release(index);
+            continue;
+        }
+        const sf::Sound &source = *found;
+
+        // OpenAL's default inverse distance clamped model, which SFML uses
+        Vec3 offset = emitter.position;
+        Vec3 forward = direction;
+        if(source.isRelativeToListener()) forward = Vec3(0.f, 0.f, -1.f);
+        else offset -= listenerPosition;
+        float distance = offset.magnitude();
+        float minDistance = source.getMinDistance();
+        float attenuation = source.getAttenuation() * (std::max(distance, minDistance) - minDistance);
+        float gain = source.getVolume() / 100.f * globalGain * minDistance / (minDistance + attenuation);
+        if(!(gain >= m_threshold) || gain <= 0.f) continue;
+
+        float facing = distance > 0.f ? forward.dot(offset) / distance : 1.f;
+        m_candidates.push_back(Candidate{gain * (0.75f + 0.25f * facing), index});
+    }
+
+    if(m_candidates.size() > m_voices.size())
+    {
+        auto louder = [](const Candidate &a, const Candidate &b){ return a.priority > b.priority; };
+        std::nth_element(m_candidates.begin(), m_candidates.begin() + m_voices.size(), m_candidates.end(), louder);
+        m_candidates.resize(m_voices.size());
+    }
+    for(const Candidate &candidate : m_candidates) m_emitters[candidate.emitter].selected = m_updateCount;
+
+    // Voices are freed before they are given away, so every selected emitter finds one
+    for(Voice &voice : m_voices)
+    {
+        if(voice.used && m_emitters[voice.emitter].selected != m_updateCount) demote(m_emitters[voice.emitter]);
+    }
+    for(const Candidate &candidate : m_candidates)
+    {
+        if(m_emitters[candidate.emitter].voice == NO_VOICE) promote(candidate.emitter);
+    }
+}
+
+EmitterManager::Emitter* EmitterManager::findEmitter(EmitterId id)
+{
+    std::uint32_t index = static_cast<std::uint32_t>(id);
+    if(index >= m_emitters.size()) return nullptr;
+    Emitter &emitter = m_emitters[index];
+    if(!emitter.active || emitter.generation != static_cast<std::uint32_t>(id >> 32)) return nullptr;
+    return &emitter;
+}
+
+const EmitterManager::Emitter* EmitterManager::findPlaying(EmitterId id) const
+{
+    const Emitter *emitter = const_cast<EmitterManager*>(this)->findEmitter(id);
+    return emitter && getSource(*emitter) ? emitter : nullptr;
+}
+
+const sf::Sound* EmitterManager::getSource(const Emitter &emitter) const
+{
+    const sf::Sound *source = m_sounds.get(emitter.source);
+    return source && source->getBuffer() == emitter.buffer ? source : nullptr;
+}
+
+sf::Time EmitterManager::getOffset(const Emitter &emitter) const
+{
+    sf::Time offset = scaleTime(m_time - emitter.start, emitter.pitch);
+    if(emitter.loop) return offset % emitter.duration;
+    return std::min(offset, emitter.duration);
+}
+
+float EmitterManager::getAudibleRadius(const sf::Sound &source) const
+{
+    // Solves the inverse distance clamped model for the distance at which the gain drops to the threshold
+    float gain = source.getVolume() / 100.f;
+    float minDistance = source.getMinDistance();
+    if(gain < m_threshold || minDistance <= 0.f) return 0.f;
+    if(source.getAttenuation() <= 0.f || m_threshold <= 0.f) return std::numeric_limits<float>::infinity();
+    return minDistance + (gain * minDistance / m_threshold - minDistance) / source.getAttenuation();
+}
+
+void EmitterManager::place(std::uint32_t index, const sf::Sound &source)
+{
+    Emitter &emitter = m_emitters[index];
+    float radius = getAudibleRadius(source);
+    emitter.gridded = !source.isRelativeToListener() && std::isfinite(radius);
+    if(emitter.gridded)
+    {
+        m_grid.insert(index, emitter.position);
+        m_maxRadius = std::max(m_maxRadius, radius);
+    }
+    else m_ungridded.push_back(index);
+}
+
+void EmitterManager::promote(std::uint32_t index)
+{
+    auto free = std::find_if(m_voices.begin(), m_voices.end(), [](const Voice &voice){ return !voice.used; });
+    Emitter &emitter = m_emitters[index];
+    const sf::Sound &source = *getSource(emitter);
+    sf::Sound &sound = free->sound;
+    sound.setBuffer(*emitter.buffer);
+    sound.setVolume(source.getVolume());
+    sound.setPitch(emitter.pitch);
+    sound.setMinDistance(source.getMinDistance());
+    sound.setAttenuation(source.getAttenuation());
+    sound.setRelativeToListener(source.isRelativeToListener());
+    sound.setPosition(emitter.position.x, emitter.position.y, emitter.position.z);
+    sound.setLoop(emitter.loop);
+    // A stopped sound restarts from the beginning when played, so the offset is set afterwards
+    sound.play();
+    sound.setPlayingOffset(getOffset(emitter));
+
+    free->emitter = index;
+    free->used = true;
+    emitter.voice = static_cast<std::uint32_t>(free - m_voices.begin());
+    ++m_realCount;
+}
+
+void EmitterManager::demote(Emitter &emitter)
+{
+    Voice &voice = m_voices[emitter.voice];
+    voice.sound.stop();
+    voice.sound.resetBuffer();
+    voice.used = false;
+    emitter.voice = NO_VOICE;
+    --m_realCount;
+}
+
+void EmitterManager::release(std::uint32_t index)
+{
+    Emitter &emitter = m_emitters[index];
+    if(emitter.voice != NO_VOICE) demote(emitter);
+    if(emitter.gridded) m_grid.remove(index);
+    else m_ungridded.erase(std::find(m_ungridded.begin(), m_ungridded.end(), index));
+
+    emitter.active = false;
+    emitter.source = SoundManager::Handle();
+    emitter.buffer = nullptr;
+    if(++emitter.generation == 0) emitter.generation = 1;
+    m_freeEmitters.push_back(index);
+    if(--m_activeCount == 0) m_maxRadius = 0.f;
+}
+
+} // namespace sfex
\ No newline at end of file
@@ -0,0 +1,295 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Yunus Emre Aydın
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <SFEX/Managers/ManifestLoader.hpp>
+#include "../General/FileIo.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace sfex
+{
+
+namespace
+{
+
+std::size_t getFileSize(const std::string &filename)
+{
+    std::error_code error;
+    std::uintmax_t size = std::filesystem::file_size(filename, error);
+    return error ? 0 : static_cast<std::size_t>(size);
+}
+
+} // namespace
+
+ManifestLoader::ManifestLoader(TextureManager &textures, SoundManager &sounds, MusicManager &music):
+    m_textures(textures), m_sounds(sounds), m_music(music), m_queue(std::make_shared<DecodedQueue>())
+{
+}
+
+void ManifestLoader::load(const Multitype &manifest, const std::string &directory)
+{
+    if(manifest.get_datatype() != Multitype::DataType::MAP)
+    {
+        throw std::invalid_argument("A manifest has to be a map, got " + manifest.get_datatype_as_string());
+    }
+
+    // Nothing is queued before the whole manifest has been checked, so a malformed one leaves the loader as it was
+    std::vector<Request> requests;
+    std::vector<Request> musicRequests;
+    for(auto &[section, entries] : manifest.as_map())
+    {
+        AssetType type;
+        if(section == "textures") type = AssetType::Texture;
+        else if(section == "sounds") type = AssetType::Sound;
+        else if(section == "music") type = AssetType::Music;
+        else throw std::invalid_argument("Unknown manifest section \"" + section + "\"");
+
+        if(entries.get_datatype() != Multitype::DataType::MAP)
+        {
+            throw std::invalid_argument("Manifest section \"" + section + "\" has to be a map");
+        }
+
+        for(auto &[key, path] : entries.as_map())
+        {
+            if(path.get_datatype() != Multitype::DataType::STRING)
+            {
+                throw std::invalid_argument("Path of \"" + key + "\" in manifest section \"" + section + "\" has to be a string");
+            }
+
+            std::filesystem::path filename = path.as_string();
+            if(!directory.empty() && filename.is_relative()) filename = std::filesystem::path(directory) / filename;
+
+            Request request{type, key, filename.string(), 0};
+            if(type == AssetType::Music)
+            {
+                musicRequests.push_back(std::move(request));
+            }
+            else
+            {
+                request.size = getFileSize(request.filename);
+                requests.push_back(std::move(request));
+            }
+        }
+    }
+
+    m_pendingCount += requests.size() + musicRequests.size();
+    std::move(musicRequests.begin(), musicRequests.end(), std::back_inserter(m_musicRequests));
+    if(requests.empty()) return;
+
+    // Files of one directory are usually close to each other on the disk, reading them in path order keeps the reads sequential
+    std::sort(requests.begin(), requests.end(), [](const Request &left, const Request &right){
+        return left.filename < right.filename;
+    });
+
+    WorkerPool &pool = getWorkerPool();
+    std::size_t bytes = 0;
+    for(const Request &request : requests) bytes += request.size;
+    m_totalBytes += bytes;
+
+    // Split the sorted files into contiguous runs of roughly equal size, one run per parallel read
+    std::size_t runCount = std::min({m_maxParallelReads, std::max<std::size_t>(pool.getWorkerCount(), 1), requests.size()});
+    std::size_t runBytes = bytes / runCount + 1;
+    auto begin = requests.begin();
+    while(begin != requests.end())
+    {
+        auto end = begin;
+        std::size_t size = 0;
+        while(end != requests.end() && (end == begin || size + end->size <= runBytes)) size += (end++)->size;
+
+        auto run = std::make_shared<std::vector<Request>>(std::make_move_iterator(begin), std::make_move_iterator(end));
+        pool.push([poolPtr = &pool, queue = m_queue, run](){
+            readRun(*poolPtr, queue, run, 0);
+        }, Priority::High);
+        begin = end;
+    }
+}
+
+bool ManifestLoader::loadFromFile(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if(!file) return false;
+
+    std::stringstream ss;
+    ss << file.rdbuf();
+    load(Multitype::parse(ss.str()), std::filesystem::path(filename).parent_path().string());
+    return true;
+}
+
+std::size_t ManifestLoader::update(std::size_t maxAssets)
+{
+    std::size_t count = 0;
+
+    // Opening a music only reads its header, the rest is streamed while it plays
+    for(Request &request : m_musicRequests)
+    {
+        finishAsset(request.key, 0, !m_music.openFromFile(request.key, request.filename));
+        ++count;
+    }
+    m_musicRequests.clear();
+
+    std::vector<Decoded> assets;
+    {
+        std::lock_guard<std::mutex> lock(m_queue->mutex);
+        std::vector<Decoded> &queued = m_queue->assets;
+        std::size_t taken = std::min(maxAssets, queued.size());
+        assets.reserve(taken);
+        std::move(queued.begin(), queued.begin() + taken, std::back_inserter(assets));
+        queued.erase(queued.begin(), queued.begin() + taken);
+    }
+
+    for(Decoded &asset : assets) store(asset);
+    return count + assets.size();
+}
+
+void ManifestLoader::finish()
+{
+    while(!isDone())
+    {
+        if(update(std::numeric_limits<std::size_t>::max()) > 0) continue;
+        if(!m_pool || !m_pool->runPendingTask()) std::this_thread::yield();
+    }
+}
+
+float ManifestLoader::getProgress() const
+{
+    if(m_totalBytes == 0) return isDone() ? 1.f : 0.f;
+    return static_cast<float>(static_cast<double>(m_loadedBytes) / m_totalBytes);
+}
+
+std::size_t ManifestLoader::getLoadedBytes() const
+{
+    return m_loadedBytes;
+}
+
+std::size_t ManifestLoader::getTotalBytes() const
+{
+    return m_totalBytes;
+}
+
+std::size_t ManifestLoader::getPendingCount() const
+{
+    return m_pendingCount;
+}
+
+bool ManifestLoader::isDone() const
+{
+    return m_pendingCount == 0;
+}
+
+const std::vector<std::string>& ManifestLoader::getFailedKeys() const
+{
+    return m_failedKeys;
+}
+
+void ManifestLoader::setMaxParallelReads(std::size_t maxReads)
+{
+    m_maxParallelReads = std::max<std::size_t>(maxReads, 1);
+}
+
+void ManifestLoader::setWorkerPool(WorkerPool &pool)
+{
+    m_pool = &pool;
+    m_ownedPool.reset();
+}
+
+void ManifestLoader::readRun(WorkerPool &pool, const std::shared_ptr<DecodedQueue> &queue, const std::shared_ptr<std::vector<Request>> &run, std::size_t index)
+{
+    Request &request = (*run)[index];
+    Decoded asset{request.type, std::move(request.key), request.size};
+    std::vector<char> data;
+    bool read = impl::readFile(request.filename, data);
+
+    // The next file of the run is read by whichever worker is free while this one decodes, so at most one file per worker waits in memory
+    if(index + 1 < run->size())
+    {
+        pool.push([poolPtr = &pool, queue, run, index](){
+            readRun(*poolPtr, queue, run, index + 1);
+        }, Priority::High);
+    }
+
+    if(read) decode(asset, data);
+    else asset.failed = true;
+
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->assets.push_back(std::move(asset));
+}
+
+void ManifestLoader::decode(Decoded &asset, const std::vector<char> &data)
+{
+    if(asset.type == AssetType::Texture)
+    {
+        asset.failed = !asset.image.loadFromMemory(data.data(), data.size());
+        return;
+    }
+
+    sf::InputSoundFile file;
+    if(!file.openFromMemory(data.data(), data.size()))
+    {
+        asset.failed = true;
+        return;
+    }
+    asset.samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+    asset.channelCount = file.getChannelCount();
+    asset.sampleRate = file.getSampleRate();
+    asset.failed = file.read(asset.samples.data(), asset.samples.size()) != asset.samples.size();
+}
+
+void ManifestLoader::store(Decoded &asset)
+{
+    bool stored = false;
+    if(!asset.failed && asset.type == AssetType::Texture)
+    {
+        stored = m_textures.loadFromImage(asset.key, asset.image);
+    }
+    else if(!asset.failed && asset.type == AssetType::Sound)
+    {
+        stored = m_sounds.loadFromSamples(asset.key, asset.samples.data(), asset.samples.size(), asset.channelCount, asset.sampleRate);
+    }
+    finishAsset(asset.key, asset.size, !stored);
+}
+
+void ManifestLoader::finishAsset(const std::string &key, std::size_t size, bool failed)
+{
+    if(failed) m_failedKeys.push_back(key);
+    m_loadedBytes += size;
+    --m_pendingCount;
+}
+
+WorkerPool& ManifestLoader::getWorkerPool()
+{
+    if(!m_pool)
+    {
+        m_ownedPool = std::make_shared<WorkerPool>();
+        m_pool = m_ownedPool.get();
+    }
+    return *m_pool;
+}
+
+} // namespace sfex
\ No newline at end of file
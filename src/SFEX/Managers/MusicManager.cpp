@@ -23,65 +23,158 @@
 //
 
 #include <SFEX/Managers/MusicManager.hpp>
+#include <algorithm>
 
 namespace sfex
 {
 
 bool MusicManager::openFromFile(const std::string &key, const std::string &filename)
 {
-    sf::Music music;
-    if(!music.openFromFile(filename)) return false;
-
-    (*this)[key].openFromFile(filename);
-    return true;
+    return openMusic(key, [&](sf::Music &music){ return music.openFromFile(filename); });
 }
 
 bool MusicManager::openFromMemory(const std::string &key, const void *data, std::size_t size)
 {
-    sf::Music music;
-    if(!music.openFromMemory(data, size)) return false;
-
-    (*this)[key].openFromMemory(data, size);
-    return true;
+    return openMusic(key, [&](sf::Music &music){ return music.openFromMemory(data, size); });
 }
 
 bool MusicManager::openFromStream(const std::string &key, sf::InputStream &stream)
 {
-    sf::Music music;
-    if(!music.openFromStream(stream)) return false;
+    return openMusic(key, [&](sf::Music &music){ return music.openFromStream(stream); });
+}
+
+bool MusicManager::openFromPack(const std::string &key, const Pack &pack, std::string_view name)
+{
+    auto stream = std::make_unique<PackStream>();
+    if(!pack.openStream(name, *stream)) return false;
+    if(!openMusic(key, [&](sf::Music &music){ return music.openFromStream(*stream); })) return false;
 
-    (*this)[key].openFromStream(stream);
+    m_streams[key] = std::move(stream);
     return true;
 }
 
-void MusicManager::play(const std::string &key)
+void MusicManager::play(std::string_view key)
+{
+    sf::Music *resource = this->get(key);
+    if(!resource) return;
+
+    resource->play();
+    m_current = key;
+}
+
+void MusicManager::queue(std::string_view key)
+{
+    sf::Music *resource = this->get(key);
+    if(!resource) return;
+
+    // Rewinding now leaves nothing but starting the stream for the moment the current music ends
+    if(key != m_current) resource->stop();
+    m_queue.emplace_back(key);
+}
+
+void MusicManager::clearQueue()
+{
+    m_queue.clear();
+}
+
+std::size_t MusicManager::getQueueSize() const
+{
+    return m_queue.size();
+}
+
+const std::string& MusicManager::getCurrent() const
+{
+    return m_current;
+}
+
+void MusicManager::update()
+{
+    if(m_queue.empty()) return;
+
+    const sf::Music *current = m_current.empty() ? nullptr : this->get(m_current);
+    if(current && current->getStatus() != sf::Music::Stopped) return;
+
+    // Keys removed while they were queued are skipped
+    while(!m_queue.empty())
+    {
+        std::string key = std::move(m_queue.front());
+        m_queue.pop_front();
+        sf::Music *next = this->get(key);
+        if(!next) continue;
+
+        next->play();
+        m_current = std::move(key);
+        return;
+    }
+    m_current.clear();
+}
+
+void MusicManager::pause(std::string_view key)
 {
-    if(!this->contains(key)) return;
-    (*this)[key].play();
+    sf::Music *resource = this->get(key);
+    if(resource) resource->pause();
 }
 
-void MusicManager::pause(const std::string &key)
+void MusicManager::stop(std::string_view key)
 {
-    if(!this->contains(key)) return;
-    (*this)[key].pause();
+    sf::Music *resource = this->get(key);
+    if(resource) resource->stop();
 }
 
-void MusicManager::stop(const std::string &key)
+sf::Time MusicManager::getDuration(std::string_view key)
 {
-    if(!this->contains(key)) return;
-    (*this)[key].stop();
+    sf::Music *resource = this->get(key);
+    if(!resource) return sf::Time::Zero;
+    return resource->getDuration();
 }
 
-sf::Time MusicManager::getDuration(const std::string &key)
+sf::Music::Status MusicManager::getStatus(std::string_view key)
 {
-    if(!this->contains(key)) return sf::Time::Zero;
-    return (*this)[key].getDuration();
+    sf::Music *resource = this->get(key);
+    if(!resource) return sf::Music::Status::Stopped;
+    return resource->getStatus();
 }
 
-sf::Music::Status MusicManager::getStatus(const std::string &key)
+void MusicManager::onErase(const std::string &key, sf::Music &music)
 {
-    if(!this->contains(key)) return sf::Music::Status::Stopped;
-    return (*this)[key].getStatus();
+    music.stop();
+    m_streams.erase(key);
+    if(m_current == key) m_current.clear();
+}
+
+void MusicManager::onRename(const std::string &oldKey, const std::string &newKey, sf::Music &music)
+{
+    if(m_current == oldKey) m_current = newKey;
+    std::replace(m_queue.begin(), m_queue.end(), oldKey, newKey);
+
+    auto it = m_streams.find(oldKey);
+    if(it == m_streams.end()) return;
+
+    std::unique_ptr<PackStream> stream = std::move(it->second);
+    m_streams.erase(it);
+    m_streams[newKey] = std::move(stream);
+}
+
+template<typename Open>
+bool MusicManager::openMusic(const std::string &key, Open&& open)
+{
+    auto existing = this->find(key);
+    if(existing == this->end())
+    {
+        auto it = this->try_emplace(key).first;
+        if(open(it->second)) return true;
+
+        this->erase(it);
+        return false;
+    }
+
+    // sf::Music closes its previous source before opening, so the source is tried on a music of its own first.
+    // Reopening the stored music afterwards keeps references, handles and the queue pointing to it.
+    {
+        sf::Music check;
+        if(!open(check)) return false;
+    }
+    return open(existing->second);
 }
 
 } // namespace sfex
@@ -27,12 +27,13 @@
 namespace sfex
 {
 
-void SceneManager::setActiveScene(const std::string &key)
+void SceneManager::setActiveScene(std::string_view key)
 {
-    if(!this->contains(key)) return;
+    std::shared_ptr<Scene> *scene = this->get(key);
+    if(!scene) return;
     if(this->m_activeKey.has_value()) this->at(m_activeKey.value())->destroy();
-    m_activeKey = key;
-    this->at(key)->start();
+    m_activeKey = std::string(key);
+    (*scene)->start();
 }
 
 std::optional<std::shared_ptr<Scene>> SceneManager::getActiveScene()
@@ -23,74 +23,707 @@
 //
 
 #include <SFEX/Managers/SoundManager.hpp>
+#include <SFEX/General/Hash.hpp>
+#include <SFEX/General/MixerStream.hpp>
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Audio/Listener.hpp>
+#include "../General/FileIo.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 
 namespace sfex
 {
 
+SoundManager::SoundManager(const SoundManager &other):
+    ManagerBase<sf::Sound>(other), m_buffers(other.m_buffers), m_contentOfKey(other.m_contentOfKey),
+    m_queuePendingPlays(other.m_queuePendingPlays), m_preloadSets(other.m_preloadSets),
+    m_voiceCount(other.m_voiceCount), m_polyphony(other.m_polyphony), m_defaultPolyphony(other.m_defaultPolyphony), m_ownedPool(other.m_ownedPool), m_pool(other.m_pool)
+{
+    // The copied sounds still play the buffers of other
+    for(auto &[key, content] : m_contentOfKey) (*this)[key].setBuffer(m_buffers[content].buffer);
+}
+
+SoundManager::~SoundManager()
+{
+    // The mixers read the buffers from their own threads
+    m_mixedVoices.stopAll();
+}
+
+SoundManager& SoundManager::operator=(const SoundManager &other)
+{
+    if(this == &other) return *this;
+
+    // The voices refer to the sounds and buffers that are replaced
+    m_voices.clear();
+    m_mixedVoices.stopAll();
+    ManagerBase<sf::Sound>::operator=(other);
+    m_buffers = other.m_buffers;
+    m_contentOfKey = other.m_contentOfKey;
+    for(auto &[key, content] : m_contentOfKey) (*this)[key].setBuffer(m_buffers[content].buffer);
+    m_uploadQueue.reset();
+    m_pendingLoads.clear();
+    m_queuePendingPlays = other.m_queuePendingPlays;
+    m_preloadSets = other.m_preloadSets;
+    m_voiceCount = other.m_voiceCount;
+    m_polyphony = other.m_polyphony;
+    m_defaultPolyphony = other.m_defaultPolyphony;
+
+    m_watcher.reset();
+    m_reloadSources.clear();
+    m_reloadQueue.reset();
+    m_ownedPool = other.m_ownedPool;
+    m_pool = other.m_pool;
+    return *this;
+}
+
 bool SoundManager::loadFromFile(const std::string &key, const std::string &filename)
 {
-    m_buffers[key] = sf::SoundBuffer();
-    if(!m_buffers[key].loadFromFile(filename)) return false;
+    std::vector<char> data;
+    if(!impl::readFile(filename, data) || !loadFromMemory(key, data.data(), data.size())) return false;
 
-    (*this)[key] = sf::Sound(m_buffers[key]);
+    watchFile(key, filename);
     return true;
 }
 
 bool SoundManager::loadFromMemory(const std::string &key, const void *data, std::size_t size)
 {
-    m_buffers[key] = sf::SoundBuffer();
-    if(!m_buffers[key].loadFromMemory(data, size)) return false;
-
-    (*this)[key] = sf::Sound(m_buffers[key]);
-    return true;
+    return loadBuffer(key, xxHash64(data, size), [&](sf::SoundBuffer &buffer){
+        return buffer.loadFromMemory(data, size);
+    });
 }
 
 bool SoundManager::loadFromStream(const std::string &key, sf::InputStream &stream)
 {
-    m_buffers[key] = sf::SoundBuffer();
-    if(!m_buffers[key].loadFromStream(stream)) return false;
+    std::vector<char> data;
+    if(!impl::readStream(stream, data)) return false;
 
-    (*this)[key] = sf::Sound(m_buffers[key]);
-    return true;
+    return loadFromMemory(key, data.data(), data.size());
+}
+
+bool SoundManager::loadFromPack(const std::string &key, const Pack &pack, std::string_view name)
+{
+    PackStream stream;
+    if(!pack.openStream(name, stream)) return false;
+
+    return loadFromMemory(key, stream.getData(), static_cast<std::size_t>(stream.getSize()));
 }
 
 bool SoundManager::loadFromSamples(const std::string &key, const sf::Int16 *sample, sf::Uint64 sampleCount, unsigned int channelCount, unsigned int sampleRate)
 {
-    m_buffers[key] = sf::SoundBuffer();
-    if(!m_buffers[key].loadFromSamples(sample, sampleCount, channelCount, sampleRate)) return false;
+    const unsigned int format[2] = {channelCount, sampleRate};
+    std::uint64_t content = xxHash64(format, sizeof(format), xxHash64(sample, static_cast<std::size_t>(sampleCount) * sizeof(sf::Int16)));
+    return loadBuffer(key, content, [&](sf::SoundBuffer &buffer){
+        return buffer.loadFromSamples(sample, sampleCount, channelCount, sampleRate);
+    });
+}
 
-    (*this)[key] = sf::Sound(m_buffers[key]);
-    return true;
+AsyncLoad SoundManager::loadAsync(const std::string &key, const std::string &filename)
+{
+    if(!m_uploadQueue) m_uploadQueue = std::make_shared<DecodedQueue>();
+
+    // A play queued for an earlier load of key is kept
+    AsyncLoad load(LoadStatus::Decoding);
+    PendingLoad &pending = m_pendingLoads[key];
+    pending.filename = filename;
+    pending.load = load;
+    decodeAsync(m_uploadQueue, key, filename, load, Priority::Normal);
+    return load;
+}
+
+std::size_t SoundManager::processUploads(std::size_t maxUploads)
+{
+    // Loads that failed on a worker never reach the queue, their queued plays are dropped with them
+    for(auto it = m_pendingLoads.begin(); it != m_pendingLoads.end();)
+    {
+        if(it->second.load.getStatus() == LoadStatus::Failed) it = m_pendingLoads.erase(it);
+        else ++it;
+    }
+    if(!m_uploadQueue || maxUploads == 0) return 0;
+
+    std::vector<Decoded> sounds;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadQueue->mutex);
+        std::vector<Decoded> &queued = m_uploadQueue->sounds;
+        std::size_t count = std::min(maxUploads, queued.size());
+        sounds.reserve(count);
+        std::move(queued.begin(), queued.begin() + count, std::back_inserter(sounds));
+        queued.erase(queued.begin(), queued.begin() + count);
+    }
+
+    for(Decoded &decoded : sounds)
+    {
+        // A newer load of the key supersedes this one
+        auto pending = m_pendingLoads.find(decoded.key);
+        if(pending == m_pendingLoads.end() || pending->second.load != decoded.load)
+        {
+            decoded.load.setStatus(LoadStatus::Failed);
+            continue;
+        }
+        PendingLoad request = std::move(pending->second);
+        m_pendingLoads.erase(pending);
+
+        bool loaded = loadBuffer(decoded.key, decoded.content, [&](sf::SoundBuffer &buffer){
+            return buffer.loadFromSamples(decoded.samples.data(), decoded.samples.size(), decoded.channelCount, decoded.sampleRate);
+        });
+        if(loaded)
+        {
+            watchFile(decoded.key, request.filename);
+            if(request.playQueued) play(decoded.key);
+        }
+        decoded.load.setStatus(loaded ? LoadStatus::Loaded : LoadStatus::Failed);
+    }
+    return sounds.size();
+}
+
+std::size_t SoundManager::getPendingUploadCount() const
+{
+    if(!m_uploadQueue) return 0;
+
+    std::lock_guard<std::mutex> lock(m_uploadQueue->mutex);
+    return m_uploadQueue->sounds.size();
+}
+
+bool SoundManager::isLoading(std::string_view key) const
+{
+    auto it = m_pendingLoads.find(lookupKey(key));
+    return it != m_pendingLoads.end() && it->second.load.getStatus() != LoadStatus::Failed;
+}
+
+void SoundManager::setQueuePendingPlays(bool queue)
+{
+    m_queuePendingPlays = queue;
+}
+
+void SoundManager::addToPreloadSet(const std::string &scene, const std::string &key, const std::string &filename)
+{
+    m_preloadSets[scene].emplace_back(key, filename);
+}
+
+std::size_t SoundManager::preload(const std::string &scene)
+{
+    auto set = m_preloadSets.find(scene);
+    if(set == m_preloadSets.end()) return 0;
+
+    std::size_t started = 0;
+    for(const auto &[key, filename] : set->second)
+    {
+        if(this->get(key) || isLoading(key)) continue;
+        loadAsync(key, filename);
+        ++started;
+    }
+    return started;
+}
+
+bool SoundManager::isPreloading(const std::string &scene) const
+{
+    auto set = m_preloadSets.find(scene);
+    if(set == m_preloadSets.end()) return false;
+
+    return std::any_of(set->second.begin(), set->second.end(), [this](const auto &sound){ return isLoading(sound.first); });
+}
+
+void SoundManager::unloadPreloadSet(const std::string &scene, const std::string &nextScene)
+{
+    auto set = m_preloadSets.find(scene);
+    if(set == m_preloadSets.end()) return;
+
+    auto next = m_preloadSets.find(nextScene);
+    for(const auto &[key, filename] : set->second)
+    {
+        if(next != m_preloadSets.end() && std::any_of(next->second.begin(), next->second.end(), [&key](const auto &sound){ return sound.first == key; })) continue;
+        m_pendingLoads.erase(key);
+        this->remove(key);
+    }
+}
+
+void SoundManager::play(std::string_view key)
+{
+    sf::Sound *resource = this->get(key);
+    if(!resource)
+    {
+        auto pending = m_pendingLoads.find(lookupKey(key));
+        if(pending != m_pendingLoads.end() && m_queuePendingPlays) pending->second.playQueued = true;
+        return;
+    }
+    if(!resource->getBuffer()) return;
+    if(m_voiceCount == 0)
+    {
+        resource->play();
+        return;
+    }
+
+    bool resumed = false;
+    for(Voice &voice : m_voices)
+    {
+        if(voice.source != resource || voice.sound.getStatus() != sf::Sound::Paused) continue;
+        voice.sound.play();
+        resumed = true;
+    }
+    if(resumed) return;
+
+    if(m_voices.empty()) m_voices.resize(m_voiceCount);
+    Voice &voice = findVoice(resource, getPolyphony(key));
+    voice.sound.stop();
+    voice.sound.setBuffer(*resource->getBuffer());
+    voice.sound.setVolume(resource->getVolume());
+    voice.sound.setPitch(resource->getPitch());
+    voice.sound.setPosition(resource->getPosition());
+    voice.sound.setRelativeToListener(resource->isRelativeToListener());
+    voice.sound.setMinDistance(resource->getMinDistance());
+    voice.sound.setAttenuation(resource->getAttenuation());
+    voice.sound.setLoop(resource->getLoop());
+    voice.source = resource;
+    voice.order = ++m_playCount;
+    voice.sound.play();
 }
 
-void SoundManager::play(const std::string &key)
+Mixer::VoiceId SoundManager::mix(Mixer &mixer, std::string_view key, Mixer::Bus bus)
 {
-    if(!this->contains(key)) return;
-    (*this)[key].play();
+    const sf::Sound *resource = this->get(key);
+    if(!resource || !resource->getBuffer()) return 0;
+
+    Mixer::VoiceSettings settings;
+    settings.gain = resource->getVolume() / 100.f;
+    settings.pitch = resource->getPitch();
+    settings.loop = resource->getLoop();
+    settings.bus = bus;
+    Mixer::VoiceId id = mixer.play(MixerStream::getSource(*resource->getBuffer()), settings);
+    if(id == 0) return 0;
+
+    // Forgetting ended voices whenever the vector would grow keeps it proportional to the voices that play
+    std::vector<MixedVoice> &voices = m_mixedVoices.voices;
+    if(voices.size() == voices.capacity())
+    {
+        voices.erase(std::remove_if(voices.begin(), voices.end(), [](const MixedVoice &voice){ return !voice.mixer->isPlaying(voice.id); }), voices.end());
+    }
+    voices.push_back(MixedVoice{&mixer, id, resource->getBuffer()});
+    return id;
 }
 
-void SoundManager::pause(const std::string &key)
+void SoundManager::pause(std::string_view key)
 {
-    if(!this->contains(key)) return;
-    (*this)[key].pause();
+    auto pending = m_pendingLoads.find(lookupKey(key));
+    if(pending != m_pendingLoads.end()) pending->second.playQueued = false;
+
+    sf::Sound *resource = this->get(key);
+    if(!resource) return;
+
+    resource->pause();
+    for(Voice &voice : m_voices)
+    {
+        if(voice.source == resource && voice.sound.getStatus() == sf::Sound::Playing) voice.sound.pause();
+    }
 }
 
-void SoundManager::stop(const std::string &key)
+void SoundManager::stop(std::string_view key)
 {
-    if(!this->contains(key)) return;
-    (*this)[key].stop();
+    auto pending = m_pendingLoads.find(lookupKey(key));
+    if(pending != m_pendingLoads.end()) pending->second.playQueued = false;
+
+    sf::Sound *resource = this->get(key);
+    if(!resource) return;
+
+    resource->stop();
+    for(Voice &voice : m_voices)
+    {
+        if(voice.source == resource) voice.sound.stop();
+    }
 }
 
-sf::Time SoundManager::getDuration(const std::string &key)
+void SoundManager::setVoiceCount(std::size_t count)
 {
-    if(!this->contains(key)) return sf::Time::Zero;
-    return (*this)[key].getBuffer()->getDuration();
+    m_voices.clear();
+    m_voiceCount = count;
+}
+
+std::size_t SoundManager::getVoiceCount() const
+{
+    return m_voiceCount;
+}
+
+std::size_t SoundManager::getActiveVoiceCount() const
+{
+    return static_cast<std::size_t>(std::count_if(m_voices.begin(), m_voices.end(), [](const Voice &voice){
+        return voice.sound.getStatus() != sf::Sound::Stopped;
+    }));
+}
+
+void SoundManager::setPolyphony(const std::string &key, std::size_t limit)
+{
+    m_polyphony[key] = limit;
+}
+
+std::size_t SoundManager::getPolyphony(std::string_view key) const
+{
+    auto it = m_polyphony.find(lookupKey(key));
+    return it == m_polyphony.end() ? m_defaultPolyphony : it->second;
+}
+
+void SoundManager::setDefaultPolyphony(std::size_t limit)
+{
+    m_defaultPolyphony = limit;
+}
+
+sf::Time SoundManager::getDuration(std::string_view key)
+{
+    sf::Sound *resource = this->get(key);
+    if(!resource) return sf::Time::Zero;
+    return resource->getBuffer()->getDuration();
+}
+
+sf::Sound::Status SoundManager::getStatus(std::string_view key)
+{
+    sf::Sound *resource = this->get(key);
+    if(!resource) return sf::Sound::Status::Stopped;
+
+    // Playing on any voice counts as playing, paused ones only count if none plays
+    sf::Sound::Status status = resource->getStatus();
+    for(const Voice &voice : m_voices)
+    {
+        if(status == sf::Sound::Playing) break;
+        if(voice.source == resource && voice.sound.getStatus() != sf::Sound::Stopped) status = voice.sound.getStatus();
+    }
+    return status;
 }
 
-sf::Sound::Status SoundManager::getStatus(const std::string &key)
+void SoundManager::setHotReload(bool enable)
 {
-    if(!this->contains(key)) return sf::Sound::Status::Stopped;
-    return (*this)[key].getStatus();
+    if(!enable)
+    {
+        // Decodes that are still running finish into the dropped queue
+        m_watcher.reset();
+        m_reloadSources.clear();
+        m_reloadQueue.reset();
+        return;
+    }
+    if(!m_watcher) m_watcher = std::make_unique<FileWatcher>();
+}
+
+bool SoundManager::isHotReloading() const
+{
+    return m_watcher != nullptr;
+}
+
+std::size_t SoundManager::processReloads(std::size_t maxUploads)
+{
+    if(!m_watcher) return 0;
+    if(!m_reloadQueue) m_reloadQueue = std::make_shared<DecodedQueue>();
+
+    for(const std::string &path : m_watcher->pollChanges())
+    {
+        for(auto &[key, source] : m_reloadSources)
+        {
+            if(source.watchPath != path) continue;
+
+            // A new load supersedes one that is still decoding an older version of the file
+            source.load = AsyncLoad(LoadStatus::Decoding);
+            decodeAsync(m_reloadQueue, key, source.filename, source.load, Priority::Normal);
+        }
+    }
+
+    std::vector<Decoded> sounds;
+    {
+        std::lock_guard<std::mutex> lock(m_reloadQueue->mutex);
+        std::vector<Decoded> &queued = m_reloadQueue->sounds;
+        std::size_t count = std::min(maxUploads, queued.size());
+        sounds.reserve(count);
+        std::move(queued.begin(), queued.begin() + count, std::back_inserter(sounds));
+        queued.erase(queued.begin(), queued.begin() + count);
+    }
+
+    std::size_t reloaded = 0;
+    for(Decoded &decoded : sounds)
+    {
+        // The key can have been removed or loaded from another source while its file was decoded
+        auto source = m_reloadSources.find(decoded.key);
+        auto content = m_contentOfKey.find(decoded.key);
+        if(source == m_reloadSources.end() || source->second.load != decoded.load || content == m_contentOfKey.end())
+        {
+            decoded.load.setStatus(LoadStatus::Failed);
+            continue;
+        }
+
+        // Keys loaded while hot reloading own their buffer, and sf::SoundBuffer reattaches the sounds that play it when its samples change
+        auto buffer = m_buffers.find(content->second);
+        m_mixedVoices.stop(buffer->second.buffer);
+        if(!buffer->second.buffer.loadFromSamples(decoded.samples.data(), decoded.samples.size(), decoded.channelCount, decoded.sampleRate))
+        {
+            decoded.load.setStatus(LoadStatus::Failed);
+            continue;
+        }
+
+        // Rekeying the node keeps the buffer at its address
+        std::uint64_t newContent = xxHash64(decoded.key.data(), decoded.key.size(), decoded.content);
+        if(newContent != content->second && m_buffers.find(newContent) == m_buffers.end())
+        {
+            auto node = m_buffers.extract(buffer);
+            node.key() = newContent;
+            m_buffers.insert(std::move(node));
+            content->second = newContent;
+        }
+        setResourceSize(decoded.key, decoded.samples.size() * sizeof(sf::Int16));
+        decoded.load.setStatus(LoadStatus::Loaded);
+        ++reloaded;
+    }
+    return reloaded;
+}
+
+void SoundManager::setWorkerPool(WorkerPool &pool)
+{
+    m_pool = &pool;
+    m_ownedPool.reset();
+}
+
+std::size_t SoundManager::getDeduplicatedMemory() const
+{
+    std::size_t bytes = 0;
+    for(auto &pair : m_buffers)
+    {
+        const SharedBuffer &shared = pair.second;
+        bytes += (shared.users - 1) * static_cast<std::size_t>(shared.buffer.getSampleCount()) * sizeof(sf::Int16);
+    }
+    return bytes;
+}
+
+void SoundManager::onErase(const std::string &key, sf::Sound &sound)
+{
+    releaseVoices(&sound);
+    sound.resetBuffer();
+    unwatchFile(key);
+
+    auto it = m_contentOfKey.find(key);
+    if(it == m_contentOfKey.end()) return;
+
+    std::uint64_t content = it->second;
+    m_contentOfKey.erase(it);
+    releaseBuffer(key, content);
+}
+
+void SoundManager::onRename(const std::string &oldKey, const std::string &newKey, sf::Sound &sound)
+{
+    auto source = m_reloadSources.find(oldKey);
+    if(source != m_reloadSources.end())
+    {
+        m_reloadSources[newKey] = std::move(source->second);
+        m_reloadSources.erase(source);
+    }
+
+    auto it = m_contentOfKey.find(oldKey);
+    if(it == m_contentOfKey.end()) return;
+
+    std::uint64_t content = it->second;
+    m_contentOfKey.erase(it);
+    m_contentOfKey[newKey] = content;
+
+    // The size has moved with the sound
+    SharedBuffer &shared = m_buffers[content];
+    if(shared.owner == oldKey) shared.owner = newKey;
+}
+
+SoundManager::Voice& SoundManager::findVoice(const sf::Sound *source, std::size_t polyphony)
+{
+    Voice *free = nullptr;
+    Voice *quietest = nullptr;
+    Voice *oldestOfSource = nullptr;
+    float quietestGain = 0.f;
+    std::size_t sourceVoices = 0;
+    for(Voice &voice : m_voices)
+    {
+        if(voice.sound.getStatus() == sf::Sound::Stopped)
+        {
+            if(!free) free = &voice;
+            continue;
+        }
+
+        if(voice.source == source)
+        {
+            ++sourceVoices;
+            if(!oldestOfSource || voice.order < oldestOfSource->order) oldestOfSource = &voice;
+        }
+
+        float gain = getAudibleGain(voice.sound);
+        if(!quietest || gain < quietestGain || (gain == quietestGain && voice.order < quietest->order))
+        {
+            quietest = &voice;
+            quietestGain = gain;
+        }
+    }
+
+    if(polyphony > 0 && sourceVoices >= polyphony) return *oldestOfSource;
+    return free ? *free : *quietest;
+}
+
+SoundManager::MixedVoices::MixedVoices(MixedVoices &&other) noexcept:
+    voices(std::move(other.voices))
+{
+    other.voices.clear();
+}
+
+SoundManager::MixedVoices& SoundManager::MixedVoices::operator=(MixedVoices &&other) noexcept
+{
+    if(this == &other) return *this;
+
+    stopAll();
+    voices = std::move(other.voices);
+    other.voices.clear();
+    return *this;
+}
+
+void SoundManager::MixedVoices::stop(const sf::SoundBuffer &buffer)
+{
+    voices.erase(std::remove_if(voices.begin(), voices.end(), [&buffer](const MixedVoice &voice){
+        if(voice.buffer != &buffer) return false;
+        voice.mixer->stop(voice.id);
+        return true;
+    }), voices.end());
+}
+
+void SoundManager::MixedVoices::stopAll()
+{
+    for(const MixedVoice &voice : voices) voice.mixer->stop(voice.id);
+    voices.clear();
+}
+
+void SoundManager::releaseVoices(const sf::Sound *source)
+{
+    for(Voice &voice : m_voices)
+    {
+        if(voice.source != source) continue;
+        voice.sound.stop();
+        voice.sound.resetBuffer();
+        voice.source = nullptr;
+    }
+}
+
+float SoundManager::getAudibleGain(const sf::Sound &sound)
+{
+    // OpenAL's default inverse distance clamped model, which SFML uses
+    sf::Vector3f offset = sound.getPosition();
+    if(!sound.isRelativeToListener()) offset -= sf::Listener::getPosition();
+
+    float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+    float minDistance = sound.getMinDistance();
+    if(minDistance <= 0.f) return 0.f;
+    float attenuation = sound.getAttenuation() * (std::max(distance, minDistance) - minDistance);
+    return sound.getVolume() / 100.f * minDistance / (minDistance + attenuation);
+}
+
+WorkerPool& SoundManager::getWorkerPool()
+{
+    if(!m_pool)
+    {
+        m_ownedPool = std::make_shared<WorkerPool>();
+        m_pool = m_ownedPool.get();
+    }
+    return *m_pool;
+}
+
+void SoundManager::decodeAsync(const std::shared_ptr<DecodedQueue> &queue, const std::string &key, const std::string &filename, AsyncLoad load, Priority priority)
+{
+    getWorkerPool().push([queue, load, key, filename]() mutable {
+        std::vector<char> data;
+        sf::InputSoundFile file;
+        if(!impl::readFile(filename, data) || !file.openFromMemory(data.data(), data.size()))
+        {
+            load.setStatus(LoadStatus::Failed);
+            return;
+        }
+
+        Decoded decoded{std::move(key), xxHash64(data.data(), data.size()), {}, file.getChannelCount(), file.getSampleRate(), load};
+        decoded.samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+        if(file.read(decoded.samples.data(), decoded.samples.size()) != decoded.samples.size())
+        {
+            load.setStatus(LoadStatus::Failed);
+            return;
+        }
+
+        load.setStatus(LoadStatus::Uploading);
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->sounds.push_back(std::move(decoded));
+    }, priority);
+}
+
+void SoundManager::watchFile(const std::string &key, const std::string &filename)
+{
+    if(!m_watcher) return;
+
+    unwatchFile(key);
+    if(m_watcher->watch(filename)) m_reloadSources[key] = ReloadSource{filename, FileWatcher::getWatchPath(filename), AsyncLoad()};
+}
+
+void SoundManager::unwatchFile(const std::string &key)
+{
+    auto source = m_reloadSources.find(key);
+    if(source == m_reloadSources.end()) return;
+
+    m_watcher->unwatch(source->second.filename);
+    m_reloadSources.erase(source);
+}
+
+template<typename Load>
+bool SoundManager::loadBuffer(const std::string &key, std::uint64_t content, Load&& load)
+{
+    // Salting the content with the key keeps keys loaded while hot reloading from sharing a buffer
+    if(m_watcher) content = xxHash64(key.data(), key.size(), content);
+
+    auto [it, inserted] = m_buffers.try_emplace(content);
+    if(inserted && !load(it->second.buffer))
+    {
+        m_buffers.erase(it);
+        return false;
+    }
+    SharedBuffer &shared = it->second;
+    ++shared.users;
+    if(inserted) shared.owner = key;
+
+    // The previous sound of key lets go of its buffer when it is replaced, only then can that buffer be released
+    auto previous = m_contentOfKey.find(key);
+    bool hadBuffer = previous != m_contentOfKey.end();
+    std::uint64_t previousContent = hadBuffer ? previous->second : 0;
+
+    sf::Sound &sound = (*this)[key];
+    releaseVoices(&sound);
+    sound = sf::Sound(shared.buffer);
+    m_contentOfKey[key] = content;
+    unwatchFile(key);
+    m_pendingLoads.erase(key);
+
+    // Reloading the same content keeps the size
+    if(hadBuffer && previousContent == content)
+    {
+        --shared.users;
+        return true;
+    }
+    if(hadBuffer) releaseBuffer(key, previousContent);
+
+    // A shared buffer only counts towards the budget of one of the sounds that play it
+    setResourceSize(key, shared.owner == key ? static_cast<std::size_t>(shared.buffer.getSampleCount()) * sizeof(sf::Int16) : 0);
+    return true;
+}
+
+void SoundManager::releaseBuffer(const std::string &key, std::uint64_t content)
+{
+    auto it = m_buffers.find(content);
+    if(it == m_buffers.end()) return;
+
+    SharedBuffer &shared = it->second;
+    if(--shared.users == 0)
+    {
+        m_mixedVoices.stop(shared.buffer);
+        m_buffers.erase(it);
+        return;
+    }
+    if(shared.owner != key) return;
+
+    // The buffer stays in memory for its other sounds, so one of them takes over its size
+    for(auto &[other, otherContent] : m_contentOfKey)
+    {
+        if(otherContent != content || other == key) continue;
+        moveResourceSize(key, other);
+        shared.owner = other;
+        return;
+    }
 }
 
 } // namespace sfex
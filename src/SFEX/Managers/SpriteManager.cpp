@@ -38,4 +38,14 @@ void SpriteManager::setTexture(const std::string &key, const sf::Texture& textur
     else (*this)[key] = sf::Sprite(texture);
 }
 
+void SpriteManager::setTexture(const std::string &key, const sf::Texture &texture, const sf::IntRect &rect)
+{
+    if(this->contains(key))
+    {
+        (*this)[key].setTexture(texture);
+        (*this)[key].setTextureRect(rect);
+    }
+    else (*this)[key] = sf::Sprite(texture, rect);
+}
+
 } // namespace sfex
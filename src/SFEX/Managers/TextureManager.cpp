@@ -23,53 +23,752 @@
 //
 
 #include <SFEX/Managers/TextureManager.hpp>
+#include <SFEX/General/Hash.hpp>
+#include "../General/FileIo.hpp"
+#include <algorithm>
+#include <iterator>
 
 namespace sfex
 {
 
+namespace
+{
+
+// Key under which a file loaded at the given area and resolution level shares its texture. Every way of loading a file computes it from the hash of the file bytes.
+std::uint64_t getFileContent(std::uint64_t contentHash, const sf::IntRect &area, unsigned int level)
+{
+    std::uint64_t content = xxHash64(&area, sizeof(area), contentHash);
+    return level > 0 ? xxHash64(&level, sizeof(level), content) : content;
+}
+
+} // namespace
+
+TextureManager::TextureManager():
+    m_uploadQueue(std::make_shared<UploadQueue>()), m_streamQueue(std::make_shared<UploadQueue>()), m_reloadQueue(std::make_shared<UploadQueue>())
+{
+}
+
+TextureManager::TextureManager(const TextureManager &other):
+    ManagerBase<sf::Texture>(other), m_keyOfContent(other.m_keyOfContent), m_contentOfKey(other.m_contentOfKey),
+    m_uploadQueue(std::make_shared<UploadQueue>()), m_streamQueue(std::make_shared<UploadQueue>()),
+    m_maxStreamLoads(other.m_maxStreamLoads), m_maxStreamUploadBytes(other.m_maxStreamUploadBytes), m_placeholder(other.m_placeholder),
+    m_mipmapping(other.m_mipmapping), m_resolutionLevel(other.m_resolutionLevel), m_deduplication(other.m_deduplication), m_cache(other.m_cache),
+    m_reloadQueue(std::make_shared<UploadQueue>()), m_ownedPool(other.m_ownedPool), m_pool(other.m_pool)
+{
+}
+
+TextureManager& TextureManager::operator=(const TextureManager &other)
+{
+    if(this == &other) return *this;
+
+    ManagerBase<sf::Texture>::operator=(other);
+    m_keyOfContent = other.m_keyOfContent;
+    m_contentOfKey = other.m_contentOfKey;
+    m_uploadQueue = std::make_shared<UploadQueue>();
+    m_streamRequests.clear();
+    m_streamOrder.clear();
+    m_streamQueue = std::make_shared<UploadQueue>();
+    m_streamUploads.clear();
+    m_streamLoads.clear();
+    m_maxStreamLoads = other.m_maxStreamLoads;
+    m_maxStreamUploadBytes = other.m_maxStreamUploadBytes;
+    m_placeholder = other.m_placeholder;
+    m_mipmapping = other.m_mipmapping;
+    m_resolutionLevel = other.m_resolutionLevel;
+    m_deduplication = other.m_deduplication;
+    m_cache = other.m_cache;
+    m_watcher.reset();
+    m_reloadSources.clear();
+    m_reloadQueue = std::make_shared<UploadQueue>();
+    m_ownedPool = other.m_ownedPool;
+    m_pool = other.m_pool;
+    return *this;
+}
+
 bool TextureManager::create(const std::string &key, unsigned int width, unsigned int height)
 {
     sf::Texture fooTexture;
     if(!fooTexture.create(width, height)) return false;
-    
-    (*this)[key] = std::move(fooTexture);
+
+    store(key, fooTexture, nullptr);
     return true;
 }
 
 bool TextureManager::loadFromFile(const std::string &key, const std::string &filename, const sf::IntRect &area)
 {
-    sf::Texture fooTexture;
-    if(!fooTexture.loadFromFile(filename, area)) return false;
+    bool loaded;
+    if(m_cache.isEnabled())
+    {
+        ImageCache::Entry entry;
+        sf::Image image;
+        std::uint64_t contentHash;
+        if(m_cache.find(filename, entry)) loaded = loadDecoded(key, entry.getContentHash(), entry.getSize(), entry.getPixels(), area);
+        else loaded = decodeFile(m_cache, filename, image, contentHash) && loadDecoded(key, contentHash, image.getSize(), image.getPixelsPtr(), area);
+    }
+    else
+    {
+        std::vector<char> data;
+        loaded = impl::readFile(filename, data) && loadFromMemory(key, data.data(), data.size(), area);
+    }
 
-    (*this)[key] = std::move(fooTexture);
-    return true;
+    if(loaded) watchFile(key, filename, area);
+    return loaded;
 }
 
 bool TextureManager::loadFromMemory(const std::string &key, const void *data, std::size_t size, const sf::IntRect &area)
 {
+    std::uint64_t content = getFileContent(xxHash64(data, size), area, m_resolutionLevel);
+    if(shareContent(key, content)) return true;
+
+    if(m_resolutionLevel > 0)
+    {
+        sf::Image image;
+        return image.loadFromMemory(data, size) && loadReduced(key, image, area, &content);
+    }
+
     sf::Texture fooTexture;
-    if(!fooTexture.loadFromMemory(data, size)) return false;
+    if(!fooTexture.loadFromMemory(data, size, area)) return false;
 
-    (*this)[key] = std::move(fooTexture);
+    store(key, fooTexture, &content);
     return true;
 }
 
 bool TextureManager::loadFromStream(const std::string &key, sf::InputStream &stream, const sf::IntRect &area)
 {
+    std::vector<char> data;
+    if(!impl::readStream(stream, data)) return false;
+
+    return loadFromMemory(key, data.data(), data.size(), area);
+}
+
+bool TextureManager::loadFromImage(const std::string &key, const sf::Image &image, const sf::IntRect &area)
+{
+    return loadReduced(key, image, area, nullptr);
+}
+
+bool TextureManager::loadForSize(const std::string &key, const sf::Image &image, const sf::Vector2u &size)
+{
+    ImagePyramid pyramid;
+    if(!buildPyramid(image, sf::IntRect(), 0, m_pool, pyramid)) return false;
+
+    std::size_t level = std::min(std::max<std::size_t>(pyramid.findLevel(size), m_resolutionLevel), pyramid.getLevelCount() - 1);
+    const Vec2u &levelSize = pyramid.getLevelSize(level);
+    sf::Image levelImage;
+    levelImage.create(levelSize.x, levelSize.y, pyramid.getLevelPixels(level));
+    return storeImage(key, levelImage, sf::IntRect(), nullptr);
+}
+
+bool TextureManager::loadForSize(const std::string &key, const std::string &filename, const sf::Vector2u &size)
+{
+    sf::Image image;
+    return image.loadFromFile(filename) && loadForSize(key, image, size);
+}
+
+bool TextureManager::decodeFile(const ImageCache &cache, const std::string &filename, sf::Image &image, std::uint64_t &contentHash)
+{
+    std::vector<char> data;
+    if(!impl::readFile(filename, data) || !image.loadFromMemory(data.data(), data.size())) return false;
+
+    // Failing to write the cache only costs decoding the file again next time
+    contentHash = xxHash64(data.data(), data.size());
+    cache.store(filename, contentHash, image.getSize(), image.getPixelsPtr());
+    return true;
+}
+
+bool TextureManager::loadDecoded(const std::string &key, std::uint64_t contentHash, const Vec2u &size, const std::uint8_t *pixels, const sf::IntRect &area)
+{
+    // Same content key as loadFromMemory, so cached and uncached loads of a file share one texture
+    std::uint64_t content = getFileContent(contentHash, area, m_resolutionLevel);
+    if(shareContent(key, content)) return true;
+
+    sf::Image image;
+    if(m_resolutionLevel > 0)
+    {
+        image.create(size.x, size.y, pixels);
+        return loadReduced(key, image, area, &content);
+    }
+
     sf::Texture fooTexture;
-    if(!fooTexture.loadFromStream(stream, area)) return false;
+    if(area == sf::IntRect())
+    {
+        if(!fooTexture.create(size.x, size.y)) return false;
+        fooTexture.update(pixels);
+    }
+    else
+    {
+        image.create(size.x, size.y, pixels);
+        if(!fooTexture.loadFromImage(image, area)) return false;
+    }
 
-    (*this)[key] = std::move(fooTexture);
+    store(key, fooTexture, &content);
     return true;
 }
 
-bool TextureManager::loadFromImage(const std::string &key, const sf::Image &image, const sf::IntRect &area)
+bool TextureManager::loadReduced(const std::string &key, const sf::Image &image, const sf::IntRect &area, const std::uint64_t *content)
+{
+    if(m_resolutionLevel == 0) return storeImage(key, image, area, content);
+
+    sf::Image reduced;
+    return reduceImage(image, area, m_resolutionLevel, m_pool, reduced) && storeImage(key, reduced, sf::IntRect(), content);
+}
+
+bool TextureManager::storeImage(const std::string &key, const sf::Image &image, const sf::IntRect &area, const std::uint64_t *content)
 {
+    std::uint64_t pixelContent = 0;
+    if(!content)
+    {
+        sf::Vector2u size = image.getSize();
+        const int shape[6] = {static_cast<int>(size.x), static_cast<int>(size.y), area.left, area.top, area.width, area.height};
+        pixelContent = xxHash64(shape, sizeof(shape), xxHash64(image.getPixelsPtr(), static_cast<std::size_t>(size.x) * size.y * 4));
+        content = &pixelContent;
+    }
+    if(shareContent(key, *content)) return true;
+
     sf::Texture fooTexture;
     if(!fooTexture.loadFromImage(image, area)) return false;
 
-    (*this)[key] = std::move(fooTexture);
+    store(key, fooTexture, content);
     return true;
 }
 
+bool TextureManager::loadFromPack(const std::string &key, const Pack &pack, std::string_view name, const sf::IntRect &area)
+{
+    PackStream stream;
+    if(!pack.openStream(name, stream)) return false;
+
+    return loadFromMemory(key, stream.getData(), static_cast<std::size_t>(stream.getSize()), area);
+}
+
+bool TextureManager::loadFromAtlas(const std::string &prefix, const TextureAtlas &atlas)
+{
+    for(std::size_t page = 0; page < atlas.getPageCount(); ++page)
+    {
+        if(!loadFromImage(TextureAtlas::getPageKey(prefix, page), atlas.getPage(page))) return false;
+    }
+    return true;
+}
+
+AsyncLoad TextureManager::loadAsync(const std::string &key, const std::string &filename, const sf::IntRect &area)
+{
+    if(!m_uploadQueue) m_uploadQueue = std::make_shared<UploadQueue>();
+
+    AsyncLoad load(LoadStatus::Decoding);
+    decodeAsync(m_uploadQueue, key, filename, area, load, Priority::Normal);
+    return load;
+}
+
+std::size_t TextureManager::processUploads(std::size_t maxUploads)
+{
+    if(!m_uploadQueue || maxUploads == 0) return 0;
+
+    std::vector<Upload> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadQueue->mutex);
+        std::vector<Upload> &queued = m_uploadQueue->uploads;
+        std::size_t count = std::min(maxUploads, queued.size());
+        uploads.reserve(count);
+        std::move(queued.begin(), queued.begin() + count, std::back_inserter(uploads));
+        queued.erase(queued.begin(), queued.begin() + count);
+    }
+
+    for(Upload &upload : uploads)
+    {
+        bool loaded = storeImage(upload.key, upload.image, upload.area, &upload.content);
+        if(loaded) watchFile(upload.key, upload.filename, upload.fileArea);
+        upload.load.setStatus(loaded ? LoadStatus::Loaded : LoadStatus::Failed);
+    }
+    return uploads.size();
+}
+
+std::size_t TextureManager::getPendingUploadCount() const
+{
+    if(!m_uploadQueue) return 0;
+
+    std::lock_guard<std::mutex> lock(m_uploadQueue->mutex);
+    return m_uploadQueue->uploads.size();
+}
+
+const sf::Texture& TextureManager::stream(const std::string &key, const std::string &filename, float priority)
+{
+    auto request = m_streamRequests.find(key);
+    if(request != m_streamRequests.end() && request->second.priority != priority)
+    {
+        if(!request->second.load.isValid())
+        {
+            m_streamOrder.erase({request->second.priority, key});
+            m_streamOrder.emplace(priority, key);
+        }
+        request->second.priority = priority;
+    }
+
+    const sf::Texture *texture = this->get(key);
+    if(texture) return *texture;
+
+    if(m_placeholder.getSize().x == 0) m_placeholder.create(2, 2, sf::Color(128, 128, 128));
+    sf::Texture placeholder;
+    placeholder.loadFromImage(m_placeholder);
+    store(key, placeholder, nullptr);
+
+    m_streamRequests[key] = StreamRequest{filename, priority, AsyncLoad()};
+    m_streamOrder.emplace(priority, key);
+    return this->at(key);
+}
+
+std::size_t TextureManager::processStreaming()
+{
+    if(!m_streamQueue) m_streamQueue = std::make_shared<UploadQueue>();
+
+    std::size_t uploaded = uploadStreamed();
+    startStreamed();
+    return uploaded;
+}
+
+bool TextureManager::isStreaming(const std::string &key) const
+{
+    return m_streamRequests.find(key) != m_streamRequests.end();
+}
+
+std::size_t TextureManager::getStreamingLoadCount() const
+{
+    return m_streamLoads.size();
+}
+
+void TextureManager::setStreamingLimits(std::size_t maxLoads, std::size_t maxUploadBytes)
+{
+    m_maxStreamLoads = maxLoads;
+    m_maxStreamUploadBytes = maxUploadBytes;
+}
+
+void TextureManager::setPlaceholder(const sf::Image &image)
+{
+    m_placeholder = image;
+}
+
+void TextureManager::setMipmapping(bool generate)
+{
+    m_mipmapping = generate;
+}
+
+bool TextureManager::isMipmapping() const
+{
+    return m_mipmapping;
+}
+
+void TextureManager::setResolutionLevel(unsigned int level)
+{
+    m_resolutionLevel = level;
+}
+
+unsigned int TextureManager::getResolutionLevel() const
+{
+    return m_resolutionLevel;
+}
+
+void TextureManager::setDeduplication(bool enable)
+{
+    m_deduplication = enable;
+}
+
+bool TextureManager::isDeduplicating() const
+{
+    return m_deduplication;
+}
+
+void TextureManager::setCacheDirectory(const std::string &directory, bool compress)
+{
+    m_cache.setDirectory(directory);
+    m_cache.setCompression(compress);
+}
+
+const ImageCache& TextureManager::getImageCache() const
+{
+    return m_cache;
+}
+
+void TextureManager::setHotReload(bool enable)
+{
+    if(!enable)
+    {
+        // Decodes that are still running finish into the dropped queue
+        m_watcher.reset();
+        m_reloadSources.clear();
+        m_reloadQueue.reset();
+        return;
+    }
+    if(!m_watcher) m_watcher = std::make_unique<FileWatcher>();
+}
+
+bool TextureManager::isHotReloading() const
+{
+    return m_watcher != nullptr;
+}
+
+std::size_t TextureManager::processReloads(std::size_t maxUploads)
+{
+    if(!m_watcher) return 0;
+    if(!m_reloadQueue) m_reloadQueue = std::make_shared<UploadQueue>();
+
+    for(const std::string &path : m_watcher->pollChanges())
+    {
+        for(auto &[key, source] : m_reloadSources)
+        {
+            if(source.watchPath != path) continue;
+
+            // A new load supersedes one that is still decoding an older version of the file
+            source.load = AsyncLoad(LoadStatus::Decoding);
+            decodeAsync(m_reloadQueue, key, source.filename, source.area, source.load, Priority::Normal);
+        }
+    }
+
+    std::vector<Upload> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_reloadQueue->mutex);
+        std::vector<Upload> &queued = m_reloadQueue->uploads;
+        std::size_t count = std::min(maxUploads, queued.size());
+        uploads.reserve(count);
+        std::move(queued.begin(), queued.begin() + count, std::back_inserter(uploads));
+        queued.erase(queued.begin(), queued.begin() + count);
+    }
+
+    std::size_t reloaded = 0;
+    for(Upload &upload : uploads)
+    {
+        // The key can have been removed or loaded from another source while its file was decoded
+        auto source = m_reloadSources.find(upload.key);
+        bool current = source != m_reloadSources.end() && source->second.load == upload.load;
+
+        // Loading into the stored texture keeps sprites that refer to it valid
+        bool loaded = current && (*this)[upload.key].loadFromImage(upload.image, upload.area);
+        if(loaded)
+        {
+            if(m_mipmapping) (*this)[upload.key].generateMipmap();
+            updateResourceSize(upload.key);
+            ++reloaded;
+        }
+        upload.load.setStatus(loaded ? LoadStatus::Loaded : LoadStatus::Failed);
+    }
+    return reloaded;
+}
+
+void TextureManager::setWorkerPool(WorkerPool &pool)
+{
+    m_pool = &pool;
+    m_ownedPool.reset();
+}
+
+WorkerPool& TextureManager::getWorkerPool()
+{
+    if(!m_pool)
+    {
+        m_ownedPool = std::make_shared<WorkerPool>();
+        m_pool = m_ownedPool.get();
+    }
+    return *m_pool;
+}
+
+void TextureManager::decodeAsync(const std::shared_ptr<UploadQueue> &queue, const std::string &key, const std::string &filename, const sf::IntRect &area, AsyncLoad load, Priority priority)
+{
+    WorkerPool &pool = getWorkerPool();
+    pool.push([queue, load, key, filename, area, level = m_resolutionLevel, cache = m_cache, poolPtr = &pool]() mutable {
+        Upload upload{std::move(key), sf::Image(), area, load, filename, area, 0};
+        ImageCache::Entry entry;
+        std::uint64_t contentHash = 0;
+        bool decoded;
+        if(!cache.isEnabled())
+        {
+            std::vector<char> data;
+            decoded = impl::readFile(filename, data) && upload.image.loadFromMemory(data.data(), data.size());
+            if(decoded) contentHash = xxHash64(data.data(), data.size());
+        }
+        else if(cache.find(filename, entry))
+        {
+            upload.image.create(entry.getSize().x, entry.getSize().y, entry.getPixels());
+            contentHash = entry.getContentHash();
+            decoded = true;
+        }
+        else decoded = decodeFile(cache, filename, upload.image, contentHash);
+
+        if(!decoded)
+        {
+            load.setStatus(LoadStatus::Failed);
+            return;
+        }
+
+        // Reducing here leaves only the upload to the owning thread
+        if(level > 0)
+        {
+            sf::Image reduced;
+            if(!reduceImage(upload.image, area, level, poolPtr, reduced))
+            {
+                load.setStatus(LoadStatus::Failed);
+                return;
+            }
+            upload.image = std::move(reduced);
+            upload.area = sf::IntRect();
+        }
+
+        // The file bytes are the content key of every load, so this load shares a texture with loadFromFile of the same file
+        upload.content = getFileContent(contentHash, area, level);
+
+        load.setStatus(LoadStatus::Uploading);
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->uploads.push_back(std::move(upload));
+    }, priority);
+}
+
+bool TextureManager::buildPyramid(const sf::Image &image, const sf::IntRect &area, std::size_t levelCount, WorkerPool *pool, ImagePyramid &pyramid)
+{
+    sf::Vector2u size = image.getSize();
+    if(area.width <= 0 || area.height <= 0)
+    {
+        pyramid.build(image.getPixelsPtr(), size, levelCount, pool);
+        return pyramid.getLevelCount() > 0;
+    }
+
+    // Clamp the area to the image like sf::Texture::loadFromImage does
+    int left = std::clamp(area.left, 0, static_cast<int>(size.x));
+    int top = std::clamp(area.top, 0, static_cast<int>(size.y));
+    int width = std::min(area.width, static_cast<int>(size.x) - left);
+    int height = std::min(area.height, static_cast<int>(size.y) - top);
+    if(width <= 0 || height <= 0) return false;
+
+    sf::Image cropped;
+    cropped.create(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+    cropped.copy(image, 0, 0, sf::IntRect(left, top, width, height));
+    pyramid.build(cropped.getPixelsPtr(), cropped.getSize(), levelCount, pool);
+    return pyramid.getLevelCount() > 0;
+}
+
+bool TextureManager::reduceImage(const sf::Image &image, const sf::IntRect &area, unsigned int level, WorkerPool *pool, sf::Image &reduced)
+{
+    ImagePyramid pyramid;
+    if(!buildPyramid(image, area, static_cast<std::size_t>(level) + 1, pool, pyramid)) return false;
+
+    std::size_t last = pyramid.getLevelCount() - 1;
+    reduced.create(pyramid.getLevelSize(last).x, pyramid.getLevelSize(last).y, pyramid.getLevelPixels(last));
+    return true;
+}
+
+std::size_t TextureManager::uploadStreamed()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_streamQueue->mutex);
+        std::vector<Upload> &queued = m_streamQueue->uploads;
+        std::move(queued.begin(), queued.end(), std::back_inserter(m_streamUploads));
+        queued.clear();
+    }
+
+    // Priorities cannot change while uploading, so the uploads are ordered once
+    std::vector<std::pair<float, std::size_t>> order;
+    order.reserve(m_streamUploads.size());
+    for(std::size_t i = 0; i < m_streamUploads.size(); ++i)
+    {
+        auto request = m_streamRequests.find(m_streamUploads[i].key);
+        if(request != m_streamRequests.end() && request->second.load == m_streamUploads[i].load) order.emplace_back(request->second.priority, i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::size_t bytes = 0;
+    std::size_t uploaded = 0;
+    for(auto &[priority, index] : order)
+    {
+        Upload &upload = m_streamUploads[index];
+        sf::Vector2u size = upload.image.getSize();
+        std::size_t imageBytes = static_cast<std::size_t>(size.x) * size.y * 4;
+        if(uploaded > 0 && bytes + imageBytes > m_maxStreamUploadBytes) break;
+
+        // Storing a texture can evict keys whose textures are still waiting here
+        auto request = m_streamRequests.find(upload.key);
+        if(request == m_streamRequests.end() || !(request->second.load == upload.load)) continue;
+
+        std::string filename = std::move(request->second.filename);
+        m_streamRequests.erase(request);
+
+        // store swaps the pixels into the placeholder, so references to the texture of key stay valid
+        sf::Texture texture;
+        bool loaded = texture.loadFromImage(upload.image);
+        if(loaded)
+        {
+            store(upload.key, texture, nullptr);
+            watchFile(upload.key, filename, sf::IntRect());
+        }
+        upload.load.setStatus(loaded ? LoadStatus::Loaded : LoadStatus::Failed);
+
+        bytes += imageBytes;
+        ++uploaded;
+    }
+
+    // Stored uploads have no request anymore, and a key can have been removed, or removed and requested again, while its texture was decoded
+    std::size_t kept = 0;
+    for(std::size_t i = 0; i < m_streamUploads.size(); ++i)
+    {
+        Upload &upload = m_streamUploads[i];
+        auto request = m_streamRequests.find(upload.key);
+        if(request != m_streamRequests.end() && request->second.load == upload.load)
+        {
+            if(kept != i) m_streamUploads[kept] = std::move(upload);
+            ++kept;
+        }
+        else if(upload.load.getStatus() == LoadStatus::Uploading) upload.load.setStatus(LoadStatus::Failed);
+    }
+    m_streamUploads.erase(m_streamUploads.begin() + kept, m_streamUploads.end());
+    return uploaded;
+}
+
+void TextureManager::startStreamed()
+{
+    // Keys whose file could not be decoded keep showing the placeholder
+    for(auto &[key, load] : m_streamLoads)
+    {
+        if(load.getStatus() != LoadStatus::Failed) continue;
+
+        auto request = m_streamRequests.find(key);
+        if(request != m_streamRequests.end() && request->second.load == load) m_streamRequests.erase(request);
+    }
+    m_streamLoads.erase(std::remove_if(m_streamLoads.begin(), m_streamLoads.end(), [](const auto &pair){ return pair.second.isDone(); }), m_streamLoads.end());
+
+    while(m_streamLoads.size() < m_maxStreamLoads && !m_streamOrder.empty())
+    {
+        auto node = m_streamOrder.extract(m_streamOrder.begin());
+        const std::string &key = node.value().second;
+        StreamRequest &request = m_streamRequests.at(key);
+
+        request.load = AsyncLoad(LoadStatus::Decoding);
+        m_streamLoads.emplace_back(key, request.load);
+        decodeAsync(m_streamQueue, key, request.filename, sf::IntRect(), request.load, Priority::High);
+    }
+}
+
+std::size_t TextureManager::getDeduplicatedMemory() const
+{
+    std::size_t bytes = 0;
+    for(auto &alias : getAliases())
+    {
+        sf::Vector2u size = this->at(alias.second).getSize();
+        bytes += static_cast<std::size_t>(size.x) * size.y * 4;
+    }
+    return bytes;
+}
+
+void TextureManager::onErase(const std::string &key, sf::Texture &texture)
+{
+    forgetContent(key);
+    unwatchFile(key);
+
+    auto request = m_streamRequests.find(key);
+    if(request == m_streamRequests.end()) return;
+
+    if(!request->second.load.isValid()) m_streamOrder.erase({request->second.priority, key});
+    m_streamRequests.erase(request);
+}
+
+void TextureManager::onRename(const std::string &oldKey, const std::string &newKey, sf::Texture &texture)
+{
+    auto request = m_streamRequests.find(oldKey);
+    if(request != m_streamRequests.end())
+    {
+        // A decode that runs under the old key is dropped, and the file is decoded again under the new one
+        StreamRequest moved = std::move(request->second);
+        m_streamRequests.erase(request);
+        if(!moved.load.isValid()) m_streamOrder.erase({moved.priority, oldKey});
+        moved.load = AsyncLoad();
+        m_streamOrder.emplace(moved.priority, newKey);
+        m_streamRequests[newKey] = std::move(moved);
+    }
+
+    auto source = m_reloadSources.find(oldKey);
+    if(source != m_reloadSources.end())
+    {
+        m_reloadSources[newKey] = std::move(source->second);
+        m_reloadSources.erase(source);
+    }
+
+    auto it = m_contentOfKey.find(oldKey);
+    if(it == m_contentOfKey.end()) return;
+
+    std::uint64_t content = it->second;
+    m_contentOfKey.erase(it);
+    m_contentOfKey[newKey] = content;
+    auto owner = m_keyOfContent.find(content);
+    if(owner != m_keyOfContent.end() && owner->second == oldKey) owner->second = newKey;
+}
+
+void TextureManager::watchFile(const std::string &key, const std::string &filename, const sf::IntRect &area)
+{
+    if(!m_watcher) return;
+
+    unwatchFile(key);
+    if(m_watcher->watch(filename)) m_reloadSources[key] = ReloadSource{filename, FileWatcher::getWatchPath(filename), area, AsyncLoad()};
+}
+
+void TextureManager::unwatchFile(const std::string &key)
+{
+    auto source = m_reloadSources.find(key);
+    if(source == m_reloadSources.end()) return;
+
+    m_watcher->unwatch(source->second.filename);
+    m_reloadSources.erase(source);
+}
+
+void TextureManager::updateResourceSize(const std::string &key)
+{
+    sf::Vector2u size = (*this)[key].getSize();
+    setResourceSize(key, static_cast<std::size_t>(size.x) * size.y * 4);
+}
+
+bool TextureManager::shareContent(const std::string &key, std::uint64_t content)
+{
+    if(m_watcher || !m_deduplication) return false;
+
+    auto it = m_keyOfContent.find(content);
+    if(it == m_keyOfContent.end()) return false;
+    if(it->second == key) return true;
+
+    // A key that holds its own texture is loaded in place, since sprites may still point to that texture
+    if(this->find(key) != this->end()) return false;
+
+    addAlias(key, it->second);
+    return true;
+}
+
+void TextureManager::store(const std::string &key, sf::Texture &texture, const std::uint64_t *content)
+{
+    if(isAlias(key) || hasAliases(key)) remove(key);
+    forgetContent(key);
+    unwatchFile(key);
+
+    // Swapping avoids copying the texture on the GPU, sf::Texture has no move constructor
+    (*this)[key].swap(texture);
+    if(m_mipmapping) (*this)[key].generateMipmap();
+    if(content && !m_watcher)
+    {
+        // Another key may hold the same content after an in place reload, and stays the one that is shared
+        m_keyOfContent.try_emplace(*content, key);
+        m_contentOfKey[key] = *content;
+    }
+    updateResourceSize(key);
+}
+
+bool TextureManager::hasAliases(const std::string &key) const
+{
+    const auto &aliases = getAliases();
+    return std::any_of(aliases.begin(), aliases.end(), [&key](const auto &alias){ return alias.second == key; });
+}
+
+void TextureManager::forgetContent(const std::string &key)
+{
+    auto it = m_contentOfKey.find(key);
+    if(it == m_contentOfKey.end()) return;
+
+    std::uint64_t content = it->second;
+    m_contentOfKey.erase(it);
+    auto owner = m_keyOfContent.find(content);
+    if(owner == m_keyOfContent.end() || owner->second != key) return;
+
+    // Another key that has reloaded the same content in place takes over sharing it
+    auto heir = std::find_if(m_contentOfKey.begin(), m_contentOfKey.end(), [content](const auto &other){ return other.second == content; });
+    if(heir != m_contentOfKey.end()) owner->second = heir->first;
+    else m_keyOfContent.erase(owner);
+}
+
 } // namespace sfex
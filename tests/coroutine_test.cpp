@@ -0,0 +1,88 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <SFEX/General/Scheduler.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#if SFEX_HAS_COROUTINES
+
+std::thread::id mainThread;
+
+sfex::Coroutine script(sfex::Scheduler &scheduler, std::vector<int> &steps)
+{
+    steps.push_back(1);
+    co_await scheduler.nextFrame();
+    assert(std::this_thread::get_id() == mainThread);
+    steps.push_back(2);
+
+    co_await scheduler.delay(sf::milliseconds(20));
+    assert(std::this_thread::get_id() == mainThread);
+    steps.push_back(3);
+
+    co_await scheduler.delay(sf::milliseconds(1), sfex::Scheduler::Target::Worker);
+    assert(std::this_thread::get_id() != mainThread);
+    co_await scheduler.nextFrame();
+    assert(std::this_thread::get_id() == mainThread);
+    steps.push_back(4);
+}
+
+sfex::Coroutine throwingScript(sfex::Scheduler &scheduler)
+{
+    co_await scheduler.nextFrame();
+    throw std::runtime_error("script failed");
+}
+
+sfex::Coroutine neverFinishes(sfex::Scheduler &scheduler, std::shared_ptr<int> token)
+{
+    co_await scheduler.delay(sf::seconds(3600));
+}
+
+int main(int argc, char** argv)
+{
+    mainThread = std::this_thread::get_id();
+    sfex::Scheduler scheduler(2);
+    std::vector<int> steps;
+
+    sfex::Coroutine coroutine = script(scheduler, steps);
+    assert(!coroutine.isDone());
+    assert(steps == std::vector<int>{1});
+
+    scheduler.update();
+    assert(steps == (std::vector<int>{1, 2}));
+
+    while(!coroutine.isDone())
+    {
+        scheduler.update();
+        sf::sleep(sf::milliseconds(1));
+    }
+    assert((steps == std::vector<int>{1, 2, 3, 4}));
+    assert(!coroutine.getException());
+
+    sfex::Coroutine failing = throwingScript(scheduler);
+    scheduler.update();
+    assert(failing.isDone() && failing.getException());
+
+    // Suspended coroutines are destroyed together with the scheduler
+    std::shared_ptr<int> token = std::make_shared<int>(0);
+    {
+        sfex::Scheduler shortLived;
+        neverFinishes(shortLived, token);
+        assert(token.use_count() == 2);
+    }
+    assert(token.use_count() == 1);
+
+    std::cout << "Coroutine tests passed" << std::endl;
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    std::cout << "Coroutines are not supported by this compiler, skipping" << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFEX/General/FileWatcher.hpp>
+
+namespace fs = std::filesystem;
+
+void writeFile(const fs::path &path, const std::string &content)
+{
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+// Changes arrive on the watching thread, so wait for them instead of polling once
+std::vector<std::string> waitForChanges(sfex::FileWatcher &watcher, std::size_t count)
+{
+    std::vector<std::string> changes;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(changes.size() < count && std::chrono::steady_clock::now() < deadline)
+    {
+        for(std::string &change : watcher.pollChanges()) changes.push_back(std::move(change));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return changes;
+}
+
+bool contains(const std::vector<std::string> &changes, const fs::path &path)
+{
+    return std::find(changes.begin(), changes.end(), sfex::FileWatcher::getWatchPath(path.string())) != changes.end();
+}
+
+int main()
+{
+    fs::path directory = fs::temp_directory_path() / "sfex_filewatcher_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    fs::path texture = directory / "texture.png";
+    fs::path sound = directory / "sound.ogg";
+    fs::path other = directory / "other.txt";
+    writeFile(texture, "a");
+    writeFile(sound, "a");
+    writeFile(other, "a");
+
+    sfex::FileWatcher watcher;
+    assert(watcher.watch(texture.string()));
+    assert(watcher.watch((directory / "." / "texture.png").string()));
+    assert(watcher.watch(sound.string()));
+    assert(watcher.getWatchCount() == 2);
+    assert(watcher.isWatching(texture.string()));
+    assert(!watcher.isWatching(other.string()));
+    assert(sfex::FileWatcher::getWatchPath((directory / "x" / ".." / "texture.png").string()) == sfex::FileWatcher::getWatchPath(texture.string()));
+
+    // Modification times can have a coarse resolution, make sure the writes are noticed
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Writing in place, and unrelated files in the same directory are not reported
+    writeFile(other, "bb");
+    writeFile(texture, "bb");
+    std::vector<std::string> changes = waitForChanges(watcher, 1);
+    assert(changes.size() == 1);
+    assert(contains(changes, texture));
+
+    // Saving by replacing the file
+    fs::path temporary = directory / "sound.ogg.tmp";
+    writeFile(temporary, "bbb");
+    fs::rename(temporary, sound);
+    changes = waitForChanges(watcher, 1);
+    assert(changes.size() == 1);
+    assert(contains(changes, sound));
+
+    // Every watch has to be undone
+    watcher.unwatch(texture.string());
+    assert(watcher.isWatching(texture.string()));
+    watcher.unwatch(texture.string());
+    assert(!watcher.isWatching(texture.string()));
+    assert(watcher.getWatchCount() == 1);
+
+    writeFile(texture, "cccc");
+    writeFile(sound, "cccc");
+    changes = waitForChanges(watcher, 1);
+    assert(changes.size() == 1);
+    assert(contains(changes, sound));
+
+    fs::remove_all(directory);
+
+    std::cout << "FileWatcher tests passed" << std::endl;
+    return 0;
+}
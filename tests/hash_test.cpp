@@ -0,0 +1,27 @@
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <vector>
+#include <SFEX/General/Hash.hpp>
+
+int main()
+{
+    // Reference values of XXH64
+    const char *sentence = "Nobody inspects the spammish repetition";
+    assert(sfex::xxHash64("", 0) == 0xEF46DB3751D8E999ULL);
+    assert(sfex::xxHash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+    assert(sfex::xxHash64("abc", 3, 1) == 0xBEA9CA8199328908ULL);
+    assert(sfex::xxHash64(sentence, std::strlen(sentence)) == 0xFBCEA83C8A378BF1ULL);
+
+    std::vector<unsigned char> bytes(101);
+    for(std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<unsigned char>(i);
+    assert(sfex::xxHash64(bytes.data(), 100) == 0x6AC1E58032166597ULL);
+
+    // Unaligned data hashes the same as aligned data
+    std::vector<unsigned char> shifted(bytes.begin() + 1, bytes.end());
+    assert(sfex::xxHash64(bytes.data() + 1, 100) == sfex::xxHash64(shifted.data(), 100));
+    assert(sfex::xxHash64(bytes.data() + 1, 100) != sfex::xxHash64(bytes.data(), 100));
+
+    std::cout << "Hash tests passed" << std::endl;
+    return 0;
+}
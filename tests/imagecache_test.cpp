@@ -0,0 +1,119 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SFEX/Graphics/ImageCache.hpp>
+#include <SFEX/General/Hash.hpp>
+
+namespace fs = std::filesystem;
+
+void writeFile(const fs::path &path, const std::string &content)
+{
+    std::ofstream(path, std::ios::binary).write(content.data(), content.size());
+}
+
+std::vector<std::uint8_t> makePixels(const sfex::Vec2u &size)
+{
+    // Flat rows with a few varying ones, so that compression has something to do
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(size.x) * size.y * 4);
+    for(std::size_t i = 0; i < pixels.size(); ++i) pixels[i] = (i / (size.x * 4)) % 7 == 0 ? static_cast<std::uint8_t>(i * 31) : 200;
+    return pixels;
+}
+
+bool findsPixels(const sfex::ImageCache &cache, const std::string &source, const std::vector<std::uint8_t> &pixels, const sfex::Vec2u &size, std::uint64_t hash)
+{
+    sfex::ImageCache::Entry entry;
+    if(!cache.find(source, entry)) return false;
+
+    assert(entry.getSize() == size);
+    assert(entry.getContentHash() == hash);
+    assert(std::memcmp(entry.getPixels(), pixels.data(), pixels.size()) == 0);
+    return true;
+}
+
+void cacheTest(const fs::path &directory, bool compress)
+{
+    fs::path sourcePath = directory / "image.png";
+    std::string source = sourcePath.string();
+    std::string content = "encoded image";
+    writeFile(sourcePath, content);
+    std::uint64_t hash = sfex::xxHash64(content.data(), content.size());
+
+    sfex::ImageCache cache((directory / "cache").string(), compress);
+    sfex::Vec2u size(37, 21);
+    std::vector<std::uint8_t> pixels = makePixels(size);
+
+    assert(!findsPixels(cache, source, pixels, size, hash));
+    assert(cache.store(source, hash, size, pixels.data()));
+    assert(findsPixels(cache, source, pixels, size, hash));
+
+    // Another spelling of the same path finds the same entry
+    assert(findsPixels(cache, (directory / "." / "image.png").string(), pixels, size, hash));
+
+    // A touched source with unchanged content stays valid
+    fs::last_write_time(sourcePath, fs::last_write_time(sourcePath) + std::chrono::hours(1));
+    assert(findsPixels(cache, source, pixels, size, hash));
+    assert(findsPixels(cache, source, pixels, size, hash));
+
+    // Changed content of the same size does not
+    writeFile(sourcePath, "encoded imagf");
+    fs::last_write_time(sourcePath, fs::last_write_time(sourcePath) + std::chrono::hours(2));
+    assert(!findsPixels(cache, source, pixels, size, hash));
+
+    writeFile(sourcePath, "longer encoded image");
+    assert(!findsPixels(cache, source, pixels, size, hash));
+
+    // Storing again replaces the entry
+    content = "longer encoded image";
+    hash = sfex::xxHash64(content.data(), content.size());
+    assert(cache.store(source, hash, size, pixels.data()));
+    assert(findsPixels(cache, source, pixels, size, hash));
+
+    // Corrupted cache files are rejected
+    for(const auto &file : fs::directory_iterator(directory / "cache"))
+    {
+        fs::resize_file(file.path(), fs::file_size(file.path()) - 1);
+    }
+    assert(!findsPixels(cache, source, pixels, size, hash));
+
+    assert(cache.store(source, hash, size, pixels.data()));
+    cache.clear();
+    assert(fs::is_empty(directory / "cache"));
+    assert(!findsPixels(cache, source, pixels, size, hash));
+
+    assert(!cache.store((directory / "missing.png").string(), hash, size, pixels.data()));
+    assert(!cache.store(source, hash, sfex::Vec2u(0, 4), pixels.data()));
+}
+
+void disabledTest(const fs::path &directory)
+{
+    fs::path sourcePath = directory / "image.png";
+    writeFile(sourcePath, "encoded image");
+
+    sfex::ImageCache cache;
+    assert(!cache.isEnabled());
+
+    std::vector<std::uint8_t> pixels(16, 1);
+    sfex::ImageCache::Entry entry;
+    assert(!cache.store(sourcePath.string(), 1, sfex::Vec2u(2, 2), pixels.data()));
+    assert(!cache.find(sourcePath.string(), entry));
+}
+
+int main()
+{
+    fs::path directory = fs::temp_directory_path() / "sfex_imagecache_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    cacheTest(directory, false);
+    cacheTest(directory, true);
+    disabledTest(directory);
+    fs::remove_all(directory);
+
+    std::cout << "ImageCache tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <SFEX/Graphics/ImagePyramid.hpp>
+
+std::vector<std::uint8_t> makeImage(const sfex::Vec2u &size, unsigned int seed)
+{
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(size.x) * size.y * 4);
+    for(std::uint8_t &value : pixels)
+    {
+        seed = seed * 1103515245u + 12345u;
+        value = static_cast<std::uint8_t>(seed >> 16);
+    }
+    return pixels;
+}
+
+// Straightforward 2x2 box filter the optimized one has to match exactly
+std::vector<std::uint8_t> referenceDownscale(const std::vector<std::uint8_t> &source, const sfex::Vec2u &size)
+{
+    sfex::Vec2u targetSize = sfex::ImagePyramid::getDownscaledSize(size);
+    std::vector<std::uint8_t> target(static_cast<std::size_t>(targetSize.x) * targetSize.y * 4);
+    auto at = [&](unsigned int x, unsigned int y, unsigned int c){
+        return source[(static_cast<std::size_t>(std::min(y, size.y - 1)) * size.x + std::min(x, size.x - 1)) * 4 + c];
+    };
+    for(unsigned int y = 0; y < targetSize.y; ++y)
+    {
+        for(unsigned int x = 0; x < targetSize.x; ++x)
+        {
+            for(unsigned int c = 0; c < 4; ++c)
+            {
+                unsigned int sum = at(2 * x, 2 * y, c) + at(2 * x + 1, 2 * y, c) + at(2 * x, 2 * y + 1, c) + at(2 * x + 1, 2 * y + 1, c);
+                target[(static_cast<std::size_t>(y) * targetSize.x + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return target;
+}
+
+void downscaleTest(sfex::WorkerPool &pool)
+{
+    const std::vector<sfex::Vec2u> sizes = {
+        {1, 1}, {2, 2}, {1, 7}, {9, 1}, {3, 3}, {8, 8}, {9, 5}, {17, 16}, {64, 33}, {255, 3}, {2048, 40}, {100, 1000},
+    };
+    for(std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        std::vector<std::uint8_t> source = makeImage(sizes[i], static_cast<unsigned int>(i));
+        std::vector<std::uint8_t> expected = referenceDownscale(source, sizes[i]);
+
+        std::vector<std::uint8_t> serial(expected.size());
+        sfex::ImagePyramid::downscale(source.data(), sizes[i], serial.data());
+        assert(serial == expected);
+
+        std::vector<std::uint8_t> parallel(expected.size());
+        sfex::ImagePyramid::downscale(source.data(), sizes[i], parallel.data(), &pool);
+        assert(parallel == expected);
+    }
+
+    // Flat colors stay the same
+    std::vector<std::uint8_t> flat(16 * 16 * 4, 200);
+    std::vector<std::uint8_t> flatTarget(8 * 8 * 4);
+    sfex::ImagePyramid::downscale(flat.data(), sfex::Vec2u(16, 16), flatTarget.data());
+    assert(flatTarget == std::vector<std::uint8_t>(8 * 8 * 4, 200));
+}
+
+void pyramidTest(sfex::WorkerPool &pool)
+{
+    sfex::Vec2u size(300, 70);
+    std::vector<std::uint8_t> source = makeImage(size, 42);
+
+    sfex::ImagePyramid pyramid;
+    pyramid.build(source.data(), size, 0, &pool);
+    assert(pyramid.getLevelCount() == 9);
+    assert(pyramid.getLevelSize(0) == size);
+    assert(pyramid.getLevelSize(1) == sfex::Vec2u(150, 35));
+    assert(pyramid.getLevelSize(2) == sfex::Vec2u(75, 17));
+    assert(pyramid.getLevelSize(6) == sfex::Vec2u(4, 1));
+    assert(pyramid.getLevelSize(8) == sfex::Vec2u(1, 1));
+    assert(std::equal(source.begin(), source.end(), pyramid.getLevelPixels(0)));
+
+    std::vector<std::uint8_t> level2 = referenceDownscale(referenceDownscale(source, size), pyramid.getLevelSize(1));
+    assert(std::equal(level2.begin(), level2.end(), pyramid.getLevelPixels(2)));
+
+    // The smallest level that still covers the requested size
+    assert(pyramid.findLevel(sfex::Vec2u(300, 70)) == 0);
+    assert(pyramid.findLevel(sfex::Vec2u(400, 10)) == 0);
+    assert(pyramid.findLevel(sfex::Vec2u(100, 20)) == 1);
+    assert(pyramid.findLevel(sfex::Vec2u(75, 17)) == 2);
+    assert(pyramid.findLevel(sfex::Vec2u(1, 1)) == 8);
+
+    pyramid.build(source.data(), size, 3);
+    assert(pyramid.getLevelCount() == 3);
+    assert(std::equal(level2.begin(), level2.end(), pyramid.getLevelPixels(2)));
+
+    pyramid.build(source.data(), sfex::Vec2u(0, 5));
+    assert(pyramid.getLevelCount() == 0);
+}
+
+int main()
+{
+    sfex::WorkerPool pool(3);
+    downscaleTest(pool);
+    pyramidTest(pool);
+
+    std::cout << "ImagePyramid tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,323 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <SFEX/Managers/ManagerBase.hpp>
+
+std::atomic<std::size_t> allocationCount = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if(void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+template<typename M, typename = void>
+struct CanExtract : std::false_type {};
+
+template<typename M>
+struct CanExtract<M, std::void_t<decltype(std::declval<M&>().extract(std::string()))>> : std::true_type {};
+
+template<typename M, typename = void>
+struct CanMerge : std::false_type {};
+
+template<typename M>
+struct CanMerge<M, std::void_t<decltype(std::declval<M&>().merge(std::declval<typename M::Map&>()))>> : std::true_type {};
+
+template<typename M, typename = void>
+struct CanInsertOrAssign : std::false_type {};
+
+template<typename M>
+struct CanInsertOrAssign<M, std::void_t<decltype(std::declval<M&>().insert_or_assign(std::string(), 0))>> : std::true_type {};
+
+template<typename M, typename = void>
+struct CanSwap : std::false_type {};
+
+template<typename M>
+struct CanSwap<M, std::void_t<decltype(std::declval<M&>().swap(std::declval<M&>()))>> : std::true_type {};
+
+// Members of the map that bypass the bookkeeping must not be reachable
+static_assert(!CanExtract<sfex::ManagerBase<int>>::value);
+static_assert(!CanMerge<sfex::ManagerBase<int>>::value);
+static_assert(!CanInsertOrAssign<sfex::ManagerBase<int>>::value);
+static_assert(!CanSwap<sfex::ManagerBase<int>>::value);
+static_assert(CanExtract<sfex::ManagerBase<int>::Map>::value);
+
+void filterTest()
+{
+    using Keys = std::vector<std::string>;
+    sfex::ManagerBase<int> manager;
+    manager["enemy_bat"] = 0;
+    manager["enemy_slime"] = 1;
+    manager["player_idle"] = 2;
+    manager["e"] = 3;
+
+    // Keys shorter than the pattern never match
+    assert((manager.filter("_idle", sfex::ManagerBase<int>::FilterType::Ends_with) == Keys{"player_idle"}));
+    assert((manager.filter("enemy_", sfex::ManagerBase<int>::FilterType::Starts_with) == Keys{"enemy_bat", "enemy_slime"}));
+    assert(manager.filter("enemy_bat_", sfex::ManagerBase<int>::FilterType::Starts_with).empty());
+    assert(manager.filter("x_idle", sfex::ManagerBase<int>::FilterType::Ends_with).empty());
+    assert(manager.filter("", sfex::ManagerBase<int>::FilterType::Starts_with).size() == 4);
+
+    // The indexes follow every way of inserting and removing keys
+    manager["enemy_ghost"] = 4;
+    manager.insert({"enemy_rat", 5});
+    manager.emplace("boss_idle", 6);
+    manager.try_emplace("enemy_slime", 7);
+    manager.remove("enemy_bat");
+    manager.erase("player_idle");
+    assert((manager.filter("enemy_", sfex::ManagerBase<int>::FilterType::Starts_with) == Keys{"enemy_ghost", "enemy_rat", "enemy_slime"}));
+    assert((manager.filter("idle", sfex::ManagerBase<int>::FilterType::Ends_with) == Keys{"boss_idle"}));
+    assert(manager.at("enemy_slime") == 1);
+
+    Keys contains = manager.filter("_", sfex::ManagerBase<int>::FilterType::Contains);
+    std::sort(contains.begin(), contains.end());
+    assert((contains == Keys{"boss_idle", "enemy_ghost", "enemy_rat", "enemy_slime"}));
+    assert((manager.filter("_", sfex::ManagerBase<int>::FilterType::Does_not_contain) == Keys{"e"}));
+
+    sfex::ManagerBase<int> copy;
+    copy["old"] = 0;
+    copy.filter("o", sfex::ManagerBase<int>::FilterType::Starts_with);
+    copy = manager;
+    assert((copy.filter("enemy_r", sfex::ManagerBase<int>::FilterType::Starts_with) == Keys{"enemy_rat"}));
+
+    manager.clear();
+    assert(manager.filter("enemy_", sfex::ManagerBase<int>::FilterType::Starts_with).empty());
+    manager["enemy_new"] = 8;
+    assert((manager.filter("enemy_", sfex::ManagerBase<int>::FilterType::Starts_with) == Keys{"enemy_new"}));
+
+    // Nodes built outside of the manager are indexed like any other insertion
+    sfex::ManagerBase<int>::Map outside{{"enemy_node", 9}, {"enemy_new", 10}};
+    assert(manager.insert(outside.extract("enemy_node")).inserted);
+    assert(!manager.insert(outside.extract("enemy_new")).inserted && manager.at("enemy_new") == 8);
+    assert((manager.filter("enemy_", sfex::ManagerBase<int>::FilterType::Starts_with) == Keys{"enemy_new", "enemy_node"}));
+}
+
+struct CountingManager : sfex::ManagerBase<int>
+{
+    std::vector<std::string> erased;
+    std::vector<std::string> renamed;
+
+protected:
+    void onErase(const std::string &key, int &resource) override
+    {
+        erased.push_back(key);
+    }
+
+    void onRename(const std::string &oldKey, const std::string &newKey, int &resource) override
+    {
+        renamed.push_back(oldKey + ">" + newKey);
+    }
+};
+
+// Counts shared memory towards heir once the resource it was counted for is removed
+struct SharingManager : sfex::ManagerBase<int>
+{
+    std::string heir;
+
+protected:
+    void onErase(const std::string &key, int &resource) override
+    {
+        if(key != heir) moveResourceSize(key, heir);
+    }
+};
+
+void sharedSizeTest()
+{
+    SharingManager manager;
+    manager.heir = "b";
+    for(const char *key : {"a", "b", "c"}) manager[key] = 0;
+    manager.setResourceSize("a", 60);
+    manager.setResourceSize("b", 0);
+    manager.setResourceSize("c", 30);
+
+    // The size stays counted while the heir keeps the memory alive
+    manager.erase("a");
+    assert(manager.getMemoryUsage() == 90);
+
+    // The heir keeps its place in the usage list and is evicted with the size it has taken over
+    manager.setMemoryBudget(50);
+    assert(!manager.contains("b") && manager.contains("c"));
+    assert(manager.getMemoryUsage() == 30);
+}
+
+void aliasTest()
+{
+    CountingManager manager;
+    manager["hero"] = 1;
+    manager["enemy"] = 2;
+    assert(!manager.addAlias("ghost", "missing"));
+    assert(manager.addAlias("hero_copy", "hero") && manager.addAlias("hero_twin", "hero_copy"));
+
+    // Aliases resolve to the same resource but are not keys of their own
+    assert(manager.get("hero_copy") == manager.get("hero") && &manager["hero_twin"] == manager.get("hero"));
+    assert(manager.acquire("hero_twin") == manager.acquire("hero"));
+    assert(manager.isAlias("hero_copy") && !manager.isAlias("hero") && manager.getAliases().at("hero_twin") == "hero");
+    assert(manager.size() == 2 && manager.keys().size() == 2);
+    assert(manager.filter("hero", sfex::ManagerBase<int>::FilterType::Starts_with).size() == 1);
+
+    // Removing the key moves the resource to an alias and keeps its handle
+    sfex::ManagerBase<int>::Handle hero = manager.acquire("hero");
+    manager.remove("hero");
+    assert(!manager.contains("hero") && manager.contains("hero_copy") && !manager.isAlias("hero_copy"));
+    assert(manager.get(hero) == manager.get("hero_twin") && *manager.get(hero) == 1);
+    assert((manager.renamed == std::vector<std::string>{"hero>hero_copy"}) && manager.erased.empty());
+    assert(manager.filter("hero", sfex::ManagerBase<int>::FilterType::Starts_with) == std::vector<std::string>{"hero_copy"});
+
+    // Storing a resource under an alias replaces the alias, aliasing a key replaces its resource
+    manager.insert({"hero_twin", 3});
+    assert(!manager.isAlias("hero_twin") && manager["hero_twin"] == 3);
+    assert(manager.addAlias("enemy", "hero_copy") && manager["enemy"] == 1);
+    assert((manager.erased == std::vector<std::string>{"enemy"}) && manager.size() == 2);
+
+    // Erasing by iterator removes the aliases too
+    manager.erase(manager.find("hero_copy"));
+    assert(!manager.contains("enemy") && manager.getAliases().empty() && manager.size() == 1);
+    manager.erase("hero_twin");
+    assert(manager.empty());
+}
+
+void budgetTest()
+{
+    CountingManager manager;
+    manager.setMemoryBudget(100);
+    for(const char *key : {"a", "b", "c"})
+    {
+        manager[key] = 0;
+        manager.setResourceSize(key, 40);
+    }
+
+    // The least recently used resource goes first
+    assert(!manager.contains("a") && manager.contains("b") && manager.contains("c"));
+    assert(manager.getMemoryUsage() == 80);
+    assert((manager.erased == std::vector<std::string>{"a"}));
+
+    // Using a resource protects it
+    sfex::ManagerBase<int>::Handle b = manager.acquire("b");
+    manager["d"] = 0;
+    manager.setResourceSize("d", 40);
+    assert(manager.contains(b) && !manager.contains("c") && manager.contains("d"));
+
+    // Referenced resources are never evicted, they are removed once the last reference is gone
+    {
+        sfex::ManagerBase<int>::Reference reference = manager.reference("b");
+        sfex::ManagerBase<int>::Reference copy = reference;
+        assert(reference.isValid() && *copy.get() == 0);
+
+        manager["e"] = 0;
+        manager.setResourceSize("e", 40);
+        assert(manager.contains("b") && !manager.contains("d") && manager.contains("e"));
+
+        manager.setMemoryBudget(50);
+        assert(manager.contains("b") && !manager.contains("e"));
+        assert(manager.getMemoryUsage() == 40);
+
+        manager.setResourceSize("b", 60);
+        assert(manager.contains("b"));
+    }
+    assert(!manager.contains("b"));
+    assert(manager.getMemoryUsage() == 0);
+
+    // Resources without a size are never evicted, and a resource that is larger than the whole budget stays until something else is loaded
+    manager["unsized"] = 1;
+    manager["f"] = 0;
+    manager.setResourceSize("f", 80);
+    assert(manager.contains("unsized") && manager.contains("f"));
+
+    sfex::ManagerBase<int>::CacheStatistics statistics = manager.getCacheStatistics();
+    assert(statistics.evictions == 5);
+    assert(statistics.memoryBudget == 50 && statistics.memoryUsage == 80);
+    assert(statistics.hits >= 3);
+    assert(manager.get("a") == nullptr);
+    assert(manager.getCacheStatistics().misses == statistics.misses + 1);
+
+    manager.clear();
+    assert(manager.erased.size() == 7);
+}
+
+int main(int argc, char** argv)
+{
+    sfex::ManagerBase<int> manager;
+    manager["player"] = 1;
+    manager["enemy"] = 2;
+
+    // Handles
+    sfex::ManagerBase<int>::Handle player = manager.acquire("player");
+    sfex::ManagerBase<int>::Handle enemy = manager.acquire("enemy");
+    assert(manager.contains(player) && manager.contains(enemy));
+    assert(player != enemy);
+    assert(manager.acquire("player") == player);
+    assert(*manager.get(player) == 1 && *manager.get(enemy) == 2);
+
+    // Replacing the resource keeps the handle
+    manager["player"] = 10;
+    assert(*manager.get(player) == 10);
+
+    // Handles survive rehashing
+    for(int i = 0; i < 1000; ++i)
+    {
+        manager["filler" + std::to_string(i)] = i;
+    }
+    assert(*manager.get(player) == 10);
+
+    assert(!manager.contains(manager.acquire("missing")));
+    assert(manager.get(sfex::ManagerBase<int>::Handle()) == nullptr);
+
+    // Removed resources leave stale handles, even when the slot is reused
+    manager.remove("enemy");
+    assert(manager.get(enemy) == nullptr);
+    manager["enemy"] = 3;
+    sfex::ManagerBase<int>::Handle newEnemy = manager.acquire("enemy");
+    assert(newEnemy.index == enemy.index && newEnemy != enemy);
+    assert(manager.get(enemy) == nullptr && *manager.get(newEnemy) == 3);
+
+    manager.erase(manager.find("player"));
+    assert(!manager.contains(player));
+
+    // Lookups with literals and views do not allocate, even for keys that are too long for the small string buffer
+    manager["a_key_that_is_too_long_for_sso"] = 4;
+    std::string_view view = "a_key_that_is_too_long_for_sso";
+    assert(manager.contains(view));
+    std::size_t allocationsBefore = allocationCount;
+    for(int i = 0; i < 100; ++i)
+    {
+        assert(manager.contains("a_key_that_is_too_long_for_sso"));
+        assert(*manager.get(view) == 4);
+        assert(!manager.contains("another_key_that_is_not_stored"));
+    }
+    assert(allocationCount == allocationsBefore);
+    manager.remove(view);
+    assert(!manager.contains(view));
+
+    // Copies do not share handles
+    sfex::ManagerBase<int> copy = manager;
+    assert(copy.get(newEnemy) == nullptr && copy.contains("enemy"));
+
+    manager.clear();
+    assert(manager.empty() && !manager.contains(newEnemy));
+
+    filterTest();
+    budgetTest();
+    sharedSizeTest();
+    aliasTest();
+
+    std::cout << "ManagerBase tests passed" << std::endl;
+    return 0;
+}
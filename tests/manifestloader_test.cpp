@@ -0,0 +1,118 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <SFEX/Managers/ManifestLoader.hpp>
+
+namespace fs = std::filesystem;
+
+void writeFile(const fs::path &path, const std::string &content)
+{
+    std::ofstream(path, std::ios::binary).write(content.data(), content.size());
+}
+
+void appendInteger(std::string &data, std::uint32_t value, std::size_t bytes)
+{
+    for(std::size_t i = 0; i < bytes; ++i) data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+// A tenth of a second of 16 bit mono silence at 8000 Hz
+void writeWave(const fs::path &path)
+{
+    const std::uint32_t sampleRate = 8000;
+    const std::uint32_t dataSize = sampleRate / 10 * 2;
+    std::string data = "RIFF";
+    appendInteger(data, 36 + dataSize, 4);
+    data += "WAVEfmt ";
+    appendInteger(data, 16, 4);
+    appendInteger(data, 1, 2);
+    appendInteger(data, 1, 2);
+    appendInteger(data, sampleRate, 4);
+    appendInteger(data, sampleRate * 2, 4);
+    appendInteger(data, 2, 2);
+    appendInteger(data, 16, 2);
+    data += "data";
+    appendInteger(data, dataSize, 4);
+    data.append(dataSize, '\0');
+    writeFile(path, data);
+}
+
+void loadTest(const fs::path &directory)
+{
+    sf::Image image;
+    image.create(4, 4, sf::Color(10, 20, 30));
+    assert(image.saveToFile((directory / "player.png").string()));
+    writeWave(directory / "jump.wav");
+    writeFile(directory / "manifest.json",
+        "{\"textures\": {\"player\": \"player.png\", \"missing\": \"missing.png\"}, \"sounds\": {\"jump\": \"jump.wav\"}, \"music\": {\"theme\": \"jump.wav\"}}");
+
+    sfex::TextureManager textures;
+    sfex::SoundManager sounds;
+    sfex::MusicManager music;
+    sfex::ManifestLoader loader(textures, sounds, music);
+    assert(!loader.loadFromFile((directory / "absent.json").string()));
+    assert(loader.isDone());
+
+    assert(loader.loadFromFile((directory / "manifest.json").string()));
+    assert(loader.getPendingCount() == 4);
+    assert(loader.getTotalBytes() == fs::file_size(directory / "player.png") + fs::file_size(directory / "jump.wav"));
+
+    loader.finish();
+    assert(loader.isDone());
+    assert(loader.getProgress() == 1.f);
+    assert(loader.getLoadedBytes() == loader.getTotalBytes());
+    assert(loader.getFailedKeys() == std::vector<std::string>{"missing"});
+    assert(textures.contains("player") && !textures.contains("missing"));
+    assert(sounds.contains("jump"));
+    assert(music.contains("theme"));
+}
+
+void malformedTest(const fs::path &directory)
+{
+    sfex::TextureManager textures;
+    sfex::SoundManager sounds;
+    sfex::MusicManager music;
+    sfex::ManifestLoader loader(textures, sounds, music);
+
+    // Whichever entry is visited first, a malformed manifest queues nothing
+    const char *manifests[] = {
+        "{\"sounds\": {\"jump\": \"jump.wav\"}, \"music\": {\"theme\": \"jump.wav\"}, \"unknown\": {}}",
+        "{\"sounds\": {\"jump\": \"jump.wav\", \"bad\": 3}, \"music\": {\"theme\": \"jump.wav\"}}",
+        "{\"music\": {\"theme\": \"jump.wav\"}, \"textures\": [\"player.png\"]}",
+    };
+    for(const char *manifest : manifests)
+    {
+        try
+        {
+            loader.load(sfex::Multitype::parse(manifest), directory.string());
+            assert(false);
+        }
+        catch(const std::invalid_argument&)
+        {
+        }
+        assert(loader.getPendingCount() == 0);
+        assert(loader.getTotalBytes() == 0);
+    }
+
+    loader.finish();
+    assert(loader.update() == 0);
+    assert(!sounds.contains("jump") && !music.contains("theme"));
+}
+
+int main()
+{
+    fs::path directory = fs::temp_directory_path() / "sfex_manifestloader_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    loadTest(directory);
+    malformedTest(directory);
+    fs::remove_all(directory);
+
+    std::cout << "ManifestLoader tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <SFEX/General/Mixer.hpp>
+
+using Mixer = sfex::Mixer;
+
+bool near(float a, float b, float tolerance=1e-4f)
+{
+    return std::fabs(a - b) <= tolerance;
+}
+
+Mixer::Source makeSource(const std::vector<std::int16_t> &samples, unsigned int channelCount=1, unsigned int sampleRate=44100)
+{
+    Mixer::Source source;
+    source.samples = samples.data();
+    source.sampleCount = samples.size();
+    source.channelCount = channelCount;
+    source.sampleRate = sampleRate;
+    return source;
+}
+
+std::vector<float> render(Mixer &mixer, std::size_t frameCount)
+{
+    std::vector<float> output(2 * frameCount);
+    mixer.render(output.data(), frameCount);
+    return output;
+}
+
+void panTest()
+{
+    std::vector<std::int16_t> mono(1000, 16384);
+    std::vector<std::int16_t> stereo(2000);
+    for(std::size_t i = 0; i < stereo.size(); ++i) stereo[i] = i % 2 ? -8192 : 16384;
+
+    Mixer mixer;
+    Mixer::VoiceSettings settings;
+    Mixer::VoiceId voice = mixer.play(makeSource(mono), settings);
+    std::vector<float> output = render(mixer, 4);
+    // Constant power panning puts a centered mono voice 3 dB down on both sides
+    assert(near(output[0], 0.5f * std::sqrt(0.5f)) && near(output[1], output[0]));
+
+    mixer.setPan(voice, -1.f);
+    output = render(mixer, 4);
+    assert(near(output[6], 0.5f) && near(output[7], 0.f));
+    mixer.setPan(voice, 1.f);
+    mixer.setGain(voice, 0.5f);
+    output = render(mixer, 4);
+    assert(near(output[6], 0.f) && near(output[7], 0.25f));
+    mixer.stop(voice);
+
+    // Stereo voices keep their channels and are balanced
+    settings.pan = 0.5f;
+    mixer.play(makeSource(stereo, 2), settings);
+    output = render(mixer, 4);
+    assert(near(output[0], 0.25f) && near(output[1], -0.25f));
+}
+
+void pitchTest()
+{
+    std::vector<std::int16_t> ramp(64);
+    for(std::size_t i = 0; i < ramp.size(); ++i) ramp[i] = static_cast<std::int16_t>(i * 256);
+
+    // Twice the pitch skips every other frame and ends after half the frames
+    Mixer mixer;
+    Mixer::VoiceSettings settings;
+    settings.pan = -1.f;
+    settings.pitch = 2.f;
+    Mixer::VoiceId voice = mixer.play(makeSource(ramp), settings);
+    std::vector<float> output = render(mixer, 40);
+    for(std::size_t i = 0; i < 32; ++i) assert(near(output[2 * i], i * 512 / 32768.f));
+    for(std::size_t i = 32; i < 40; ++i) assert(output[2 * i] == 0.f);
+    assert(!mixer.isPlaying(voice));
+    assert(mixer.getVoiceCount() == 0);
+
+    // A source at half the output rate is interpolated between its frames
+    settings.pitch = 1.f;
+    mixer.play(makeSource(ramp, 1, 22050), settings);
+    output = render(mixer, 126);
+    for(std::size_t i = 0; i < 126; ++i) assert(near(output[2 * i], i * 128 / 32768.f));
+}
+
+void loopTest()
+{
+    std::vector<std::int16_t> samples = {1000, 2000, 3000};
+
+    Mixer mixer;
+    Mixer::VoiceSettings settings;
+    settings.pan = -1.f;
+    settings.loop = true;
+    Mixer::VoiceId voice = mixer.play(makeSource(samples), settings);
+    // Long enough to loop within one block and across blocks
+    std::vector<float> output = render(mixer, 1000);
+    for(std::size_t i = 0; i < 1000; ++i) assert(near(output[2 * i], samples[i % 3] / 32768.f));
+    assert(mixer.isPlaying(voice));
+    mixer.stopAll();
+    assert(!mixer.isPlaying(voice));
+}
+
+void busTest()
+{
+    std::vector<std::int16_t> samples(100, 8192);
+
+    Mixer mixer;
+    Mixer::VoiceSettings settings;
+    settings.pan = -1.f;
+    settings.bus = Mixer::Bus::Music;
+    Mixer::VoiceId music = mixer.play(makeSource(samples), settings);
+    settings.bus = Mixer::Bus::Ui;
+    mixer.play(makeSource(samples), settings);
+
+    mixer.setBusGain(Mixer::Bus::Music, 0.5f);
+    mixer.setMasterGain(2.f);
+    assert(mixer.getBusGain(Mixer::Bus::Music) == 0.5f && mixer.getMasterGain() == 2.f);
+    std::vector<float> output = render(mixer, 10);
+    assert(near(output[0], 0.75f));
+
+    // A paused bus keeps the position of its voices
+    mixer.setBusPaused(Mixer::Bus::Music, true);
+    assert(mixer.isBusPaused(Mixer::Bus::Music));
+    output = render(mixer, 90);
+    assert(near(output[0], 0.5f));
+    assert(mixer.isPlaying(music) && mixer.getVoiceCount() == 1);
+    mixer.setBusPaused(Mixer::Bus::Music, false);
+    output = render(mixer, 100);
+    assert(near(output[2 * 89], 0.25f) && output[2 * 90] == 0.f);
+    assert(mixer.getVoiceCount() == 0);
+}
+
+void int16Test()
+{
+    std::vector<std::int16_t> samples(100, 30000);
+    std::vector<std::int16_t> quiet(100, -1000);
+
+    // Voices that sum beyond the range are clipped instead of wrapping around
+    Mixer mixer;
+    Mixer::VoiceSettings settings;
+    settings.pan = -1.f;
+    mixer.play(makeSource(samples), settings);
+    mixer.play(makeSource(samples), settings);
+    settings.pan = 1.f;
+    mixer.play(makeSource(quiet), settings);
+    std::vector<std::int16_t> output(2 * 33);
+    mixer.render(output.data(), 33);
+    for(std::size_t i = 0; i < 33; ++i)
+    {
+        assert(output[2 * i] == 32767);
+        assert(std::abs(output[2 * i + 1] + 1000) <= 1);
+    }
+}
+
+void voiceLimitTest()
+{
+    std::vector<std::int16_t> samples(10, 100);
+
+    Mixer mixer(44100, 3);
+    assert(mixer.getMaxVoices() == 3);
+    Mixer::VoiceId a = mixer.play(makeSource(samples));
+    Mixer::VoiceId b = mixer.play(makeSource(samples));
+    Mixer::VoiceId c = mixer.play(makeSource(samples));
+    assert(a && b && c && a != b && b != c);
+    assert(mixer.play(makeSource(samples)) == 0);
+    assert(mixer.play(Mixer::Source()) == 0);
+
+    // A reused slot gets a new id, so the old one stays invalid
+    mixer.stop(b);
+    Mixer::VoiceId d = mixer.play(makeSource(samples));
+    assert(d && d != b);
+    assert(!mixer.isPlaying(b) && mixer.isPlaying(d));
+    mixer.setGain(b, 0.f);
+    std::vector<float> output = render(mixer, 1);
+    assert(output[0] > 0.f);
+}
+
+void manyVoicesTest()
+{
+    // The converted fast path and the interpolating path agree on unit pitch
+    std::vector<std::int16_t> samples(2 * 997);
+    for(std::size_t i = 0; i < samples.size(); ++i) samples[i] = static_cast<std::int16_t>((i * 7919) % 65536 - 32768);
+
+    Mixer mixer;
+    Mixer::VoiceSettings settings;
+    settings.gain = 1.f / 1000.f;
+    for(int i = 0; i < 1000; ++i) mixer.play(makeSource(samples, i % 2 + 1), settings);
+    assert(mixer.getVoiceCount() == 1000);
+
+    std::vector<float> output = render(mixer, 997);
+    for(std::size_t i = 0; i < 997; ++i)
+    {
+        float mono = samples[i] / 32768.f * std::sqrt(0.5f);
+        float expectedLeft = 0.5f * (mono + samples[2 * i] / 32768.f);
+        float expectedRight = 0.5f * (mono + samples[2 * i + 1] / 32768.f);
+        assert(near(output[2 * i], expectedLeft, 1e-3f));
+        assert(near(output[2 * i + 1], expectedRight, 1e-3f));
+    }
+    assert(mixer.getVoiceCount() == 500);
+}
+
+int main()
+{
+    panTest();
+    pitchTest();
+    loopTest();
+    busTest();
+    int16Test();
+    voiceLimitTest();
+    manyVoicesTest();
+
+    std::cout << "Mixer tests passed" << std::endl;
+    return 0;
+}
@@ -79,5 +79,18 @@ int main()
     std::unordered_map<std::string, int> m = map.as_map<int>();
     assert(m == initial_map);
 
+    // Keys of parsed objects are copied into buffers of their own length
+    sfex::Multitype object = sfex::Multitype::parse("{\"textures\": {\"player\": \"gfx/player.png\", \"a_rather_long_key_for_an_enemy\": \"gfx/enemy.png\"}, \"volume\": 3}");
+    assert(object.as_map().size() == 2);
+    assert(object.as_map()["volume"] == 3);
+    std::unordered_map<std::string, sfex::Multitype> textures = object.as_map()["textures"].as_map();
+    assert(textures["player"].as_string() == "gfx/player.png");
+    assert(textures["a_rather_long_key_for_an_enemy"].as_string() == "gfx/enemy.png");
+    sfex::MultitypeMap built = {
+        {"textures", sfex::MultitypeMap{{"player", "gfx/player.png"}, {"a_rather_long_key_for_an_enemy", "gfx/enemy.png"}}},
+        {"volume", 3},
+    };
+    assert(object == sfex::Multitype(built));
+
     return 0;
 }
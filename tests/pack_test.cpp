@@ -0,0 +1,146 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SFEX/General/Lz4.hpp>
+#include <SFEX/General/Pack.hpp>
+
+std::vector<char> makeData(std::size_t size, unsigned int seed)
+{
+    // Runs of repeated bytes and noise, so that there is something to compress and overlapping matches
+    std::vector<char> data(size);
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (i / 64) % 2 ? static_cast<char>('a' + i % 3) : static_cast<char>(seed >> 16);
+    }
+    return data;
+}
+
+void lz4Test()
+{
+    for(std::size_t size : {0, 1, 12, 13, 100, 5000, 70000})
+    {
+        std::vector<char> data = makeData(size, static_cast<unsigned int>(size));
+        std::vector<char> compressed = sfex::Lz4::compress(data.data(), data.size());
+
+        std::vector<char> decompressed(size);
+        assert(sfex::Lz4::decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()));
+        assert(decompressed == data);
+
+        // The exact size is required and truncated blocks are rejected
+        if(size == 0) continue;
+        std::vector<char> tooLarge(size + 1);
+        assert(!sfex::Lz4::decompress(compressed.data(), compressed.size(), tooLarge.data(), tooLarge.size()));
+        assert(!sfex::Lz4::decompress(compressed.data(), compressed.size() - 1, decompressed.data(), decompressed.size()));
+    }
+
+    std::vector<char> zeros(100000, 0);
+    assert(sfex::Lz4::compress(zeros.data(), zeros.size()).size() < 1000);
+}
+
+void packTest(const std::string &filename)
+{
+    std::vector<char> texture = makeData(3000, 1);
+    std::vector<char> sound = makeData(40000, 2);
+    std::string text = "hello";
+
+    sfex::PackWriter writer(64);
+    writer.add("textures/player.png", texture.data(), texture.size());
+    writer.add("sounds/jump.ogg", sound.data(), sound.size(), true);
+    writer.add("readme", text.data(), text.size(), true);
+    writer.add("empty", nullptr, 0);
+    assert(writer.getEntryCount() == 4);
+    assert(writer.saveToFile(filename));
+
+    sfex::Pack pack;
+    assert(pack.openFromFile(filename));
+    assert(pack.getEntries().size() == 4);
+    assert(pack.getEntries().front().name == "empty" && pack.getEntries().back().name == "textures/player.png");
+
+    const sfex::Pack::Entry *entry = pack.find("sounds/jump.ogg");
+    assert(entry && entry->compressed && entry->size < sound.size() && entry->originalSize == sound.size());
+    assert(pack.find("textures/player.png")->offset % 64 == 0);
+    assert(!pack.find("readme")->compressed);
+    assert(!pack.contains("sounds") && !pack.contains("textures/player.pn") && !pack.contains(""));
+
+    // Uncompressed entries are read from the mapping, compressed ones from the buffer of the stream
+    sfex::PackStream stream;
+    assert(stream.read(nullptr, 1) == -1 && stream.getSize() == -1);
+    assert(!pack.openStream("missing", stream));
+    assert(pack.openStream("sounds/jump.ogg", stream));
+    assert(std::vector<char>(stream.getData(), stream.getData() + stream.getSize()) == sound);
+
+    assert(pack.openStream("textures/player.png", stream));
+    assert(stream.getSize() == static_cast<sf::Int64>(texture.size()) && stream.tell() == 0);
+    char buffer[16];
+    assert(stream.seek(2990) == 2990);
+    assert(stream.read(buffer, sizeof(buffer)) == 10 && stream.tell() == 3000);
+    assert(std::equal(buffer, buffer + 10, texture.end() - 10));
+    assert(stream.read(buffer, sizeof(buffer)) == 0);
+    assert(stream.seek(5000) == 3000 && stream.seek(0) == 0);
+
+    assert(pack.openStream("empty", stream) && stream.getSize() == 0 && stream.read(buffer, 1) == 0);
+
+    // A failed open closes the entry the stream had open
+    assert(pack.openStream("textures/player.png", stream));
+    assert(!pack.openStream("missing", stream));
+    assert(stream.getSize() == -1 && stream.read(buffer, 1) == -1 && !stream.getData());
+
+    pack.close();
+    assert(pack.getEntries().empty() && !pack.openStream("readme", stream));
+}
+
+void corruptTest(const std::string &filename)
+{
+    sfex::Pack pack;
+    assert(!pack.openFromFile(filename + ".missing"));
+
+    std::vector<char> bytes;
+    {
+        std::ifstream file(filename, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto writeAndOpen = [&](const std::vector<char> &content){
+        std::ofstream(filename, std::ios::binary).write(content.data(), content.size());
+        return pack.openFromFile(filename);
+    };
+
+    std::vector<char> badSignature = bytes;
+    badSignature[0] = 'X';
+    assert(!writeAndOpen(badSignature));
+
+    // An entry that points past the end of the file
+    std::vector<char> truncated(bytes.begin(), bytes.end() - 100);
+    assert(!writeAndOpen(truncated));
+
+    assert(!writeAndOpen(std::vector<char>(10, 0)));
+    assert(writeAndOpen(bytes));
+
+    // A compressed entry that cannot be decompressed leaves no entry open, even one that used the buffer of the stream
+    const sfex::Pack::Entry entry = *pack.find("sounds/jump.ogg");
+    sfex::PackStream stream;
+    assert(pack.openStream("sounds/jump.ogg", stream));
+    std::vector<char> badEntry = bytes;
+    std::fill(badEntry.begin() + entry.offset, badEntry.begin() + entry.offset + entry.size, '\xFF');
+    assert(writeAndOpen(badEntry));
+    assert(!pack.openStream("sounds/jump.ogg", stream));
+    assert(stream.getSize() == -1 && stream.tell() == -1 && !stream.getData());
+}
+
+int main()
+{
+    lz4Test();
+
+    std::string filename = (std::filesystem::temp_directory_path() / "sfex_pack_test.sfexpack").string();
+    packTest(filename);
+    corruptTest(filename);
+    std::remove(filename.c_str());
+
+    std::cout << "Pack tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <SFEX/Graphics/RectanglePacker.hpp>
+
+struct Placement
+{
+    sfex::Vec2u position;
+    sfex::Vec2u size;
+};
+
+bool overlaps(const Placement &a, const Placement &b)
+{
+    return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x &&
+        a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+}
+
+std::vector<Placement> pack(sfex::RectanglePacker &packer, const std::vector<sfex::Vec2u> &sizes)
+{
+    std::vector<Placement> placements;
+    for(const sfex::Vec2u &size : sizes)
+    {
+        sfex::Vec2u position;
+        if(packer.insert(size, position)) placements.push_back({position, size});
+    }
+    return placements;
+}
+
+int main()
+{
+    // Equal squares fill the area without gaps
+    sfex::RectanglePacker packer(sfex::Vec2u(16, 16));
+    std::vector<Placement> squares = pack(packer, std::vector<sfex::Vec2u>(16, sfex::Vec2u(4, 4)));
+    assert(squares.size() == 16);
+    assert(packer.getUsedSize() == sfex::Vec2u(16, 16));
+
+    sfex::Vec2u position(123, 456);
+    assert(!packer.insert(sfex::Vec2u(1, 1), position));
+    assert(position == sfex::Vec2u(123, 456));
+
+    // Rectangles larger than the area never fit
+    packer.clear();
+    assert(packer.getUsedSize() == sfex::Vec2u(0, 0));
+    assert(!packer.insert(sfex::Vec2u(17, 1), position));
+    assert(!packer.insert(sfex::Vec2u(1, 17), position));
+    assert(!packer.insert(sfex::Vec2u(0, 4), position));
+    assert(packer.insert(sfex::Vec2u(16, 16), position) && position == sfex::Vec2u(0, 0));
+
+    // Mixed sizes stay inside the area, do not overlap and are placed the same way every time
+    std::vector<sfex::Vec2u> sizes;
+    unsigned int seed = 7;
+    for(int i = 0; i < 300; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        sizes.emplace_back(1 + (seed >> 16) % 40, 1 + (seed >> 8) % 40);
+    }
+
+    sfex::RectanglePacker first(sfex::Vec2u(256, 256));
+    std::vector<Placement> placements = pack(first, sizes);
+    assert(placements.size() > 50);
+
+    for(std::size_t i = 0; i < placements.size(); ++i)
+    {
+        const Placement &a = placements[i];
+        assert(a.position.x + a.size.x <= 256 && a.position.y + a.size.y <= 256);
+        assert(a.position.x + a.size.x <= first.getUsedSize().x && a.position.y + a.size.y <= first.getUsedSize().y);
+        for(std::size_t j = i + 1; j < placements.size(); ++j) assert(!overlaps(a, placements[j]));
+    }
+
+    sfex::RectanglePacker second(sfex::Vec2u(256, 256));
+    std::vector<Placement> again = pack(second, sizes);
+    assert(again.size() == placements.size());
+    for(std::size_t i = 0; i < again.size(); ++i)
+    {
+        assert(again[i].position == placements[i].position && again[i].size == placements[i].size);
+    }
+
+    std::cout << "RectanglePacker tests passed" << std::endl;
+    return 0;
+}
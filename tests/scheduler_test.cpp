@@ -1,7 +1,13 @@
 #include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdexcept>
 #include <SFEX/General/Scheduler.hpp>
+#include <SFML/System/Sleep.hpp>
 
-int repeatCount = 0;
+std::atomic<int> repeatCount = 0;
 
 int funcToSchedule(int a, int b)
 {
@@ -10,26 +16,252 @@ int funcToSchedule(int a, int b)
 
 void funcToRepeat()
 {
-    std::cout << "I am repeating!" << std::endl;
     ++repeatCount;
 }
 
-int main(int argc, char** argv)
+void stressTest()
 {
+    constexpr std::size_t jobCount = 1000;
+    constexpr std::size_t cancellerCount = 4;
+    std::atomic<int> calls = 0;
+
     sfex::Scheduler scheduler;
+    std::vector<sfex::JobHandle> handles;
+    handles.reserve(jobCount);
+    for(std::size_t i = 0; i < jobCount; ++i)
+    {
+        handles.push_back(scheduler.repeat(sf::milliseconds(50), [&calls](){ ++calls; }));
+    }
 
-    auto result = scheduler.schedule(sf::seconds(0.25f), funcToSchedule, 1, 2);    
-    scheduler.repeat("Hello", sf::seconds(0.25f), funcToRepeat);
+    // Cancel from several threads at once while the jobs are running
+    std::vector<std::thread> cancellers;
+    for(std::size_t c = 0; c < cancellerCount; ++c)
+    {
+        cancellers.emplace_back([&handles, c](){
+            for(std::size_t i = c; i < handles.size(); i += cancellerCount)
+            {
+                handles[i].cancel();
+                handles[i].cancel();
+            }
+        });
+    }
+    for(auto &thread : cancellers) thread.join();
 
-    while(true)
+    for(auto &handle : handles)
     {
-        if(repeatCount >= 3) 
+        assert(!handle.isActive());
+    }
+
+    sfex::JobHandle last = scheduler.repeat(sf::milliseconds(1), [](){});
+    assert(last.isActive());
+}
+
+void failureTest()
+{
+    sfex::VirtualClock clock;
+    sfex::Scheduler scheduler(clock, 2);
+
+    // A throwing run stops its job instead of terminating the worker
+    int runs = 0;
+    sfex::JobHandle failing = scheduler.repeat(sf::milliseconds(10), [&runs](){
+        if(++runs == 3) throw std::runtime_error("job failed");
+    });
+    scheduler.advance(sf::milliseconds(100));
+    assert(runs == 3);
+    assert(!failing.isActive() && failing.getException());
+    assert(failing.getStatistics().runCount == 3);
+
+    // Posted functions report their exceptions through their futures
+    auto posted = scheduler.post(sfex::Scheduler::Target::MainThread, [](){ throw std::runtime_error("post failed"); });
+    auto delayed = scheduler.postAfter(sf::milliseconds(5), sfex::Scheduler::Target::Worker, [](){ throw std::runtime_error("post failed"); });
+    scheduler.update();
+    scheduler.advance(sf::milliseconds(5));
+    for(auto *future : {&posted, &delayed})
+    {
+        bool threw = false;
+        try
+        {
+            future->get();
+        }
+        catch(const std::runtime_error &)
         {
-            scheduler.stopRepeatingJob("Hello");
-            break;
+            threw = true;
         }
+        assert(threw);
     }
-    std::cout << "The result of the scheduled function: " << result.get() << std::endl;
+
+    // cancelAll also stops a job that is running while it is called
+    sfex::JobHandle running;
+    running = scheduler.repeat(sf::milliseconds(10), [&scheduler](){ scheduler.cancelAll(); });
+    sfex::JobHandle waiting = scheduler.repeat(sf::milliseconds(10), [](){});
+    scheduler.advance(sf::milliseconds(50));
+    assert(!running.isActive() && !waiting.isActive());
+    assert(running.getStatistics().runCount == 1 && !running.getException());
+}
+
+void driftTest()
+{
+    sfex::VirtualClock clock;
+    sfex::Scheduler scheduler(clock);
+
+    // Every run takes 3ms, but runs stay on the 10ms ticks
+    int calls = 0;
+    sfex::JobHandle job = scheduler.repeat(sf::milliseconds(10), [&clock, &calls](){
+        ++calls;
+        clock.advance(sf::milliseconds(3));
+    });
+    scheduler.advance(sf::milliseconds(500));
+    assert(calls == 51);
+
+    sfex::JobStatistics statistics = job.getStatistics();
+    assert(statistics.runCount == 51);
+    assert(statistics.skippedTicks == 0 && statistics.overrunCount == 0);
+    assert(statistics.maxJitter == sf::Time::Zero);
+    assert(statistics.maxRunDuration == sf::milliseconds(3));
+
+    // Simulated hours take no real time
+    scheduler.advance(sf::seconds(3600));
+    assert(calls == 360051);
+    job.cancel();
+    scheduler.advance(sf::seconds(1));
+    assert(calls == 360051);
+}
+
+sfex::JobStatistics runBehindSchedule(sfex::CatchUpPolicy policy)
+{
+    sfex::VirtualClock clock;
+    sfex::Scheduler scheduler(clock);
+
+    sfex::JobHandle job = scheduler.repeat(sf::milliseconds(10), policy, [](){});
+    // Something else keeps the thread busy from 5ms to 45ms, so the ticks at 10, 20, 30 and 40ms are late
+    scheduler.postAfter(sf::milliseconds(5), sfex::Scheduler::Target::Worker, [&clock](){ clock.advance(sf::milliseconds(40)); });
+    scheduler.advance(sf::milliseconds(100));
+    return job.getStatistics();
+}
+
+void catchUpTest()
+{
+    // All four late ticks run at 45ms
+    sfex::JobStatistics burst = runBehindSchedule(sfex::CatchUpPolicy::Burst);
+    assert(burst.runCount == 11);
+    assert(burst.skippedTicks == 0);
+    assert(burst.overrunCount == 3);
+    assert(burst.maxJitter == sf::milliseconds(35));
+
+    // The late ticks are dropped and the job continues at 50ms
+    sfex::JobStatistics skip = runBehindSchedule(sfex::CatchUpPolicy::Skip);
+    assert(skip.runCount == 7);
+    assert(skip.skippedTicks == 4);
+    assert(skip.overrunCount == 0);
+    assert(skip.maxJitter == sf::Time::Zero);
+
+    // The late ticks are merged into one run at 45ms
+    sfex::JobStatistics coalesce = runBehindSchedule(sfex::CatchUpPolicy::Coalesce);
+    assert(coalesce.runCount == 8);
+    assert(coalesce.skippedTicks == 3);
+    assert(coalesce.overrunCount == 1);
+    assert(coalesce.maxJitter == sf::milliseconds(35));
+
+    assert(sfex::JobHandle().getStatistics().runCount == 0);
+}
+
+void destructionTest()
+{
+    // A task that the destructor drains adds a timer before the timer thread has ever started
+    std::atomic<bool> posted = false;
+    {
+        sfex::Scheduler scheduler(1);
+        scheduler.post(sfex::Scheduler::Target::Worker, [&scheduler, &posted](){
+            sf::sleep(sf::milliseconds(20));
+            scheduler.postAfter(sf::milliseconds(1), sfex::Scheduler::Target::Worker, [](){});
+            posted = true;
+        });
+    }
+    assert(posted);
+}
+
+int main(int argc, char** argv)
+{
+    sfex::VirtualClock clock;
+    sfex::Scheduler scheduler(clock);
+
+    auto result = scheduler.schedule(sf::seconds(0.25f), funcToSchedule, 1, 2);
+    scheduler.advance(sf::milliseconds(249));
+    assert(!result.isReady());
+    scheduler.advance(sf::milliseconds(1));
+    assert(result.isReady() && result.get() == 3);
+    std::cout << "The result of the scheduled function: " << 3 << std::endl;
+
+    sfex::JobHandle handle;
+    assert(!handle.isValid());
+    {
+        // The period and the function must outlive this scope only as copies inside the job
+        sf::Time period = sf::milliseconds(10);
+        handle = scheduler.repeat(period, funcToRepeat);
+    }
+    assert(handle.isValid() && handle.isActive());
+
+    scheduler.advance(sf::milliseconds(25));
+    assert(repeatCount == 3);
+    handle.cancel();
+    assert(!handle.isActive());
+    scheduler.advance(sf::milliseconds(100));
+    assert(repeatCount == 3);
+
+    // Delayed callbacks on the main thread only run inside update()
+    bool ranOnMain = false;
+    scheduler.postAfter(sf::milliseconds(5), sfex::Scheduler::Target::MainThread, [&ranOnMain](){ ranOnMain = true; });
+    scheduler.advance(sf::milliseconds(20));
+    assert(!ranOnMain);
+    std::uint64_t frames = scheduler.getFrameCount();
+    scheduler.update();
+    assert(ranOnMain);
+    assert(scheduler.getFrameCount() == frames + 1);
+
+    // Callbacks posted during update() wait for the next one
+    int order = 0;
+    scheduler.post(sfex::Scheduler::Target::MainThread, [&scheduler, &order](){
+        order = 1;
+        scheduler.post(sfex::Scheduler::Target::MainThread, [&order](){ order = 2; });
+    });
+    scheduler.update();
+    assert(order == 1);
+    scheduler.update();
+    assert(order == 2);
+
+    // Timers with the same deadline run in the order they were added
+    std::vector<int> sequence;
+    scheduler.postAfter(sf::milliseconds(2), sfex::Scheduler::Target::Worker, [&sequence](){ sequence.push_back(2); });
+    scheduler.postAfter(sf::milliseconds(1), sfex::Scheduler::Target::Worker, [&sequence](){ sequence.push_back(1); });
+    scheduler.postAfter(sf::milliseconds(2), sfex::Scheduler::Target::Worker, [&sequence](){ sequence.push_back(3); });
+    scheduler.advance(sf::milliseconds(1));
+    assert(sequence == std::vector<int>{1});
+    scheduler.advance(sf::milliseconds(1));
+    assert((sequence == std::vector<int>{1, 2, 3}));
+
+    driftTest();
+    catchUpTest();
+    failureTest();
+    destructionTest();
+
+    // Without a virtual clock the timer thread hands functions to the workers
+    sfex::Scheduler realTime;
+    int lvalue = 5;
+    auto lvalueResult = realTime.schedule(sf::milliseconds(10), funcToSchedule, lvalue, lvalue);
+    assert(lvalueResult.get() == 10);
+
+    bool threw = false;
+    try
+    {
+        realTime.advance(sf::seconds(1));
+    }
+    catch(const std::logic_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    stressTest();
 
     return 0;
-}
\ No newline at end of file
+}
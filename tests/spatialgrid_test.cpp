@@ -0,0 +1,94 @@
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <SFEX/General/SpatialGrid.hpp>
+
+std::vector<std::uint32_t> bruteForce(const std::vector<sfex::Vec3> &positions, const std::vector<bool> &used, const sfex::Vec3 &center, float radius)
+{
+    std::vector<std::uint32_t> ids;
+    for(std::uint32_t id = 0; id < positions.size(); ++id)
+    {
+        if(used[id] && (positions[id] - center).magnitude2() <= radius * radius) ids.push_back(id);
+    }
+    return ids;
+}
+
+std::vector<std::uint32_t> query(const sfex::SpatialGrid &grid, const sfex::Vec3 &center, float radius)
+{
+    std::vector<std::uint32_t> ids;
+    grid.query(center, radius, ids);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void basicTest()
+{
+    sfex::SpatialGrid grid(10.f);
+    assert(grid.getCellSize() == 10.f);
+    grid.insert(3, sfex::Vec3(5.f, 0.f, 0.f));
+    grid.insert(7, sfex::Vec3(-25.f, 0.f, 0.f));
+    assert(grid.getSize() == 2 && grid.contains(3) && !grid.contains(4));
+    assert(query(grid, sfex::Vec3(0.f, 0.f, 0.f), 5.f) == std::vector<std::uint32_t>{3});
+    assert(query(grid, sfex::Vec3(0.f, 0.f, 0.f), 25.f) == (std::vector<std::uint32_t>{3, 7}));
+    assert(query(grid, sfex::Vec3(100.f, 0.f, 0.f), 10.f).empty());
+
+    // Moving a point within its cell and across cells
+    grid.insert(3, sfex::Vec3(6.f, 1.f, 0.f));
+    grid.insert(7, sfex::Vec3(95.f, 0.f, 0.f));
+    assert(grid.getSize() == 2 && grid.getPosition(7) == sfex::Vec3(95.f, 0.f, 0.f));
+    assert(query(grid, sfex::Vec3(100.f, 0.f, 0.f), 10.f) == std::vector<std::uint32_t>{7});
+    assert(query(grid, sfex::Vec3(-25.f, 0.f, 0.f), 5.f).empty());
+
+    grid.remove(3);
+    grid.remove(3);
+    assert(grid.getSize() == 1 && !grid.contains(3));
+    assert(query(grid, sfex::Vec3(0.f, 0.f, 0.f), 1e30f) == std::vector<std::uint32_t>{7});
+    grid.clear();
+    assert(grid.getSize() == 0 && query(grid, sfex::Vec3(0.f, 0.f, 0.f), 1e30f).empty());
+}
+
+void randomTest()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-500.f, 500.f);
+    std::uniform_real_distribution<float> radius(0.f, 120.f);
+
+    sfex::SpatialGrid grid(32.f);
+    std::vector<sfex::Vec3> positions(2000);
+    std::vector<bool> used(positions.size(), false);
+    for(int step = 0; step < 20000; ++step)
+    {
+        std::uint32_t id = random() % positions.size();
+        if(random() % 4 == 0)
+        {
+            grid.remove(id);
+            used[id] = false;
+        }
+        else
+        {
+            positions[id] = sfex::Vec3(coordinate(random), coordinate(random), coordinate(random) * 0.1f);
+            grid.insert(id, positions[id]);
+            used[id] = true;
+        }
+
+        if(step % 100 == 0)
+        {
+            sfex::Vec3 center(coordinate(random), coordinate(random), 0.f);
+            float r = step % 1000 == 0 ? 2000.f : radius(random);
+            assert(query(grid, center, r) == bruteForce(positions, used, center, r));
+        }
+    }
+    assert(grid.getSize() == static_cast<std::size_t>(std::count(used.begin(), used.end(), true)));
+}
+
+int main()
+{
+    basicTest();
+    randomTest();
+
+    std::cout << "SpatialGrid tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <SFEX/General/Scheduler.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <cstdlib>
+#include <new>
+
+std::atomic<std::size_t> allocationCount = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if(void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char** argv)
+{
+    sfex::Scheduler scheduler(4);
+    sfex::TaskGraph graph;
+
+    // input -> gameplay -> {animation, audio}, animation -> batching
+    std::atomic<int> step = 0;
+    int inputStep = -1, gameplayStep = -1, animationStep = -1, batchingStep = -1, audioStep = -1;
+
+    auto input = graph.addNode("input", [&](){ inputStep = step++; });
+    auto gameplay = graph.addNode("gameplay", [&](){ gameplayStep = step++; });
+    auto animation = graph.addNode("animation", [&](){ sf::sleep(sf::milliseconds(50)); animationStep = step++; });
+    auto batching = graph.addNode("batching", [&](){ batchingStep = step++; });
+    auto audio = graph.addNode("audio", [&](){ audioStep = step++; });
+
+    graph.addEdge(input, gameplay);
+    graph.addEdge(gameplay, animation);
+    graph.addEdge(gameplay, audio);
+    graph.addEdge(animation, batching);
+    assert(graph.getNodeCount() == 5);
+    assert(graph.getNodeName(audio) == "audio");
+
+    for(int frame = 0; frame < 10; ++frame)
+    {
+        step = 0;
+        scheduler.dispatch(graph);
+        assert(step == 5);
+        assert(inputStep < gameplayStep);
+        assert(gameplayStep < animationStep && gameplayStep < audioStep);
+        assert(animationStep < batchingStep);
+    }
+
+    // The sleeping animation node dominates the frame
+    std::vector<sfex::TaskGraph::NodeId> path = graph.getCriticalPath();
+    assert(path.size() == 4 && path[0] == input && path[1] == gameplay && path[2] == animation && path[3] == batching);
+    assert(graph.getCriticalPathDuration() >= sf::milliseconds(50));
+    assert(graph.getLastDuration() >= graph.getCriticalPathDuration());
+    assert(graph.getNodeDuration(animation) >= sf::milliseconds(50));
+
+    bool caught = false;
+    try { graph.addEdge(input, input); }
+    catch(const std::invalid_argument&) { caught = true; }
+    assert(caught);
+
+    // Wide graph, many independent branches joining into one node
+    sfex::TaskGraph wide;
+    std::atomic<int> counter = 0;
+    auto join = wide.addNode("join", [&](){ assert(counter == 64); ++counter; });
+    for(int i = 0; i < 64; ++i)
+    {
+        auto node = wide.addNode("branch", [&](){ ++counter; });
+        wide.addEdge(node, join);
+    }
+    for(int frame = 0; frame < 100; ++frame)
+    {
+        counter = 0;
+        wide.run(scheduler.getWorkerPool());
+        assert(counter == 65);
+    }
+
+    // Once the graph and the pool have warmed up, running the graph does not allocate
+    std::size_t allocationsBefore = allocationCount;
+    for(int frame = 0; frame < 100; ++frame)
+    {
+        counter = 0;
+        wide.run(scheduler.getWorkerPool());
+    }
+    assert(allocationCount == allocationsBefore);
+
+    // Failing node
+    sfex::TaskGraph failing;
+    std::atomic<bool> afterRan = false;
+    auto thrower = failing.addNode("throws", [](){ throw std::runtime_error("node failed"); });
+    auto after = failing.addNode("after", [&](){ afterRan = true; });
+    failing.addEdge(thrower, after);
+    caught = false;
+    try { scheduler.dispatch(failing); }
+    catch(const std::runtime_error&) { caught = true; }
+    assert(caught && afterRan);
+
+    // Cycles are rejected
+    sfex::TaskGraph cyclic;
+    auto a = cyclic.addNode("a", [](){});
+    auto b = cyclic.addNode("b", [](){});
+    cyclic.addEdge(a, b);
+    cyclic.addEdge(b, a);
+    caught = false;
+    try { scheduler.dispatch(cyclic); }
+    catch(const std::runtime_error&) { caught = true; }
+    assert(caught);
+
+    std::cout << "TaskGraph tests passed" << std::endl;
+    return 0;
+}
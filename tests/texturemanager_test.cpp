@@ -0,0 +1,64 @@
+#include <iostream>
+#include <cassert>
+#include <SFEX/Managers/TextureManager.hpp>
+#include <SFML/Graphics/Image.hpp>
+
+sf::Image makeImage(unsigned int size, const sf::Color &color)
+{
+    sf::Image image;
+    image.create(size, size, color);
+    return image;
+}
+
+void deduplicationTest()
+{
+    sfex::TextureManager manager;
+    sf::Image red = makeImage(2, sf::Color(255, 0, 0));
+
+    // Keys only share textures when asked to, since at and find do not resolve aliases
+    assert(!manager.isDeduplicating());
+    assert(manager.loadFromImage("a", red));
+    assert(manager.loadFromImage("b", red));
+    assert(!manager.isAlias("b"));
+    assert(&manager.at("b") != &manager.at("a"));
+    assert(manager.getDeduplicatedMemory() == 0);
+}
+
+void reloadTest()
+{
+    sfex::TextureManager manager;
+    manager.setDeduplication(true);
+    sf::Image red = makeImage(2, sf::Color(255, 0, 0));
+    sf::Image blue = makeImage(4, sf::Color(0, 0, 255));
+
+    assert(manager.loadFromImage("a", red));
+    assert(manager.loadFromImage("b", blue));
+    const sf::Texture *texture = &manager["b"];
+
+    // Reloading a key with the content of another key keeps its texture, since sprites may point to it
+    assert(manager.loadFromImage("b", red));
+    assert(!manager.isAlias("b"));
+    assert(&manager["b"] == texture);
+    assert(texture->getSize() == sf::Vector2u(2, 2));
+
+    // New keys still share the texture with that content
+    assert(manager.loadFromImage("c", red));
+    assert(manager.isAlias("c"));
+    assert(manager.getDeduplicatedMemory() == 2 * 2 * 4);
+
+    // Once the keys that share it are gone, the key that reloaded the content in place shares it
+    manager.remove("a");
+    manager.remove("c");
+    assert(manager.loadFromImage("d", red));
+    assert(manager.isAlias("d"));
+    assert(manager.get("d") == texture);
+}
+
+int main()
+{
+    deduplicationTest();
+    reloadTest();
+
+    std::cout << "TextureManager tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <vector>
+#include <numeric>
+#include <stdexcept>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <SFEX/General/Scheduler.hpp>
+#include <SFML/System/Sleep.hpp>
+
+int add(int a, int b)
+{
+    return a + b;
+}
+
+void priorityTest()
+{
+    // Keep the only worker busy until everything is queued
+    sfex::WorkerPool pool(1);
+    std::atomic<bool> started = false;
+    std::atomic<bool> released = false;
+    auto blocker = pool.submit([&started, &released](){
+        started = true;
+        while(!released) std::this_thread::yield();
+    });
+    while(!started) std::this_thread::yield();
+
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    auto record = [&orderMutex, &order](const std::string &name){
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(name);
+    };
+
+    auto background = pool.submit(sfex::Priority::Background, record, "background");
+    pool.submit(record, "normal");
+    pool.submit(sfex::Priority::High, record, "high");
+    pool.submitWithDeadline(sfex::Priority::High, sf::milliseconds(300), record, "high 300ms");
+    pool.submitWithDeadline(sfex::Priority::High, sf::milliseconds(100), record, "high 100ms");
+    pool.submit(sfex::Priority::Realtime, record, "realtime");
+    released = true;
+
+    // get() would run queued tasks on this thread as well, so only poll
+    while(!background.isReady()) std::this_thread::yield();
+    assert((order == std::vector<std::string>{"realtime", "high 100ms", "high 300ms", "high", "normal", "background"}));
+    assert(pool.getMissedDeadlineCount(sfex::Priority::High) == 0);
+
+    // Missed deadlines are counted per class, the task still completes
+    assert(pool.submitWithDeadline(sfex::Priority::Normal, sf::milliseconds(1), [](){ sf::sleep(sf::milliseconds(20)); return 1; }).get() == 1);
+    pool.submitWithDeadline(sfex::Priority::Normal, sf::seconds(10), [](){}).get();
+    assert(pool.getMissedDeadlineCount(sfex::Priority::Normal) == 1);
+    assert(pool.getMissedDeadlineCount(sfex::Priority::Realtime) == 0);
+}
+
+void realtimeWorkerTest()
+{
+    sfex::WorkerPool pool(1, 1);
+    assert(pool.getWorkerCount() == 1 && pool.getRealtimeWorkerCount() == 1);
+
+    std::atomic<bool> started = false;
+    std::atomic<bool> released = false;
+    auto blocker = pool.submit([&started, &released](){
+        started = true;
+        while(!released) std::this_thread::yield();
+    });
+    while(!started) std::this_thread::yield();
+
+    // Realtime tasks do not wait for the busy worker
+    auto realtime = pool.submit(sfex::Priority::Realtime, add, 1, 2);
+    while(!realtime.isReady()) std::this_thread::yield();
+    assert(!blocker.isReady());
+    assert(realtime.get() == 3);
+
+    released = true;
+    blocker.get();
+}
+
+int main(int argc, char** argv)
+{
+    sfex::WorkerPool pool(4);
+    assert(pool.getWorkerCount() == 4);
+
+    // submit
+    sfex::TaskFuture<int> sum = pool.submit(add, 2, 3);
+    assert(sum.isValid());
+    assert(sum.get() == 5);
+
+    auto moveOnly = pool.submit([](std::unique_ptr<int> value){ return *value * 2; }, std::make_unique<int>(21));
+    assert(moveOnly.get() == 42);
+
+    auto throwing = pool.submit([](){ throw std::runtime_error("task failed"); });
+    bool caught = false;
+    try { throwing.get(); }
+    catch(const std::runtime_error&) { caught = true; }
+    assert(caught);
+
+    // continuations
+    auto chained = pool.submit(add, 1, 1)
+        .then([](const int &value){ return value * 10; })
+        .then([](const int &value){ return std::to_string(value); });
+    assert(chained.get() == "20");
+
+    std::atomic<bool> skipped = true;
+    auto forwarded = pool.submit([](){ throw std::runtime_error("first stage failed"); })
+        .then([&skipped](){ skipped = false; });
+    caught = false;
+    try { forwarded.get(); }
+    catch(const std::runtime_error&) { caught = true; }
+    assert(caught && skipped);
+
+    // parallel_for
+    std::vector<int> values(10000, 1);
+    pool.parallel_for(sfex::Range<std::size_t>{0, values.size()}, 64, [&values](std::size_t i){ values[i] += static_cast<int>(i); });
+    for(std::size_t i = 0; i < values.size(); ++i)
+    {
+        assert(values[i] == static_cast<int>(i) + 1);
+    }
+
+    std::atomic<int> visited = 0;
+    pool.parallel_for(sfex::Range{5, 5}, 1, [&visited](int){ ++visited; });
+    assert(visited == 0);
+
+    // Nested parallel_for from inside tasks must not deadlock
+    std::atomic<int> nested = 0;
+    pool.parallel_for(sfex::Range{0, 8}, 1, [&pool, &nested](int){
+        pool.parallel_for(sfex::Range{0, 100}, 10, [&nested](int){ ++nested; });
+    });
+    assert(nested == 800);
+
+    caught = false;
+    try
+    {
+        pool.parallel_for(sfex::Range{0, 1000}, 10, [](int i){ if(i == 500) throw std::out_of_range("500"); });
+    }
+    catch(const std::out_of_range&) { caught = true; }
+    assert(caught);
+
+    // Through the scheduler
+    sfex::Scheduler scheduler(2);
+    assert(scheduler.submit(add, 20, 22).get() == 42);
+    std::vector<long long> squares(1000);
+    scheduler.parallel_for(sfex::Range<std::size_t>{0, squares.size()}, 16, [&squares](std::size_t i){ squares[i] = static_cast<long long>(i * i); });
+    assert(std::accumulate(squares.begin(), squares.end(), 0LL) == 332833500LL);
+    assert(scheduler.getWorkerPool().getWorkerCount() == 2);
+    assert(scheduler.submit(sfex::Priority::High, add, 1, 1).get() == 2);
+    assert(scheduler.submitWithDeadline(sfex::Priority::Realtime, sf::seconds(1), add, 2, 2).get() == 4);
+
+    priorityTest();
+    realtimeWorkerTest();
+
+    std::cout << "WorkerPool tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <SFEX/General/Pack.hpp>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+void printUsage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  sfex-pack create [-c] [-a alignment] <output> <input>..." << std::endl;
+    std::cout << "      Pack files into output. Directories are added recursively and their files are named by the path relative to the directory." << std::endl;
+    std::cout << "      -c  Compress entries with LZ4 when that makes them smaller" << std::endl;
+    std::cout << "      -a  Align entries to the given power of two, 16 by default" << std::endl;
+    std::cout << "  sfex-pack list <pack>" << std::endl;
+    std::cout << "      Print the entries of a pack" << std::endl;
+}
+
+bool addInput(sfex::PackWriter &writer, const fs::path &input, bool compress)
+{
+    if(!fs::is_directory(input))
+    {
+        std::string name = input.filename().generic_string();
+        if(writer.addFromFile(name, input.string(), compress)) return true;
+
+        std::cerr << "Cannot read " << input.string() << std::endl;
+        return false;
+    }
+
+    for(const fs::directory_entry &entry : fs::recursive_directory_iterator(input))
+    {
+        if(!entry.is_regular_file()) continue;
+
+        std::string name = fs::relative(entry.path(), input).generic_string();
+        if(!writer.addFromFile(name, entry.path().string(), compress))
+        {
+            std::cerr << "Cannot read " << entry.path().string() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int create(const std::vector<std::string> &arguments)
+{
+    bool compress = false;
+    std::size_t alignment = 16;
+    std::size_t i = 0;
+    for(; i < arguments.size() && arguments[i].size() > 1 && arguments[i][0] == '-'; ++i)
+    {
+        if(arguments[i] == "-c") compress = true;
+        else if(arguments[i] == "-a" && i + 1 < arguments.size()) alignment = std::stoul(arguments[++i]);
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    if(arguments.size() - i < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    sfex::PackWriter writer(alignment);
+    for(std::size_t input = i + 1; input < arguments.size(); ++input)
+    {
+        if(!addInput(writer, arguments[input], compress)) return 1;
+    }
+
+    if(!writer.saveToFile(arguments[i]))
+    {
+        std::cerr << "Cannot write " << arguments[i] << std::endl;
+        return 1;
+    }
+    std::cout << "Packed " << writer.getEntryCount() << " entries into " << arguments[i] << std::endl;
+    return 0;
+}
+
+int list(const std::vector<std::string> &arguments)
+{
+    if(arguments.size() != 1)
+    {
+        printUsage();
+        return 1;
+    }
+
+    sfex::Pack pack;
+    if(!pack.openFromFile(arguments[0]))
+    {
+        std::cerr << arguments[0] << " is not a valid pack" << std::endl;
+        return 1;
+    }
+
+    for(const sfex::Pack::Entry &entry : pack.getEntries())
+    {
+        std::cout << entry.name << "  " << entry.originalSize << " bytes";
+        if(entry.compressed) std::cout << ", " << entry.size << " compressed";
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    std::vector<std::string> arguments(argv + 2, argv + argc);
+    try
+    {
+        if(command == "create") return create(arguments);
+        if(command == "list") return list(arguments);
+    }
+    catch(const std::exception &exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    printUsage();
+    return 1;
+}